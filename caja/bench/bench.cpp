@@ -0,0 +1,317 @@
+/**
+ * @file bench.cpp
+ * @brief Microbenchmarks y corridas de escalamiento del simulador (make bench).
+ *
+ * Mide por separado Esfera::colision, Esfera::rebotePared, Esfera::muevase,
+ * los recorridos SoA (movimiento, rebote) y el recorrido de pares sobre la
+ * rejilla; luego corre cajas completas variando N (10² a 10⁶), la fracción
+ * de empaquetamiento y el número de hilos, con semillas fijas y sin
+ * preguntas. Cada medición es una fila de un CSV que se agrega a
+ * results/bench.csv, de modo que se pueden comparar commits.
+ *
+ * Uso:
+ * @code
+ *   bin/bench [--rapido] [--nmax N] [--hilos 1,2,4] [--salida ruta] [--etiqueta texto]
+ * @endcode
+ *
+ * @authors
+ * - Santiago Suárez
+ * - Eric Arciniegas
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Esfera.hpp"
+#include "KernelsSimd.hpp"
+#include "MallaCeldas.hpp"
+#include "PasoParalelo.hpp"
+#include "Simulacion.hpp"
+#include "SistemaParticulas.hpp"
+
+namespace {
+
+const double kPi = 3.14159265358979323846;
+
+/// Evita que el compilador descarte el resultado de un cálculo.
+volatile double sumidero = 0;
+
+double ahora() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @struct Fila
+ * @brief Una medición del CSV.
+ */
+struct Fila {
+    std::string tipo;     ///< micro o escala.
+    std::string nombre;
+    int n = 0;
+    double phi = 0;       ///< Fracción de empaquetamiento N·πR²/L².
+    int hilos = 0;        ///< -1: paso serial.
+    long pasos = 0;       ///< Repeticiones (micro) o pasos (escala).
+    double segundos = 0;
+};
+
+class Salida {
+private:
+    std::FILE *f = nullptr;
+    std::string etiqueta;
+
+public:
+    bool abrir(const std::string &ruta, const std::string &etiqueta_) {
+        etiqueta = etiqueta_;
+        std::FILE *prueba = std::fopen(ruta.c_str(), "r");
+        bool nuevo = !prueba;
+        if (prueba) std::fclose(prueba);
+        f = std::fopen(ruta.c_str(), "a");
+        if (!f) return false;
+        if (nuevo) {
+            std::fprintf(f, "etiqueta,simd,tipo,nombre,n,phi,hilos,pasos,segundos,"
+                            "pasos_por_s,actualizaciones_por_s,ns_por_op\n");
+        }
+        return true;
+    }
+
+    void escribir(const Fila &r) {
+        double pps = r.segundos > 0 ? r.pasos / r.segundos : 0;
+        double ups = pps * std::max(r.n, 1);
+        double ns = r.pasos > 0 ? 1e9 * r.segundos / (static_cast<double>(r.pasos) * std::max(r.n, 1)) : 0;
+        std::fprintf(f, "%s,%s,%s,%s,%d,%.4f,%d,%ld,%.6f,%.6g,%.6g,%.4f\n", etiqueta.c_str(),
+                     simd::nombreNivel(), r.tipo.c_str(), r.nombre.c_str(), r.n, r.phi, r.hilos,
+                     r.pasos, r.segundos, pps, ups, ns);
+        std::fflush(f);
+        std::printf("%-6s %-22s n=%-8d phi=%.2f hilos=%-3d %10.4g act/s  %8.3f ns/op\n", r.tipo.c_str(),
+                    r.nombre.c_str(), r.n, r.phi, r.hilos, ups, ns);
+    }
+
+    ~Salida() {
+        if (f) std::fclose(f);
+    }
+};
+
+/**
+ * @brief Repite @p f hasta acumular al menos @p minimo segundos.
+ * @return Segundos transcurridos; @p reps queda con el número de repeticiones.
+ */
+template <typename F>
+double cronometrar(F &&f, long &reps, double minimo) {
+    reps = 0;
+    double t0 = ahora(), t = 0;
+    long lote = 1;
+    while (t < minimo) {
+        for (long k = 0; k < lote; k++) f();
+        reps += lote;
+        lote *= 2;
+        t = ahora() - t0;
+    }
+    return t;
+}
+
+/**
+ * @brief Parámetros de una caja con @p n esferas de radio @p R y fracción @p phi.
+ */
+ParametrosCaja cajaCon(int n, double phi, double R) {
+    ParametrosCaja p;
+    p.n = n;
+    p.R = R;
+    p.largo = std::sqrt(n * kPi * R * R / phi);
+    p.vmax = 1;
+    p.semilla = 12345;
+    return p;
+}
+
+// ======================= Microbenchmarks =======================
+
+void micro(Salida &out, double minimo) {
+    const int n = 10000;
+    Cajas caja;
+    caja.inicio(-50, 50, -50, 50);
+    caja.actualizarPresion();
+    std::mt19937_64 rng(1);
+    std::uniform_real_distribution<double> u(-1, 1);
+
+    // --- Esfera: n objetos AoS ---
+    std::vector<Esfera> esferas(n);
+    for (int i = 0; i < n; i++) esferas[i].inicio(1, 49 * u(rng), 49 * u(rng), u(rng), u(rng), 0.5);
+
+    long reps;
+    Fila r;
+    r.tipo = "micro";
+    r.n = n;
+    r.hilos = -1;
+
+    r.nombre = "Esfera::muevase";
+    r.segundos = cronometrar([&] { for (auto &e : esferas) e.muevase(1e-9); }, reps, minimo);
+    r.pasos = reps;
+    out.escribir(r);
+
+    r.nombre = "Esfera::rebotePared";
+    r.segundos = cronometrar([&] { for (auto &e : esferas) e.rebotePared(caja); }, reps, minimo);
+    r.pasos = reps;
+    out.escribir(r);
+
+    // Pares que se tocan: la mitad de las llamadas resuelve colisión.
+    std::vector<Esfera> pares(n);
+    for (int i = 0; i < n; i += 2) {
+        pares[i].inicio(1, 0, 0, u(rng), u(rng), 0.5);
+        pares[i + 1].inicio(1, i % 4 == 0 ? 0.9 : 1.5, 0, u(rng), u(rng), 0.5);
+    }
+    r.nombre = "Esfera::colision";
+    r.segundos = cronometrar([&] {
+        for (int i = 0; i < n; i += 2) pares[i].colision(pares[i + 1]);
+    }, reps, minimo);
+    r.pasos = reps / 2;
+    out.escribir(r);
+
+    // --- Recorridos SoA ---
+    SistemaParticulas sis;
+    sis.inicio(n, 1, 0.5);
+    for (int i = 0; i < n; i++) sis.fijar(i, 49 * u(rng), 49 * u(rng), u(rng), u(rng));
+
+    r.nombre = "SoA::muevase";
+    r.segundos = cronometrar([&] { sis.muevase(1e-9); }, reps, minimo);
+    r.pasos = reps;
+    out.escribir(r);
+
+    r.nombre = "SoA::rebotePared";
+    r.segundos = cronometrar([&] { sis.rebotePared(caja); }, reps, minimo);
+    r.pasos = reps;
+    out.escribir(r);
+
+    r.nombre = "SoA::energiaCinetica";
+    r.segundos = cronometrar([&] { sumidero = sumidero + sis.energiaCinetica(); }, reps, minimo);
+    r.pasos = reps;
+    out.escribir(r);
+
+    // --- Recorrido de pares sobre la rejilla (phi = 0.3) ---
+    ParametrosCaja p = cajaCon(n, 0.3, 0.1);
+    Cajas c2;
+    c2.inicio(-p.largo / 2, p.largo / 2, -p.largo / 2, p.largo / 2);
+    std::mt19937_64 rng2(p.semilla);
+    SistemaParticulas denso;
+    inicializarEsferas(denso, p, rng2);
+    MallaCeldas malla;
+    malla.inicio(c2, p.R);
+
+    r.nombre = "MallaCeldas::construir";
+    r.phi = 0.3;
+    r.segundos = cronometrar([&] { malla.construir(denso); }, reps, minimo);
+    r.pasos = reps;
+    out.escribir(r);
+
+    r.nombre = "pares+colision";
+    malla.construir(denso);
+    r.segundos = cronometrar([&] {
+        malla.recorrerPares([&](int i, int j) { denso.colision(i, j, nullptr); });
+    }, reps, minimo);
+    r.pasos = reps;
+    out.escribir(r);
+}
+
+// ======================= Escalamiento =======================
+
+/**
+ * @brief Corre una caja completa y devuelve una fila con su rendimiento.
+ * @param hilos -1: paso serial con rejilla; >= 1: PasoParalelo.
+ */
+Fila escala(int n, double phi, int hilos) {
+    ParametrosCaja p = cajaCon(n, phi, 0.1);
+    long pasos = std::max(5L, std::min(200L, static_cast<long>(2e6 / n)));
+    Cajas caja;
+    caja.inicio(-p.largo / 2, p.largo / 2, -p.largo / 2, p.largo / 2);
+    std::mt19937_64 rng(p.semilla);
+    SistemaParticulas sis;
+    inicializarEsferas(sis, p, rng);
+
+    MallaCeldas malla;
+    malla.inicio(caja, p.R);
+    PasoParalelo paralelo(hilos < 1 ? 1 : hilos);
+    paralelo.inicio(caja, p.R);
+
+    double t0 = ahora();
+    for (long k = 0; k < pasos; k++) {
+        caja.actualizarPresion();
+        if (hilos < 0) {
+            malla.construir(sis);
+            malla.recorrerPares([&](int i, int j) { sis.colision(i, j, nullptr); });
+            sis.rebotePared(caja);
+            sis.muevase(p.dt);
+        } else {
+            paralelo.paso(sis, caja, p.dt);
+        }
+        caja.calcularPresion();
+    }
+    Fila r;
+    r.tipo = "escala";
+    r.nombre = hilos < 0 ? "serial" : "paralelo";
+    r.n = n;
+    r.phi = phi;
+    r.hilos = hilos;
+    r.pasos = pasos;
+    r.segundos = ahora() - t0;
+    sumidero = sumidero + caja.Getp();
+    return r;
+}
+
+std::vector<int> leerEnteros(const char *texto) {
+    std::vector<int> v;
+    std::string t = texto;
+    size_t i = 0;
+    while (i < t.size()) {
+        size_t j = t.find(',', i);
+        if (j == std::string::npos) j = t.size();
+        v.push_back(std::atoi(t.substr(i, j - i).c_str()));
+        i = j + 1;
+    }
+    return v;
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+    bool rapido = false;
+    int nmax = 1000000;
+    std::string salida = "results/bench.csv";
+    std::string etiqueta = "local";
+    int nucleos = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<int> hilos = {1, 2, 4, nucleos};
+    for (int a = 1; a < argc; a++) {
+        if (std::strcmp(argv[a], "--rapido") == 0) rapido = true;
+        else if (std::strcmp(argv[a], "--nmax") == 0 && a + 1 < argc) nmax = std::atoi(argv[++a]);
+        else if (std::strcmp(argv[a], "--hilos") == 0 && a + 1 < argc) hilos = leerEnteros(argv[++a]);
+        else if (std::strcmp(argv[a], "--salida") == 0 && a + 1 < argc) salida = argv[++a];
+        else if (std::strcmp(argv[a], "--etiqueta") == 0 && a + 1 < argc) etiqueta = argv[++a];
+    }
+    std::sort(hilos.begin(), hilos.end());
+    hilos.erase(std::unique(hilos.begin(), hilos.end()), hilos.end());
+    if (rapido) nmax = std::min(nmax, 10000);
+
+    Salida out;
+    if (!out.abrir(salida, etiqueta)) {
+        std::fprintf(stderr, "No se pudo abrir %s para escritura.\n", salida.c_str());
+        return 1;
+    }
+
+    micro(out, rapido ? 0.05 : 0.3);
+
+    std::vector<double> fracciones = rapido ? std::vector<double>{0.3} : std::vector<double>{0.05, 0.3, 0.6};
+    for (int n = 100; n <= nmax; n *= 10) {
+        for (double phi : fracciones) {
+            out.escribir(escala(n, phi, -1));
+            for (int h : hilos) {
+                if (h >= 1) out.escribir(escala(n, phi, h));
+            }
+        }
+    }
+    std::printf("Resultados agregados a %s\n", salida.c_str());
+    return 0;
+}
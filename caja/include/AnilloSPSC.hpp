@@ -0,0 +1,77 @@
+/**
+ * @file AnilloSPSC.hpp
+ * @brief Búfer circular acotado sin bloqueos para un productor y un consumidor.
+ *
+ * Los elementos se reservan al crear el anillo y se reutilizan, así que pasar
+ * un frame de un hilo a otro no hace asignaciones de memoria en el bucle.
+ *
+ * @authors
+ * - Santiago Suárez
+ * - Eric Arciniegas
+ */
+
+#ifndef ANILLO_SPSC_HPP
+#define ANILLO_SPSC_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @class AnilloSPSC
+ * @brief Cola circular de capacidad fija (single-producer, single-consumer).
+ *
+ * El productor llena el elemento de reservar() y lo entrega con publicar();
+ * el consumidor lee frente() y lo devuelve con liberar(). Sólo se usan dos
+ * contadores atómicos con semántica adquirir/liberar.
+ */
+template <typename T>
+class AnilloSPSC {
+private:
+    std::vector<T> ranuras;
+    size_t capacidad;
+    alignas(64) std::atomic<size_t> cabeza{0};  ///< Próxima ranura a leer.
+    alignas(64) std::atomic<size_t> cola{0};    ///< Próxima ranura a escribir.
+
+public:
+    /**
+     * @brief Crea el anillo.
+     * @param cap Número de elementos que puede contener.
+     */
+    explicit AnilloSPSC(size_t cap) : ranuras(cap), capacidad(cap) {}
+
+    /**
+     * @brief Ranura libre para el productor, o nullptr si el anillo está lleno.
+     */
+    T *reservar() {
+        size_t c = cola.load(std::memory_order_relaxed);
+        if (c - cabeza.load(std::memory_order_acquire) >= capacidad) return nullptr;
+        return &ranuras[c % capacidad];
+    }
+
+    /**
+     * @brief Entrega al consumidor la ranura obtenida con reservar().
+     */
+    void publicar() { cola.store(cola.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    /**
+     * @brief Elemento más antiguo para el consumidor, o nullptr si está vacío.
+     */
+    T *frente() {
+        size_t h = cabeza.load(std::memory_order_relaxed);
+        if (h == cola.load(std::memory_order_acquire)) return nullptr;
+        return &ranuras[h % capacidad];
+    }
+
+    /**
+     * @brief Devuelve al productor la ranura obtenida con frente().
+     */
+    void liberar() { cabeza.store(cabeza.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    /**
+     * @brief Indica si no hay elementos pendientes.
+     */
+    bool vacio() const { return cabeza.load(std::memory_order_acquire) == cola.load(std::memory_order_acquire); }
+};
+
+#endif  // ANILLO_SPSC_HPP
@@ -0,0 +1,380 @@
+/**
+ * @file Checkpoint.hpp
+ * @brief Instantáneas binarias del estado completo para pausar y reanudar corridas.
+ *
+ * Una instantánea guarda las partículas (posición, velocidad, masa y radio
+ * si no son uniformes, identificador), la caja con sus acumuladores de
+ * presión, el estado del generador, los observables y el número de paso.
+ * También guarda hasta dónde iban los archivos de texto de la corrida
+ * (presion.dat, histograma.dat), para que al reanudar se recorten ahí y no
+ * queden filas repetidas (reabrirSalida()).
+ *
+ * Se escriben con doble búfer: se alternan dos archivos (base.0 y base.1) y
+ * cada uno se escribe primero en un temporal que luego se renombra, así que
+ * si el proceso muere a mitad de escritura la instantánea anterior sigue
+ * intacta. Al reanudar se elige la instantánea válida más reciente.
+ *
+ * Formato: una cabecera fija de 184 bytes (CabeceraCheckpoint) seguida de
+ *   x, y, vx, vy (n doubles cada uno), m y R (sólo si son propios),
+ *   los identificadores (n int32, con relleno a 8 bytes), el estado del
+ *   generador en texto y los bytes de Observables.
+ *
+ * @authors
+ * - Santiago Suárez
+ * - Eric Arciniegas
+ */
+
+#ifndef CHECKPOINT_HPP
+#define CHECKPOINT_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "Esfera.hpp"
+#include "Instrumentacion.hpp"
+#include "Observables.hpp"
+#include "SistemaParticulas.hpp"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @struct CabeceraCheckpoint
+ * @brief Cabecera de una instantánea; todos los campos ocupan 4 u 8 bytes.
+ */
+struct CabeceraCheckpoint {
+    char magia[8];        ///< "CAJACHK\0".
+    uint32_t version;     ///< Versión del formato (2).
+    uint32_t banderas;    ///< Bit 0: masas propias; bit 1: radios propios.
+    int64_t n;            ///< Número de esferas.
+    int64_t paso;         ///< Siguiente paso a simular.
+    uint64_t secuencia;   ///< Número de instantánea (la mayor es la más reciente).
+    uint64_t semilla;     ///< Semilla original de la corrida.
+    double dt;            ///< Paso temporal.
+    double m0, R0;        ///< Masa y radio comunes.
+    double xmin, xmax, ymin, ymax;
+    double p, choques, pn, impulso;  ///< Acumuladores de presión de la caja.
+    uint64_t bytesRng;    ///< Bytes del estado del generador.
+    uint64_t bytesObs;    ///< Bytes de Observables.
+    uint64_t bytesTotal;  ///< Tamaño del archivo completo.
+    uint64_t bytesPresion;     ///< Tamaño de presion.dat al tomar la instantánea.
+    uint64_t bytesHistograma;  ///< Tamaño de histograma.dat al tomar la instantánea.
+    uint64_t suma;        ///< FNV-1a de todo lo que sigue a la cabecera.
+};
+
+static_assert(sizeof(CabeceraCheckpoint) == 184, "La cabecera de checkpoint debe ocupar 184 bytes");
+static_assert(std::is_trivially_copyable<Observables>::value,
+              "Observables se guarda copiando sus bytes");
+
+/**
+ * @brief Suma de control FNV-1a de 64 bits.
+ */
+inline uint64_t sumaFNV(const char *datos, size_t tam, uint64_t h = 1469598103934665603ull) {
+    for (size_t i = 0; i < tam; i++) {
+        h ^= static_cast<unsigned char>(datos[i]);
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+/**
+ * @class EscritorCheckpoint
+ * @brief Escribe instantáneas periódicas alternando dos archivos.
+ */
+class EscritorCheckpoint {
+private:
+    std::string base;
+    int cada = 0;
+    uint64_t secuencia = 0;
+    std::vector<char> buf;
+
+    void agregar(const void *p, size_t tam) {
+        const char *c = static_cast<const char *>(p);
+        buf.insert(buf.end(), c, c + tam);
+    }
+
+public:
+    /**
+     * @brief Define la ruta base y el intervalo.
+     * @param ruta Base de los archivos (se escriben ruta.0 y ruta.1).
+     * @param cada_ Pasos entre instantáneas (0 = nunca).
+     * @param secuencia_ Número de la última instantánea (al reanudar, para no pisar la más reciente).
+     */
+    void inicio(const std::string &ruta, int cada_, uint64_t secuencia_ = 0) {
+        base = ruta;
+        cada = cada_ > 0 ? cada_ : 0;
+        secuencia = secuencia_;
+    }
+
+    /**
+     * @brief Indica si al comenzar el paso @p paso toca escribir.
+     */
+    bool toca(int paso) const { return cada > 0 && paso > 0 && paso % cada == 0; }
+
+    /**
+     * @brief Escribe una instantánea del estado al comenzar el paso @p paso.
+     * @param bytesPresion Bytes ya escritos (y vaciados a disco) de presion.dat.
+     * @param bytesHistograma Bytes ya escritos (y vaciados a disco) de histograma.dat.
+     * @return false si no se pudo escribir (la instantánea anterior se conserva).
+     */
+    bool escribir(long paso, double dt, uint64_t semilla, const Cajas &caja,
+                  const SistemaParticulas &sis, const std::mt19937_64 &rng, const Observables &obs,
+                  uint64_t bytesPresion = 0, uint64_t bytesHistograma = 0) {
+        int n = sis.size();
+        std::ostringstream estado;
+        estado << rng;
+        std::string textoRng = estado.str();
+
+        CabeceraCheckpoint cab;
+        std::memset(&cab, 0, sizeof(cab));
+        std::memcpy(cab.magia, "CAJACHK", 8);
+        cab.version = 2;
+        cab.banderas = (sis.masasPropias() ? 1u : 0u) | (sis.radiosPropios() ? 2u : 0u);
+        cab.n = n;
+        cab.paso = paso;
+        cab.secuencia = secuencia + 1;
+        cab.semilla = semilla;
+        cab.dt = dt;
+        cab.m0 = sis.GetmComun();
+        cab.R0 = sis.GetRComun();
+        cab.xmin = caja.Getxmin();
+        cab.xmax = caja.Getxmax();
+        cab.ymin = caja.Getymin();
+        cab.ymax = caja.Getymax();
+        cab.p = caja.Getp();
+        cab.choques = caja.Getchoques();
+        cab.pn = caja.Getpn();
+        cab.impulso = caja.Getimpulso();
+        cab.bytesRng = textoRng.size();
+        cab.bytesObs = sizeof(Observables);
+        cab.bytesPresion = bytesPresion;
+        cab.bytesHistograma = bytesHistograma;
+
+        buf.clear();
+        agregar(&cab, sizeof(cab));
+        agregar(sis.datosX(), sizeof(double) * n);
+        agregar(sis.datosY(), sizeof(double) * n);
+        agregar(sis.datosVX(), sizeof(double) * n);
+        agregar(sis.datosVY(), sizeof(double) * n);
+        if (cab.banderas & 1u) {
+            for (int i = 0; i < n; i++) {
+                double m = sis.Getm(i);
+                agregar(&m, sizeof(m));
+            }
+        }
+        if (cab.banderas & 2u) {
+            for (int i = 0; i < n; i++) {
+                double r = sis.GetR(i);
+                agregar(&r, sizeof(r));
+            }
+        }
+        for (int i = 0; i < n; i++) {
+            int32_t ident = sis.Getid(i);
+            agregar(&ident, sizeof(ident));
+        }
+        buf.resize((buf.size() + 7) / 8 * 8, 0);
+        agregar(textoRng.data(), textoRng.size());
+        agregar(&obs, sizeof(obs));
+
+        CabeceraCheckpoint *c = reinterpret_cast<CabeceraCheckpoint *>(buf.data());
+        c->bytesTotal = buf.size();
+        c->suma = sumaFNV(buf.data() + sizeof(cab), buf.size() - sizeof(cab));
+
+        std::string destino = base + "." + std::to_string(cab.secuencia % 2);
+        std::string temporal = destino + ".tmp";
+        std::FILE *f = std::fopen(temporal.c_str(), "wb");
+        if (!f) return false;
+        bool ok = std::fwrite(buf.data(), 1, buf.size(), f) == buf.size();
+        ok = std::fflush(f) == 0 && ok;
+#ifndef _WIN32
+        ok = ::fsync(fileno(f)) == 0 && ok;
+#endif
+        ok = std::fclose(f) == 0 && ok;
+        if (!ok || std::rename(temporal.c_str(), destino.c_str()) != 0) {
+            std::remove(temporal.c_str());
+            return false;
+        }
+        secuencia = cab.secuencia;
+        CAJA_CONTAR(instr::kBytesEscritos, buf.size());
+        return true;
+    }
+
+    uint64_t Getsecuencia() const { return secuencia; }
+};
+
+/**
+ * @class LectorCheckpoint
+ * @brief Proyecta en memoria la instantánea válida más reciente y restaura el estado.
+ */
+class LectorCheckpoint {
+private:
+    const char *datos = nullptr;
+    size_t tam = 0;
+    std::vector<char> copia;  ///< Respaldo sin mmap.
+    CabeceraCheckpoint cab;
+    std::string ruta;
+
+    /**
+     * @brief Proyecta @p archivo y comprueba cabecera, tamaño y suma de control.
+     */
+    bool proyectar(const std::string &archivo) {
+        cerrar();
+#ifndef _WIN32
+        int fd = ::open(archivo.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(cab))) {
+            ::close(fd);
+            return false;
+        }
+        tam = static_cast<size_t>(st.st_size);
+        void *p = ::mmap(nullptr, tam, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) return false;
+        datos = static_cast<const char *>(p);
+#else
+        std::FILE *f = std::fopen(archivo.c_str(), "rb");
+        if (!f) return false;
+        std::fseek(f, 0, SEEK_END);
+        tam = static_cast<size_t>(std::ftell(f));
+        std::fseek(f, 0, SEEK_SET);
+        copia.resize(tam);
+        tam = std::fread(copia.data(), 1, tam, f);
+        std::fclose(f);
+        if (tam < sizeof(cab)) return false;
+        datos = copia.data();
+#endif
+        std::memcpy(&cab, datos, sizeof(cab));
+        if (std::memcmp(cab.magia, "CAJACHK", 8) != 0 || cab.version != 2 || cab.bytesTotal != tam ||
+            cab.bytesObs != sizeof(Observables) ||
+            cab.suma != sumaFNV(datos + sizeof(cab), tam - sizeof(cab))) {
+            cerrar();
+            return false;
+        }
+        ruta = archivo;
+        return true;
+    }
+
+public:
+    ~LectorCheckpoint() { cerrar(); }
+
+    /**
+     * @brief Abre la instantánea más reciente de @p base (base.0, base.1 o la ruta exacta).
+     * @return false si ninguna es válida.
+     */
+    bool abrir(const std::string &base) {
+        std::string mejor;
+        uint64_t secMejor = 0;
+        for (const std::string &r : {base, base + ".0", base + ".1"}) {
+            if (proyectar(r) && (mejor.empty() || cab.secuencia > secMejor)) {
+                mejor = r;
+                secMejor = cab.secuencia;
+            }
+        }
+        cerrar();
+        return !mejor.empty() && proyectar(mejor);
+    }
+
+    /**
+     * @brief Libera el archivo proyectado.
+     */
+    void cerrar() {
+#ifndef _WIN32
+        if (datos) ::munmap(const_cast<char *>(datos), tam);
+#endif
+        datos = nullptr;
+        copia.clear();
+        tam = 0;
+    }
+
+    const CabeceraCheckpoint &Getcabecera() const { return cab; }
+    const std::string &Getruta() const { return ruta; }
+
+    /**
+     * @brief Restaura caja, partículas, generador y observables.
+     *
+     * Los observables quedan con sus estadísticas; al conectarlos después
+     * al sistema se vuelven a sincronizar energía y momento.
+     *
+     * @return false si el estado del generador no se pudo leer.
+     */
+    bool restaurar(Cajas &caja, SistemaParticulas &sis, std::mt19937_64 &rng, Observables &obs) const {
+        int n = static_cast<int>(cab.n);
+        caja.inicio(cab.xmin, cab.xmax, cab.ymin, cab.ymax);
+        caja.restaurarPresion(cab.p, cab.choques, cab.pn, cab.impulso);
+
+        const char *c = datos + sizeof(cab);
+        auto leer = [&](int campo) {
+            const char *p = c + sizeof(double) * n * campo;
+            return [p](int i) {
+                double v;
+                std::memcpy(&v, p + sizeof(double) * i, sizeof(v));
+                return v;
+            };
+        };
+        auto x = leer(0), y = leer(1), vx = leer(2), vy = leer(3);
+        sis.inicio(n, cab.m0, cab.R0);
+        for (int i = 0; i < n; i++) sis.fijar(i, x(i), y(i), vx(i), vy(i));
+        int campo = 4;
+        if (cab.banderas & 1u) {
+            auto m = leer(campo++);
+            for (int i = 0; i < n; i++) sis.fijarMasa(i, m(i));
+        }
+        if (cab.banderas & 2u) {
+            auto r = leer(campo++);
+            for (int i = 0; i < n; i++) sis.fijarRadio(i, r(i));
+        }
+        c += sizeof(double) * n * campo;
+        for (int i = 0; i < n; i++) {
+            int32_t ident;
+            std::memcpy(&ident, c + sizeof(ident) * i, sizeof(ident));
+            sis.fijarId(i, ident);
+        }
+        c += (sizeof(int32_t) * n + 7) / 8 * 8;
+
+        std::istringstream estado(std::string(c, cab.bytesRng));
+        estado >> rng;
+        c += cab.bytesRng;
+        std::memcpy(&obs, c, sizeof(obs));
+        return !estado.fail();
+    }
+};
+
+/**
+ * @brief Reabre un archivo de texto de la corrida para seguir escribiendo al reanudar.
+ *
+ * Si el archivo mide más que @p bytes (filas escritas después de la
+ * instantánea), se recorta a @p bytes; luego se abre sin truncar y con la
+ * posición al final. Si no existe (una bifurcación en otro directorio) se
+ * crea vacío.
+ *
+ * @return true si el archivo quedó vacío (hay que escribir su cabecera).
+ */
+inline bool reabrirSalida(std::ofstream &archivo, const std::string &ruta, uint64_t bytes) {
+    std::error_code ec;
+    uintmax_t tam = std::filesystem::file_size(ruta, ec);
+    if (ec) {
+        archivo.open(ruta);
+        return true;
+    }
+    if (tam > bytes) {
+        std::filesystem::resize_file(ruta, bytes, ec);
+        if (!ec) tam = bytes;
+    }
+    archivo.open(ruta, std::ios::in | std::ios::out);
+    archivo.seekp(0, std::ios::end);
+    return tam == 0;
+}
+
+#endif  // CHECKPOINT_HPP
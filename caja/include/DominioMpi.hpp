@@ -0,0 +1,287 @@
+/**
+ * @file DominioMpi.hpp
+ * @brief Descomposición de la caja en franjas verticales repartidas entre procesos MPI.
+ *
+ * Cada proceso guarda en un SistemaParticulas sólo las esferas de su franja
+ * [x0, x1) y corre sobre ella el mismo paso fijo que el programa serial
+ * (rejilla de celdas, rebotes, movimiento). Por paso:
+ *  -# choques internos de la franja con su MallaCeldas;
+ *  -# las esferas a menos de 2R del borde izquierdo se copian como
+ *     fantasmas al vecino de la izquierda, que resuelve los pares que
+ *     cruzan la frontera y devuelve las velocidades nuevas;
+ *  -# rebotes y movimiento, con la presión y los cambios de energía y
+ *     momento sumados entre todos los procesos (MPI_Allreduce);
+ *  -# las esferas que salieron de la franja migran al vecino.
+ *
+ * Cada par se resuelve en un solo proceso, así que la energía se conserva
+ * igual que en la versión serial. Con un proceso el resultado es idéntico al
+ * del paso serial con rejilla. Se supone que ninguna esfera recorre más de
+ * una franja por paso y que masas y radios son comunes.
+ *
+ * Sólo lo incluye el programa MPI (mpi/simulacion_mpi.cpp, make mpi).
+ *
+ * @authors
+ * - Santiago Suárez
+ * - Eric Arciniegas
+ */
+
+#ifndef DOMINIO_MPI_HPP
+#define DOMINIO_MPI_HPP
+
+#include <mpi.h>
+#include <random>
+#include <vector>
+#include "Esfera.hpp"
+#include "MallaCeldas.hpp"
+#include "Observables.hpp"
+#include "Simulacion.hpp"
+#include "SistemaParticulas.hpp"
+
+/**
+ * @class DominioMpi
+ * @brief Franja de la caja que le toca a este proceso y sus intercambios con los vecinos.
+ */
+class DominioMpi {
+private:
+    static const int kCampos = 5;  ///< Valores por esfera en los mensajes: x, y, vx, vy, id.
+
+    MPI_Comm com;
+    int rango = 0, procesos = 1;
+    int izquierda = MPI_PROC_NULL, derecha = MPI_PROC_NULL;
+    double x0 = 0, x1 = 0;  ///< Límites de la franja propia.
+    double ancho = 0;       ///< Ancho de la zona de fantasmas (2·R).
+    long nGlobal = 0;
+
+    Cajas caja;  ///< Caja completa; todos los procesos guardan la misma presión.
+    SistemaParticulas sis;
+    MallaCeldas malla;
+    Observables obs;
+
+    // --- Frontera derecha: esferas propias cercanas más fantasmas del vecino ---
+    SistemaParticulas borde;
+    MallaCeldas mallaBorde;
+    std::vector<int> propiasBorde;  ///< Índice en sis de las primeras ranuras de borde.
+    std::vector<int> enviadas;      ///< Índices en sis enviados como fantasmas a la izquierda.
+    std::vector<double> salida, entrada;
+
+    /**
+     * @brief Empaqueta las esferas @p indices de @p s en @c salida.
+     */
+    void empaquetar(const SistemaParticulas &s, const std::vector<int> &indices) {
+        salida.resize(kCampos * indices.size());
+        for (size_t k = 0; k < indices.size(); k++) {
+            int i = indices[k];
+            double *d = salida.data() + kCampos * k;
+            d[0] = s.Getx(i);
+            d[1] = s.Gety(i);
+            d[2] = s.Getvx(i);
+            d[3] = s.Getvy(i);
+            d[4] = s.Getid(i);
+        }
+    }
+
+    /**
+     * @brief Envía @c salida a @p destino y recibe en @c entrada lo que manda @p origen.
+     * @return Número de esferas recibidas.
+     */
+    int intercambiar(int destino, int origen, int etiqueta) {
+        int nEnvio = static_cast<int>(salida.size()), nRecibo = 0;
+        MPI_Sendrecv(&nEnvio, 1, MPI_INT, destino, etiqueta, &nRecibo, 1, MPI_INT, origen, etiqueta, com,
+                     MPI_STATUS_IGNORE);
+        entrada.resize(nRecibo);
+        MPI_Sendrecv(salida.data(), nEnvio, MPI_DOUBLE, destino, etiqueta + 1, entrada.data(), nRecibo,
+                     MPI_DOUBLE, origen, etiqueta + 1, com, MPI_STATUS_IGNORE);
+        return nRecibo / kCampos;
+    }
+
+    /**
+     * @brief Resuelve los pares que cruzan la frontera derecha.
+     * @param d Acumula los cambios de energía y momento.
+     */
+    void choquesFrontera(DeltaObservables &d) {
+        // Fantasmas: la franja izquierda del vecino de la derecha.
+        enviadas.clear();
+        for (int i = 0; i < sis.size(); i++) {
+            if (sis.Getx(i) < x0 + ancho) enviadas.push_back(i);
+        }
+        if (izquierda == MPI_PROC_NULL) enviadas.clear();
+        empaquetar(sis, enviadas);
+        int nf = intercambiar(izquierda, derecha, 10);
+
+        propiasBorde.clear();
+        if (derecha != MPI_PROC_NULL) {
+            for (int i = 0; i < sis.size(); i++) {
+                if (sis.Getx(i) >= x1 - ancho) propiasBorde.push_back(i);
+            }
+        }
+        int np = static_cast<int>(propiasBorde.size());
+        borde.inicio(np + nf, sis.GetmComun(), sis.GetRComun());
+        for (int k = 0; k < np; k++) {
+            int i = propiasBorde[k];
+            borde.fijar(k, sis.Getx(i), sis.Gety(i), sis.Getvx(i), sis.Getvy(i));
+        }
+        for (int k = 0; k < nf; k++) {
+            const double *e = entrada.data() + kCampos * k;
+            borde.fijar(np + k, e[0], e[1], e[2], e[3]);
+        }
+
+        // Sólo los pares propia-fantasma: los demás ya los resolvió su dueño.
+        if (np > 0 && nf > 0) {
+            mallaBorde.construir(borde);
+            mallaBorde.recorrerPares([&](int i, int j) {
+                if ((i < np) != (j < np)) borde.colision(i, j, &d);
+            });
+        }
+        for (int k = 0; k < np; k++) {
+            int i = propiasBorde[k];
+            sis.fijar(i, sis.Getx(i), sis.Gety(i), borde.Getvx(k), borde.Getvy(k));
+        }
+
+        // Devolver las velocidades de los fantasmas a su dueño.
+        salida.resize(2 * nf);
+        for (int k = 0; k < nf; k++) {
+            salida[2 * k] = borde.Getvx(np + k);
+            salida[2 * k + 1] = borde.Getvy(np + k);
+        }
+        int nEnvio = static_cast<int>(salida.size());
+        entrada.resize(2 * enviadas.size());
+        MPI_Sendrecv(salida.data(), nEnvio, MPI_DOUBLE, derecha, 20, entrada.data(),
+                     static_cast<int>(entrada.size()), MPI_DOUBLE, izquierda, 20, com, MPI_STATUS_IGNORE);
+        for (size_t k = 0; k < enviadas.size(); k++) {
+            int i = enviadas[k];
+            sis.fijar(i, sis.Getx(i), sis.Gety(i), entrada[2 * k], entrada[2 * k + 1]);
+        }
+    }
+
+    /**
+     * @brief Pasa al vecino las esferas que salieron de la franja.
+     */
+    void migrar() {
+        std::vector<int> quedan, aIzq, aDer;
+        for (int i = 0; i < sis.size(); i++) {
+            double x = sis.Getx(i);
+            if (x < x0 && izquierda != MPI_PROC_NULL) aIzq.push_back(i);
+            else if (x >= x1 && derecha != MPI_PROC_NULL) aDer.push_back(i);
+            else quedan.push_back(i);
+        }
+        std::vector<double> deIzq, deDer;
+        empaquetar(sis, aIzq);
+        intercambiar(izquierda, derecha, 30);
+        deDer.swap(entrada);
+        empaquetar(sis, aDer);
+        intercambiar(derecha, izquierda, 40);
+        deIzq.swap(entrada);
+
+        sis.seleccionar(quedan);
+        for (const std::vector<double> *v : {&deIzq, &deDer}) {
+            for (size_t k = 0; k + kCampos <= v->size(); k += kCampos) {
+                const double *e = v->data() + k;
+                sis.agregar(e[0], e[1], e[2], e[3], static_cast<int>(e[4]));
+            }
+        }
+    }
+
+public:
+    explicit DominioMpi(MPI_Comm c = MPI_COMM_WORLD) : com(c) {
+        MPI_Comm_rank(com, &rango);
+        MPI_Comm_size(com, &procesos);
+        if (rango > 0) izquierda = rango - 1;
+        if (rango + 1 < procesos) derecha = rango + 1;
+    }
+
+    /**
+     * @brief Crea la caja completa y guarda sólo las esferas de la franja propia.
+     *
+     * Todos los procesos recorren la misma malla inicial con la misma
+     * semilla, así que la configuración es la de la corrida serial.
+     *
+     * @param p Parámetros de la corrida.
+     */
+    void inicio(const ParametrosCaja &p) {
+        double half = p.largo / 2.0;
+        caja.inicio(-half, half, -half, half);
+        caja.actualizarPresion();
+        nGlobal = p.n;
+        ancho = 2 * p.R;
+        x0 = -half + p.largo * rango / procesos;
+        x1 = rango + 1 == procesos ? half : -half + p.largo * (rango + 1) / procesos;
+
+        std::mt19937_64 rng(p.semilla);
+        sis.inicio(0, p.m, p.R);
+        recorrerMallaInicial(p, rng, [&](int idx, double x, double y, double vx, double vy) {
+            bool mia = (x >= x0 || izquierda == MPI_PROC_NULL) && (x < x1 || derecha == MPI_PROC_NULL);
+            if (mia) sis.agregar(x, y, vx, vy, idx);
+        });
+
+        Cajas franja;
+        franja.inicio(x0, x1, -half, half);
+        malla.inicio(franja, p.R);
+        Cajas zonaBorde;
+        zonaBorde.inicio(x1 - ancho, x1 + ancho, -half, half);
+        mallaBorde.inicio(zonaBorde, p.R);
+
+        double local[3] = {sis.energiaCinetica(), 0, 0}, total[3];
+        for (int i = 0; i < sis.size(); i++) {
+            local[1] += sis.Getm(i) * sis.Getvx(i);
+            local[2] += sis.Getm(i) * sis.Getvy(i);
+        }
+        MPI_Allreduce(local, total, 3, MPI_DOUBLE, MPI_SUM, com);
+        obs.fijar(total[0], total[1], total[2]);
+    }
+
+    /**
+     * @brief Avanza un paso: choques internos, frontera, paredes, movimiento y migración.
+     */
+    void paso(double dt) {
+        DeltaObservables d;
+        malla.construir(sis);
+        malla.recorrerPares([&](int i, int j) { sis.colision(i, j, &d); });
+        choquesFrontera(d);
+
+        simd::ResultadoParedes r;
+        sis.reboteParedRango(0, sis.size(), caja, r);
+        sis.muevase(dt);
+
+        double local[9] = {r.sumaMv2, r.choques, r.impulso, r.dPx, r.dPy,
+                           d.dK, d.dPx, d.dPy, static_cast<double>(d.eventos)};
+        double total[9];
+        MPI_Allreduce(local, total, 9, MPI_DOUBLE, MPI_SUM, com);
+        caja.acumularPresion(total[0], total[1], total[2]);
+        obs.paredes(total[3], total[4], total[1]);
+        DeltaObservables g;
+        g.dK = total[5];
+        g.dPx = total[6];
+        g.dPy = total[7];
+        g.eventos = static_cast<long>(total[8]);
+        obs.colision(g);
+
+        migrar();
+    }
+
+    /**
+     * @brief Energía cinética total recalculada (una reducción; para verificar).
+     */
+    double energiaGlobal() const {
+        double local = sis.energiaCinetica(), total = 0;
+        MPI_Allreduce(&local, &total, 1, MPI_DOUBLE, MPI_SUM, com);
+        return total;
+    }
+
+    /**
+     * @brief Número total de esferas en todos los procesos.
+     */
+    long contarGlobal() const {
+        long local = sis.size(), total = 0;
+        MPI_Allreduce(&local, &total, 1, MPI_LONG, MPI_SUM, com);
+        return total;
+    }
+
+    int Getrango() const { return rango; }
+    int Getprocesos() const { return procesos; }
+    long GetnGlobal() const { return nGlobal; }
+    Cajas &Getcaja() { return caja; }
+    Observables &Getobservables() { return obs; }
+    const SistemaParticulas &Getsistema() const { return sis; }
+};
+
+#endif  // DOMINIO_MPI_HPP
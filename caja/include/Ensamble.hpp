@@ -0,0 +1,260 @@
+/**
+ * @file Ensamble.hpp
+ * @brief Corridas por lotes: muchas cajas independientes en un pool de hilos.
+ *
+ * Se define una rejilla de parámetros (largo, n, vmax, R) y un número de
+ * semillas por punto, ya sea desde un archivo de configuración o desde la
+ * línea de comandos. Cada corrida usa su propio std::mt19937_64 y los
+ * resultados se agregan (media y error estándar sobre semillas) en una sola
+ * tabla.
+ *
+ * Formato del archivo (una clave por línea, '#' inicia un comentario):
+ * @code
+ *   largo    = 10
+ *   n        = 400 900 1600
+ *   vmax     = 5
+ *   R        = 0.05 0.1
+ *   semillas = 16
+ *   pasos    = 300
+ *   dt       = 0.01
+ *   semilla  = 1
+ *   hilos    = 0
+ *   dim      = 2
+ *   tipo     = double
+ *   salida   = results/ensamble.dat
+ * @endcode
+ *
+ * @c dim = 3 corre cajas cúbicas con esferas en 3D y @c tipo = float guarda
+ * posiciones y velocidades en float (ver simularCaja()).
+ *
+ * @authors
+ * - Santiago Suárez
+ * - Eric Arciniegas
+ */
+
+#ifndef ENSAMBLE_HPP
+#define ENSAMBLE_HPP
+
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "PoolHilos.hpp"
+#include "Simulacion.hpp"
+
+/**
+ * @class Ensamble
+ * @brief Rejilla de parámetros, ejecución en paralelo y agregación.
+ */
+class Ensamble {
+private:
+    std::vector<double> largos{10}, vmaxs{1}, radios{0.1};
+    std::vector<int> ns{100};
+    int semillas = 1;
+    int pasos = 300;
+    double dt = 0.01;
+    uint64_t semillaBase = 1;
+    int hilos = 0;
+    int dim = 2;
+    bool simple = false;  ///< tipo = float
+    std::string salida = "results/ensamble.dat";
+
+    /// Punto de la rejilla de parámetros.
+    struct Punto {
+        ParametrosCaja p;
+        std::vector<ResultadoCaja> corridas;
+    };
+    std::vector<Punto> puntos;
+
+    static std::vector<double> leerLista(const std::string &valores) {
+        std::vector<double> v;
+        std::string t = valores;
+        for (char &c : t) {
+            if (c == ',') c = ' ';
+        }
+        std::istringstream in(t);
+        double x;
+        while (in >> x) v.push_back(x);
+        return v;
+    }
+
+    static double media(const std::vector<double> &v) {
+        double s = 0;
+        for (double x : v) s += x;
+        return v.empty() ? 0 : s / v.size();
+    }
+
+    static double errorEstandar(const std::vector<double> &v) {
+        if (v.size() < 2) return 0;
+        double m = media(v), s = 0;
+        for (double x : v) s += (x - m) * (x - m);
+        return std::sqrt(s / (v.size() - 1) / v.size());
+    }
+
+public:
+    /**
+     * @brief Asigna un parámetro a partir de texto.
+     * @param clave Nombre (largo, n, vmax, R, semillas, pasos, dt, semilla, hilos, dim, tipo, salida).
+     * @param valores Uno o varios valores separados por espacios o comas.
+     * @return false si la clave no existe o el valor no es válido.
+     */
+    bool fijar(const std::string &clave, const std::string &valores) {
+        if (clave == "salida") {
+            std::istringstream in(valores);
+            in >> salida;
+            return !salida.empty();
+        }
+        if (clave == "tipo") {
+            std::istringstream in(valores);
+            std::string tipo;
+            in >> tipo;
+            if (tipo != "double" && tipo != "float") return false;
+            simple = tipo == "float";
+            return true;
+        }
+        std::vector<double> v = leerLista(valores);
+        if (v.empty()) return false;
+        if (clave == "largo") largos = v;
+        else if (clave == "vmax") vmaxs = v;
+        else if (clave == "R") radios = v;
+        else if (clave == "n") {
+            ns.clear();
+            for (double x : v) ns.push_back(static_cast<int>(x));
+        }
+        else if (clave == "semillas") {
+            if (v[0] < 1) return false;  // al menos una corrida por punto
+            semillas = static_cast<int>(v[0]);
+        }
+        else if (clave == "pasos") {
+            if (v[0] < 1) return false;  // sin pasos no hay presión que promediar
+            pasos = static_cast<int>(v[0]);
+        }
+        else if (clave == "dt") {
+            if (!(v[0] > 0)) return false;  // también descarta NaN
+            dt = v[0];
+        }
+        else if (clave == "semilla") semillaBase = static_cast<uint64_t>(v[0]);
+        else if (clave == "hilos") hilos = static_cast<int>(v[0]);
+        else if (clave == "dim") {
+            if (v[0] != 2 && v[0] != 3) return false;
+            dim = static_cast<int>(v[0]);
+        }
+        else return false;
+        return true;
+    }
+
+    /**
+     * @brief Asigna un parámetro escrito como "clave=valores".
+     */
+    bool fijar(const std::string &asignacion) {
+        size_t igual = asignacion.find('=');
+        if (igual == std::string::npos) return false;
+        std::string clave = asignacion.substr(0, igual);
+        while (!clave.empty() && clave.back() == ' ') clave.pop_back();
+        while (!clave.empty() && clave.front() == ' ') clave.erase(0, 1);
+        return fijar(clave, asignacion.substr(igual + 1));
+    }
+
+    /**
+     * @brief Lee la configuración desde un archivo.
+     * @return false si no se pudo abrir o alguna línea no es válida.
+     */
+    bool leer(const std::string &ruta) {
+        std::ifstream in(ruta);
+        if (!in.is_open()) {
+            std::cerr << "No se pudo abrir " << ruta << ".\n";
+            return false;
+        }
+        std::string linea;
+        int num = 0;
+        bool ok = true;
+        while (std::getline(in, linea)) {
+            num++;
+            size_t com = linea.find('#');
+            if (com != std::string::npos) linea.erase(com);
+            if (linea.find_first_not_of(" \t\r") == std::string::npos) continue;
+            if (!fijar(linea)) {
+                std::cerr << ruta << ":" << num << ": parametro no valido: " << linea << "\n";
+                ok = false;
+            }
+        }
+        return ok;
+    }
+
+    /**
+     * @brief Corre todas las combinaciones de parámetros y semillas.
+     * @return Número de corridas realizadas.
+     */
+    int correr() {
+        puntos.clear();
+        for (double largo : largos) {
+            for (int n : ns) {
+                for (double vmax : vmaxs) {
+                    for (double R : radios) {
+                        if (R <= 0 || R >= radioMaximo(largo, n, dim)) {
+                            std::cerr << "Se omite largo=" << largo << " n=" << n << " R=" << R
+                                      << ": el radio debe estar en (0, " << radioMaximo(largo, n, dim) << ").\n";
+                            continue;
+                        }
+                        Punto pt;
+                        pt.p.largo = largo;
+                        pt.p.n = n;
+                        pt.p.vmax = vmax;
+                        pt.p.R = R;
+                        pt.p.dt = dt;
+                        pt.p.pasos = pasos;
+                        pt.p.dim = dim;
+                        pt.p.simple = simple;
+                        pt.corridas.resize(semillas);
+                        puntos.push_back(pt);
+                    }
+                }
+            }
+        }
+
+        int total = static_cast<int>(puntos.size()) * semillas;
+        PoolHilos pool(hilos);
+        pool.paraCada(total, [&](int k) {
+            Punto &pt = puntos[k / semillas];
+            ParametrosCaja p = pt.p;
+            p.semilla = semillaCorrida(semillaBase, k);
+            pt.corridas[k % semillas] = simularCaja(p);
+        });
+        return total;
+    }
+
+    /**
+     * @brief Escribe la tabla agregada (una fila por punto de la rejilla).
+     * @return false si no se pudo abrir el archivo de salida.
+     */
+    bool escribir() const {
+        std::ofstream out(salida);
+        if (!out.is_open()) {
+            std::cerr << "No se pudo abrir " << salida << " para escritura.\n";
+            return false;
+        }
+        if (dim != 2 || simple) out << "# dim=" << dim << " tipo=" << (simple ? "float" : "double") << "\n";
+        out << "# largo\tn\tvmax\tR\tsemillas\tP\terr_P\tP_mec\terr_P_mec\tkT\terr_kT\n";
+        for (const Punto &pt : puntos) {
+            std::vector<double> P, Pm, kT;
+            for (const ResultadoCaja &r : pt.corridas) {
+                P.push_back(r.presion);
+                Pm.push_back(r.presionMecanica);
+                kT.push_back(r.kT);
+            }
+            out << pt.p.largo << "\t" << pt.p.n << "\t" << pt.p.vmax << "\t" << pt.p.R << "\t"
+                << pt.corridas.size() << "\t"
+                << media(P) << "\t" << errorEstandar(P) << "\t"
+                << media(Pm) << "\t" << errorEstandar(Pm) << "\t"
+                << media(kT) << "\t" << errorEstandar(kT) << "\n";
+        }
+        return true;
+    }
+
+    const std::string &Getsalida() const { return salida; }
+};
+
+#endif  // ENSAMBLE_HPP
@@ -5,47 +5,112 @@
  * Este archivo contiene las clases responsables de representar las partículas (esferas)
  * y los límites del contenedor (caja) donde ocurre la simulación.
  *
+ * Ambas son plantillas sobre el tipo escalar @c T (double o float) y la
+ * dimensión @c Dim (2 o 3). Los recorridos sobre las dimensiones se
+ * desenrollan en compilación con paraCadaDim(), así que una caja 3D o en
+ * float no paga nada en tiempo de ejecución. Los alias Cajas y Esfera son
+ * la versión original en double y 2D. SistemaParticulasT y MallaCeldasT
+ * siguen la misma plantilla; el modo por lotes (simularCaja) corre con ellas
+ * cajas 3D y en float. Los métodos propios de un eje (Getz, Gettheta, ...)
+ * sólo existen en la dimensión que les corresponde.
+ *
  * @authors
  * - Santiago Suárez
  * - Eric Arciniegas
  */
 
+#ifndef ESFERA_HPP
+#define ESFERA_HPP
+
+#include <array>
 #include <iostream>
 #include <cmath>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief Llama @p f(std::integral_constant<int, d>) para d = 0..Dim-1, desenrollado.
+ */
+template <int Dim, typename F, int... D>
+inline void paraCadaDim(F &&f, std::integer_sequence<int, D...>) {
+    (f(std::integral_constant<int, D>{}), ...);
+}
+
+template <int Dim, typename F>
+inline void paraCadaDim(F &&f) {
+    paraCadaDim<Dim>(f, std::make_integer_sequence<int, Dim>{});
+}
 
 /**
- * @class Cajas
+ * @class CajasT
  * @brief Representa los límites del contenedor en la simulación.
  *
- * La clase almacena los bordes de la caja (xmin, xmax, ymin, ymax)
+ * La clase almacena los bordes de la caja (mínimo y máximo en cada eje)
  * y las variables necesarias para el cálculo de la presión promedio
- * durante la simulación de partículas.
+ * durante la simulación de partículas. Los acumuladores de presión se
+ * llevan siempre en double, aunque @c T sea float.
+ *
+ * @tparam T Tipo escalar de las coordenadas.
+ * @tparam Dim Número de dimensiones (2 o 3).
  */
-class Cajas {
+template <typename T, int Dim>
+class CajasT {
+    static_assert(Dim == 2 || Dim == 3, "La caja debe ser 2D o 3D");
+
 private:
-    double xmin, xmax, ymin, ymax;  ///< Límites del contenedor.
+    std::array<T, Dim> min, max;    ///< Límites del contenedor.
     double p, n, pn;                ///< Variables de presión acumulada y promedio.
+    double impulso;                 ///< Impulso total transferido a las paredes.
 
 public:
+    static constexpr int kDim = Dim;
+    using Escalar = T;
+
+    /**
+     * @brief Devuelve el límite mínimo en el eje @p d.
+     */
+    T Getmin(int d) const { return min[d]; }
+
+    /**
+     * @brief Devuelve el límite máximo en el eje @p d.
+     */
+    T Getmax(int d) const { return max[d]; }
+
     /**
      * @brief Devuelve el límite mínimo en X.
      */
-    double Getxmin() const { return xmin; }
+    T Getxmin() const { return min[0]; }
 
     /**
      * @brief Devuelve el límite máximo en X.
      */
-    double Getxmax() const { return xmax; }
+    T Getxmax() const { return max[0]; }
 
     /**
      * @brief Devuelve el límite mínimo en Y.
      */
-    double Getymin() const { return xmin; }
+    T Getymin() const { return min[1]; }
 
     /**
      * @brief Devuelve el límite máximo en Y.
      */
-    double Getymax() const { return xmax; }
+    T Getymax() const { return max[1]; }
+
+    /**
+     * @brief Devuelve el límite mínimo en Z (sólo 3D).
+     */
+    template <int D = Dim, std::enable_if_t<(D >= 3), int> = 0>
+    T Getzmin() const {
+        return min[2];
+    }
+
+    /**
+     * @brief Devuelve el límite máximo en Z (sólo 3D).
+     */
+    template <int D = Dim, std::enable_if_t<(D >= 3), int> = 0>
+    T Getzmax() const {
+        return max[2];
+    }
 
     /**
      * @brief Devuelve la presión promedio actual.
@@ -53,17 +118,73 @@ public:
     double Getp() const { return p; }
 
     /**
-     * @brief Inicializa los límites de la caja.
+     * @brief Devuelve el número de choques con las paredes acumulados.
+     */
+    double Getchoques() const { return n; }
+
+    /**
+     * @brief Devuelve la suma acumulada de m·v²/3.
+     */
+    double Getpn() const { return pn; }
+
+    /**
+     * @brief Devuelve el impulso acumulado sobre las paredes.
+     */
+    double Getimpulso() const { return impulso; }
+
+    /**
+     * @brief Medida del borde: perímetro en 2D, área de las caras en 3D.
+     */
+    double borde() const {
+        double total = 0;
+        paraCadaDim<Dim>([&](auto d) {
+            double cara = 1;
+            paraCadaDim<Dim>([&](auto k) {
+                if (k != d) cara *= static_cast<double>(max[k] - min[k]);
+            });
+            total += 2 * cara;
+        });
+        return total;
+    }
+
+    /**
+     * @brief Devuelve la presión mecánica (impulso / (borde × tiempo)).
+     * @param intervalo Tiempo durante el cual se acumuló el impulso.
+     */
+    double GetpMecanica(double intervalo) const {
+        return impulso / (borde() * intervalo);
+    }
+
+    /**
+     * @brief Inicializa los límites de la caja en cualquier dimensión.
+     * @param a Límites mínimos.
+     * @param b Límites máximos.
+     */
+    void inicio(const std::array<T, Dim> &a, const std::array<T, Dim> &b) {
+        min = a;
+        max = b;
+    }
+
+    /**
+     * @brief Inicializa los límites de la caja (2D).
      * @param x1 Límite mínimo en X.
      * @param x2 Límite máximo en X.
      * @param y1 Límite mínimo en Y.
      * @param y2 Límite máximo en Y.
      */
-    void inicio(double x1, double x2, double y1, double y2) {
-        xmin = x1;
-        xmax = x2;
-        ymin = y1;
-        ymax = y2;
+    template <int D = Dim, std::enable_if_t<(D == 2), int> = 0>
+    void inicio(T x1, T x2, T y1, T y2) {
+        min = {x1, y1};
+        max = {x2, y2};
+    }
+
+    /**
+     * @brief Inicializa los límites de la caja (3D).
+     */
+    template <int D = Dim, std::enable_if_t<(D == 3), int> = 0>
+    void inicio(T x1, T x2, T y1, T y2, T z1, T z2) {
+        min = {x1, y1, z1};
+        max = {x2, y2, z2};
     }
 
     /**
@@ -73,6 +194,17 @@ public:
         p = 0;
         pn = 0;
         n = 0;
+        impulso = 0;
+    }
+
+    /**
+     * @brief Restablece los acumuladores de presión (al reanudar una corrida).
+     */
+    void restaurarPresion(double p_, double n_, double pn_, double impulso_) {
+        p = p_;
+        n = n_;
+        pn = pn_;
+        impulso = impulso_;
     }
 
     /**
@@ -84,45 +216,147 @@ public:
         n += 1;
     }
 
+    /**
+     * @brief Acumula el impulso de un choque contra una pared.
+     * @param dp Cambio de momento de la esfera (2·m·|v_normal|).
+     */
+    void registrarImpulso(double dp) { impulso += dp; }
+
+    /**
+     * @brief Acumula de una vez las contribuciones de varios choques.
+     * @param sumaMv2 Suma de m·v² de los choques.
+     * @param choques Número de choques.
+     * @param dp Impulso total transferido.
+     */
+    void acumularPresion(double sumaMv2, double choques, double dp) {
+        pn += sumaMv2 / 3;
+        n += choques;
+        impulso += dp;
+    }
+
     /**
      * @brief Calcula la presión promedio actual.
      */
-    void calcularPresion() { p = pn / n; }
+    void calcularPresion() { p = n > 0 ? pn / n : 0; }
 };
 
 /**
- * @class Esfera
+ * @class EsferaT
  * @brief Representa una partícula (esfera) dentro de la simulación.
  *
  * La clase gestiona la posición, velocidad, radio y dinámica de cada
  * esfera, incluyendo colisiones entre partículas y rebotes con las paredes.
+ *
+ * @tparam T Tipo escalar (double o float).
+ * @tparam Dim Número de dimensiones (2 o 3).
  */
-class Esfera {
+template <typename T, int Dim>
+class EsferaT {
+    static_assert(Dim == 2 || Dim == 3, "La esfera debe ser 2D o 3D");
+
 private:
-    double m;      ///< Masa de la esfera.
-    double x, y;   ///< Posición de la esfera.
-    double vx, vy; ///< Componentes de la velocidad.
-    double theta;  ///< Ángulo de la velocidad respecto al eje X.
-    double R;      ///< Radio de la esfera.
+    T m;                     ///< Masa de la esfera.
+    std::array<T, Dim> pos;  ///< Posición de la esfera.
+    std::array<T, Dim> vel;  ///< Componentes de la velocidad.
+    T R;                     ///< Radio de la esfera.
+
+    T v2() const {
+        T s = 0;
+        paraCadaDim<Dim>([&](auto d) { s += vel[d] * vel[d]; });
+        return s;
+    }
 
 public:
+    static constexpr int kDim = Dim;
+    using Escalar = T;
+
+    /**
+     * @brief Devuelve la coordenada @p d de la posición.
+     */
+    T Getpos(int d) const { return pos[d]; }
+
+    /**
+     * @brief Devuelve la componente @p d de la velocidad.
+     */
+    T Getvel(int d) const { return vel[d]; }
+
     /**
      * @brief Devuelve la posición X.
      */
-    double Getx() const { return x; }
+    T Getx() const { return pos[0]; }
 
     /**
      * @brief Devuelve la posición Y.
      */
-    double Gety() const { return y; }
+    T Gety() const { return pos[1]; }
+
+    /**
+     * @brief Devuelve la posición Z (sólo 3D).
+     */
+    template <int D = Dim, std::enable_if_t<(D >= 3), int> = 0>
+    T Getz() const {
+        return pos[2];
+    }
 
     /**
      * @brief Devuelve la magnitud de la velocidad.
      */
-    double Getv() const { return std::sqrt(vx * vx + vy * vy); }
+    T Getv() const { return std::sqrt(v2()); }
+
+    /**
+     * @brief Devuelve el ángulo de la velocidad respecto al eje X (sólo 2D).
+     *
+     * Se calcula al pedirlo: nada en el bucle de simulación lo necesita.
+     */
+    template <int D = Dim, std::enable_if_t<(D == 2), int> = 0>
+    T Gettheta() const {
+        return std::atan2(vel[1], vel[0]);
+    }
+
+    /**
+     * @brief Devuelve el radio de la esfera.
+     */
+    T GetR() const { return R; }
 
     /**
-     * @brief Inicializa las propiedades de la esfera.
+     * @brief Devuelve la masa.
+     */
+    T Getm() const { return m; }
+
+    /**
+     * @brief Devuelve la componente X de la velocidad.
+     */
+    T Getvx() const { return vel[0]; }
+
+    /**
+     * @brief Devuelve la componente Y de la velocidad.
+     */
+    T Getvy() const { return vel[1]; }
+
+    /**
+     * @brief Devuelve la componente Z de la velocidad (sólo 3D).
+     */
+    template <int D = Dim, std::enable_if_t<(D >= 3), int> = 0>
+    T Getvz() const {
+        return vel[2];
+    }
+
+    /**
+     * @brief Inicializa las propiedades de la esfera en cualquier dimensión.
+     * @param m0 Masa.
+     * @param p0 Posición.
+     * @param v0 Velocidad.
+     * @param R0 Radio.
+     */
+    void inicio(T m0, const std::array<T, Dim> &p0, const std::array<T, Dim> &v0, T R0) {
+        m = m0;
+        pos = p0;
+        vel = v0;
+        R = R0;
+    }
+
+    /**
+     * @brief Inicializa las propiedades de la esfera (2D).
      * @param m0 Masa.
      * @param x0 Posición en X.
      * @param y0 Posición en Y.
@@ -130,77 +364,72 @@ public:
      * @param vy0 Velocidad en Y.
      * @param R0 Radio.
      */
-    void inicio(double m0, double x0, double y0, double vx0, double vy0, double R0) {
-        m = m0;
-        x = x0;
-        y = y0;
-        vx = vx0;
-        vy = vy0;
-        R = R0;
-        actualizarAngulo();
+    template <int D = Dim, std::enable_if_t<(D == 2), int> = 0>
+    void inicio(T m0, T x0, T y0, T vx0, T vy0, T R0) {
+        inicio(m0, {x0, y0}, {vx0, vy0}, R0);
     }
 
     /**
      * @brief Actualiza la posición de la partícula según el tiempo dado.
      * @param t Paso temporal.
      */
-    void muevase(double t) {
-        x += vx * t;
-        y += vy * t;
+    void muevase(T t) {
+        paraCadaDim<Dim>([&](auto d) { pos[d] += vel[d] * t; });
     }
 
-    /**
-     * @brief Actualiza el ángulo de la velocidad.
-     */
-    void actualizarAngulo() { theta = std::atan2(vy, vx); }
-
     /**
      * @brief Detecta y maneja rebotes contra las paredes de la caja.
-     * @param caja Objeto Cajas que define los límites.
+     * @param caja Objeto CajasT que define los límites.
      */
-    void rebotePared(Cajas &caja) {
-        if ((x - caja.Getxmin()) <= R || (caja.Getxmax() - x) <= R) {
-            vx = -vx;
-            actualizarAngulo();
-            caja.calcularPresionN(m * (vx * vx + vy * vy));
-        }
-        if ((y - caja.Getymin()) <= R || (caja.Getymax() - y) <= R) {
-            vy = -vy;
-            actualizarAngulo();
-            caja.calcularPresionN(m * (vx * vx + vy * vy));
-        }
+    void rebotePared(CajasT<T, Dim> &caja) {
+        paraCadaDim<Dim>([&](auto d) {
+            if ((pos[d] - caja.Getmin(d)) <= R || (caja.Getmax(d) - pos[d]) <= R) {
+                vel[d] = -vel[d];
+                caja.calcularPresionN(m * v2());
+                caja.registrarImpulso(2 * m * std::fabs(vel[d]));
+            }
+        });
     }
 
     /**
      * @brief Detecta y resuelve colisiones elásticas con otra esfera.
      * @param otra Referencia a otra Esfera.
      */
-    void colision(Esfera &otra) {
-        double dx = otra.x - x;
-        double dy = otra.y - y;
-        double dist2 = dx * dx + dy * dy;
-        double Rsum = R + otra.R;
+    void colision(EsferaT &otra) {
+        std::array<T, Dim> dr;
+        T dist2 = 0;
+        paraCadaDim<Dim>([&](auto d) {
+            dr[d] = otra.pos[d] - pos[d];
+            dist2 += dr[d] * dr[d];
+        });
+        T Rsum = R + otra.R;
 
         if (dist2 <= Rsum * Rsum) {
-            double dist = std::sqrt(dist2);
+            T dist = std::sqrt(dist2);
             if (dist == 0) return;
 
-            double nx = dx / dist;
-            double ny = dy / dist;
-
-            double vn1 = vx * nx + vy * ny;
-            double vn2 = otra.vx * nx + otra.vy * ny;
-
-            double vn1_new = vn2;
-            double vn2_new = vn1;
+            T vn1 = 0, vn2 = 0;
+            paraCadaDim<Dim>([&](auto d) {
+                dr[d] /= dist;
+                vn1 += vel[d] * dr[d];
+                vn2 += otra.vel[d] * dr[d];
+            });
 
-            vx += (vn1_new - vn1) * nx;
-            vy += (vn1_new - vn1) * ny;
-            otra.vx += (vn2_new - vn2) * nx;
-            otra.vy += (vn2_new - vn2) * ny;
+            T vn1_new = vn2;
+            T vn2_new = vn1;
 
-            actualizarAngulo();
-            otra.actualizarAngulo();
+            paraCadaDim<Dim>([&](auto d) {
+                vel[d] += (vn1_new - vn1) * dr[d];
+                otra.vel[d] += (vn2_new - vn2) * dr[d];
+            });
         }
     }
 };
+
+/// Caja original: double y 2D.
+using Cajas = CajasT<double, 2>;
+
+/// Esfera original: double y 2D.
+using Esfera = EsferaT<double, 2>;
+
+#endif  // ESFERA_HPP
@@ -0,0 +1,109 @@
+/**
+ * @file FisicaComun.hpp
+ * @brief Física por partícula y por par compartida entre la CPU y la GPU.
+ *
+ * Asignación de celda, choque elástico entre dos esferas y rebote contra las
+ * paredes escritos una sola vez como funciones en línea sin dependencias de
+ * la biblioteca estándar. Con nvcc se marcan @c __host__ @c __device__, así
+ * que los núcleos CUDA (src/PasoGpu.cu) ejecutan exactamente las mismas
+ * operaciones que SistemaParticulas, MallaCeldas y KernelsSimd.
+ *
+ * @authors
+ * - Santiago Suárez
+ * - Eric Arciniegas
+ */
+
+#ifndef FISICA_COMUN_HPP
+#define FISICA_COMUN_HPP
+
+#include <cmath>
+
+#ifdef __CUDACC__
+#define CAJA_HD __host__ __device__
+#else
+#define CAJA_HD
+#endif
+
+namespace fisica {
+
+/**
+ * @struct ResultadoParedes
+ * @brief Contribuciones de los choques con las paredes en un recorrido.
+ */
+struct ResultadoParedes {
+    double sumaMv2 = 0;  ///< Suma de m·v² de cada choque.
+    double choques = 0;  ///< Número de choques.
+    double impulso = 0;  ///< Impulso total 2·m·|v_normal|.
+    double dPx = 0;      ///< Cambio del momento total en X de las esferas.
+    double dPy = 0;      ///< Cambio del momento total en Y de las esferas.
+};
+
+/**
+ * @brief Celda (cy·nx + cx) de una rejilla uniforme que contiene (x, y).
+ *
+ * Los puntos que se salen ligeramente de la caja van a la celda del borde.
+ */
+CAJA_HD inline int celda(double x, double y, double xmin, double ymin, double ladox, double ladoy,
+                         int nx, int ny) {
+    int cx = static_cast<int>((x - xmin) / ladox);
+    int cy = static_cast<int>((y - ymin) / ladoy);
+    cx = cx < 0 ? 0 : (cx > nx - 1 ? nx - 1 : cx);
+    cy = cy < 0 ? 0 : (cy > ny - 1 ? ny - 1 : cy);
+    return cy * nx + cx;
+}
+
+/**
+ * @brief Normal de contacto entre dos esferas separadas (dx, dy).
+ * @return false si no se tocan (o coinciden) y no hay choque que resolver.
+ */
+CAJA_HD inline bool normalContacto(double dx, double dy, double Rsum, double &nx, double &ny) {
+    double dist2 = dx * dx + dy * dy;
+    if (dist2 > Rsum * Rsum) return false;
+    double dist = std::sqrt(dist2);
+    if (dist == 0) return false;
+    nx = dx / dist;
+    ny = dy / dist;
+    return true;
+}
+
+/**
+ * @brief Intercambia las componentes normales de las velocidades (masas iguales).
+ */
+CAJA_HD inline void intercambiarNormal(double nx, double ny, double &vxi, double &vyi,
+                                       double &vxj, double &vyj) {
+    double vn1 = vxi * nx + vyi * ny;
+    double vn2 = vxj * nx + vyj * ny;
+    vxi += (vn2 - vn1) * nx;
+    vyi += (vn2 - vn1) * ny;
+    vxj += (vn1 - vn2) * nx;
+    vyj += (vn1 - vn2) * ny;
+}
+
+/**
+ * @brief Rebota una partícula de masa @p m contra las paredes y suma su aporte en @p r.
+ *
+ * Los límites ya vienen reducidos por el radio: x es válida en [xmin, xmax].
+ */
+CAJA_HD inline void rebotePared(double x, double y, double &vx, double &vy, double m,
+                                double xmin, double xmax, double ymin, double ymax,
+                                ResultadoParedes &r) {
+    double v2 = vx * vx + vy * vy;
+    if (x <= xmin || x >= xmax) {
+        vx = -vx;
+        r.sumaMv2 += m * v2;
+        r.choques += 1;
+        r.impulso += 2 * m * std::fabs(vx);
+        r.dPx += 2 * m * vx;
+    }
+    if (y <= ymin || y >= ymax) {
+        vy = -vy;
+        r.sumaMv2 += m * v2;
+        r.choques += 1;
+        r.impulso += 2 * m * std::fabs(vy);
+        r.dPy += 2 * m * vy;
+    }
+}
+
+}  // namespace fisica
+
+#endif  // FISICA_COMUN_HPP
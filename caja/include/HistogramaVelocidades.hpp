@@ -0,0 +1,123 @@
+/**
+ * @file HistogramaVelocidades.hpp
+ * @brief Histograma de rapideces y ajuste de Maxwell–Boltzmann calculados en memoria.
+ *
+ * Reemplaza el esquema de escribir las rapideces a disco y pedirle a gnuplot
+ * que las binee con @c stats y @c smooth freq en cada frame: el histograma se
+ * llena durante el bucle principal y a gnuplot sólo le llegan las cuentas.
+ *
+ * @authors
+ * - Santiago Suárez
+ * - Eric Arciniegas
+ */
+
+#ifndef HISTOGRAMA_VELOCIDADES_HPP
+#define HISTOGRAMA_VELOCIDADES_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "SistemaParticulas.hpp"
+
+/**
+ * @class HistogramaVelocidades
+ * @brief Cuentas por intervalo de la rapidez |v| y temperatura ajustada.
+ *
+ * Con rango fijo los intervalos cubren [0, vtope); con rango adaptativo se
+ * recalculan en cada frame como [0, max|v|]. El ajuste usa la distribución de
+ * Maxwell–Boltzmann en 2D, f(v) = (m v / kT) exp(-m v² / 2kT), cuyo estimador
+ * de máxima verosimilitud es kT = <m v²> / 2.
+ */
+class HistogramaVelocidades {
+private:
+    int nbins;                  ///< Número de intervalos.
+    bool adaptativo;            ///< Rango recalculado en cada frame.
+    double vtope;               ///< Límite superior del rango.
+    double ancho;               ///< Ancho de cada intervalo.
+    double masa;                ///< Masa usada en el ajuste.
+    int muestras;               ///< Rapideces del último frame.
+    std::vector<long> cuentas;  ///< Cuentas del último frame.
+    double kTFrame;             ///< kT estimado en el último frame.
+    double sumaKT;              ///< Suma de kT de todos los frames.
+    long frames;                ///< Frames acumulados.
+    std::vector<double> v;      ///< Rapideces del frame (memoria reutilizada).
+
+public:
+    /**
+     * @brief Configura el histograma.
+     * @param nbins_ Número de intervalos.
+     * @param vtope_ Límite superior fijo; si es <= 0 el rango es adaptativo.
+     * @param masa_ Masa de las partículas (para el ajuste).
+     */
+    void inicio(int nbins_, double vtope_, double masa_) {
+        nbins = std::max(1, nbins_);
+        adaptativo = vtope_ <= 0;
+        vtope = adaptativo ? 1.0 : vtope_;
+        ancho = vtope / nbins;
+        masa = masa_;
+        muestras = 0;
+        cuentas.assign(nbins, 0);
+        kTFrame = 0;
+        sumaKT = 0;
+        frames = 0;
+    }
+
+    /**
+     * @brief Binea las rapideces actuales y actualiza el ajuste.
+     * @param sis Partículas.
+     */
+    void acumular(const SistemaParticulas &sis) {
+        int n = sis.size();
+        const double *vx = sis.datosVX();
+        const double *vy = sis.datosVY();
+        sis.rapideces(v);
+        double mv2 = simd::sumaV2(vx, vy, n);
+        double maximo = 0;
+        for (int i = 0; i < n; i++) maximo = std::max(maximo, v[i]);
+        if (adaptativo) {
+            vtope = std::max(maximo, 1e-9) * (1 + 1e-12);
+            ancho = vtope / nbins;
+        }
+        std::fill(cuentas.begin(), cuentas.end(), 0);
+        for (int i = 0; i < n; i++) {
+            int b = static_cast<int>(v[i] / ancho);
+            if (b >= 0 && b < nbins) cuentas[b]++;
+        }
+        muestras = n;
+        kTFrame = n > 0 ? masa * mv2 / (2.0 * n) : 0;
+        sumaKT += kTFrame;
+        frames++;
+    }
+
+    int Getnbins() const { return nbins; }
+    double Getancho() const { return ancho; }
+    double Getvtope() const { return vtope; }
+    const std::vector<long> &Getcuentas() const { return cuentas; }
+
+    /**
+     * @brief Centro del intervalo @p b.
+     */
+    double centro(int b) const { return (b + 0.5) * ancho; }
+
+    /**
+     * @brief kT ajustado con el último frame.
+     */
+    double GetkTFrame() const { return kTFrame; }
+
+    /**
+     * @brief kT ajustado promediando todos los frames acumulados.
+     */
+    double GetkT() const { return frames > 0 ? sumaKT / frames : 0; }
+
+    /**
+     * @brief Cuentas esperadas en el intervalo centrado en @p vc según Maxwell–Boltzmann.
+     * @param vc Rapidez.
+     * @param kT Temperatura del ajuste.
+     */
+    double maxwell(double vc, double kT) const {
+        if (kT <= 0) return 0;
+        return muestras * ancho * (masa * vc / kT) * std::exp(-masa * vc * vc / (2 * kT));
+    }
+};
+
+#endif  // HISTOGRAMA_VELOCIDADES_HPP
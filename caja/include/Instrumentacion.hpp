@@ -0,0 +1,289 @@
+/**
+ * @file Instrumentacion.hpp
+ * @brief Temporizadores por fase y contadores del bucle principal.
+ *
+ * Con -DCAJA_INSTRUMENTAR (make INSTRUMENTAR=1) cada fase marcada con
+ * CAJA_MEDIR suma los ciclos del contador de la CPU (rdtsc; reloj monótono
+ * fuera de x86) y CAJA_CONTAR suma a contadores propios de cada hilo, sin
+ * operaciones atómicas de lectura-escritura en el bucle de pares. Al final se
+ * escribe un resumen en JSON y, si se pide, una traza por paso en CSV.
+ *
+ * Sin la bandera las macros se expanden a nada y las funciones de
+ * resumen quedan vacías: la instrumentación no cuesta nada.
+ *
+ * @authors
+ * - Santiago Suárez
+ * - Eric Arciniegas
+ */
+
+#ifndef INSTRUMENTACION_HPP
+#define INSTRUMENTACION_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(CAJA_INSTRUMENTAR) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define CAJA_INSTR_RDTSC 1
+#endif
+
+namespace instr {
+
+/// Fases del paso que se miden por separado.
+enum Fase {
+    kMalla,        ///< Construcción de la rejilla o de la lista de vecinos.
+    kColisiones,   ///< Prueba y resolución de pares.
+    kParedes,      ///< Rebotes contra las paredes (en paralelo, junto con el movimiento).
+    kMovimiento,   ///< Avance de posiciones.
+    kEventos,      ///< Motor dirigido por eventos.
+    kTrayectoria,  ///< Escritura de la trayectoria binaria.
+    kHistograma,   ///< Histograma de rapideces y su archivo.
+    kRender,       ///< Copia del frame para el hilo de gnuplot.
+    kPresion,      ///< Cálculo y escritura de la presión.
+    kReorden,      ///< Reordenamiento de Morton.
+    kCheckpoint,   ///< Instantáneas.
+    kGpu,          ///< Paso en la GPU y copias al host.
+    kNumFases
+};
+
+/// Contadores de eventos.
+enum Contador {
+    kParesProbados,
+    kColisionesResueltas,
+    kChoquesPared,
+    kBytesEscritos,
+    kFramesRender,
+    kFramesDescartados,
+    kNumContadores
+};
+
+inline const char *nombreFase(int f) {
+    static const char *nombres[kNumFases] = {"malla", "colisiones", "paredes", "movimiento", "eventos",
+                                             "trayectoria", "histograma", "render", "presion",
+                                             "reorden", "checkpoint", "gpu"};
+    return nombres[f];
+}
+
+inline const char *nombreContador(int c) {
+    static const char *nombres[kNumContadores] = {"pares_probados", "colisiones_resueltas",
+                                                  "choques_pared", "bytes_escritos", "frames_render",
+                                                  "frames_descartados"};
+    return nombres[c];
+}
+
+#ifdef CAJA_INSTRUMENTAR
+
+constexpr bool kActiva = true;
+
+/**
+ * @brief Lectura del contador de ciclos (o nanosegundos sin rdtsc).
+ */
+inline uint64_t ciclos() {
+#ifdef CAJA_INSTR_RDTSC
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+/**
+ * @struct ContadoresHilo
+ * @brief Contadores de un hilo: sólo él escribe, el resumen sólo lee.
+ */
+struct ContadoresHilo {
+    std::atomic<uint64_t> v[kNumContadores];
+    ContadoresHilo() {
+        for (auto &c : v) c.store(0, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @struct Registro
+ * @brief Acumuladores globales de la corrida.
+ */
+struct Registro {
+    std::atomic<uint64_t> ciclosFase[kNumFases];
+    std::atomic<uint64_t> llamadas[kNumFases];
+    std::mutex mutex;
+    std::vector<ContadoresHilo *> hilos;  ///< Se conservan hasta el final del programa.
+    uint64_t ciclosPrevios[kNumFases];        ///< Para la traza por paso.
+    uint64_t contadoresPrevios[kNumContadores];
+    uint64_t ciclos0 = 0;
+    std::chrono::steady_clock::time_point reloj0;
+    std::FILE *traza = nullptr;
+
+    Registro() {
+        for (int f = 0; f < kNumFases; f++) {
+            ciclosFase[f] = 0;
+            llamadas[f] = 0;
+            ciclosPrevios[f] = 0;
+        }
+        for (int c = 0; c < kNumContadores; c++) contadoresPrevios[c] = 0;
+        ciclos0 = ciclos();
+        reloj0 = std::chrono::steady_clock::now();
+    }
+
+    /**
+     * @brief Suma de un contador sobre todos los hilos.
+     */
+    uint64_t contador(int c) {
+        std::lock_guard<std::mutex> l(mutex);
+        uint64_t s = 0;
+        for (ContadoresHilo *h : hilos) s += h->v[c].load(std::memory_order_relaxed);
+        return s;
+    }
+};
+
+inline Registro &registro() {
+    static Registro r;
+    return r;
+}
+
+/**
+ * @brief Contadores del hilo que llama (se registran la primera vez).
+ */
+inline ContadoresHilo &contadoresHilo() {
+    thread_local ContadoresHilo *propio = nullptr;
+    if (!propio) {
+        propio = new ContadoresHilo();
+        Registro &r = registro();
+        std::lock_guard<std::mutex> l(r.mutex);
+        r.hilos.push_back(propio);
+    }
+    return *propio;
+}
+
+/**
+ * @class Temporizador
+ * @brief Suma a una fase los ciclos transcurridos en su ámbito.
+ */
+class Temporizador {
+private:
+    int fase;
+    uint64_t t0;
+
+public:
+    explicit Temporizador(int f) : fase(f), t0(ciclos()) {}
+    ~Temporizador() {
+        Registro &r = registro();
+        r.ciclosFase[fase].fetch_add(ciclos() - t0, std::memory_order_relaxed);
+        r.llamadas[fase].fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+inline void contar(int c, uint64_t v) {
+    std::atomic<uint64_t> &x = contadoresHilo().v[c];
+    x.store(x.load(std::memory_order_relaxed) + v, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Marca el comienzo de la corrida (referencia del tiempo total).
+ */
+inline void iniciar() {
+    Registro &r = registro();
+    r.ciclos0 = ciclos();
+    r.reloj0 = std::chrono::steady_clock::now();
+}
+
+/**
+ * @brief Abre la traza por paso (CSV con una columna por fase y contador).
+ */
+inline bool abrirTraza(const std::string &ruta) {
+    Registro &r = registro();
+    r.traza = std::fopen(ruta.c_str(), "w");
+    if (!r.traza) return false;
+    std::fprintf(r.traza, "paso");
+    for (int f = 0; f < kNumFases; f++) std::fprintf(r.traza, ",%s", nombreFase(f));
+    for (int c = 0; c < kNumContadores; c++) std::fprintf(r.traza, ",%s", nombreContador(c));
+    std::fprintf(r.traza, "\n");
+    return true;
+}
+
+/**
+ * @brief Escribe en la traza lo acumulado desde el paso anterior.
+ */
+inline void cerrarPaso(int paso) {
+    Registro &r = registro();
+    if (!r.traza) return;
+    std::fprintf(r.traza, "%d", paso);
+    for (int f = 0; f < kNumFases; f++) {
+        uint64_t v = r.ciclosFase[f].load(std::memory_order_relaxed);
+        std::fprintf(r.traza, ",%llu", static_cast<unsigned long long>(v - r.ciclosPrevios[f]));
+        r.ciclosPrevios[f] = v;
+    }
+    for (int c = 0; c < kNumContadores; c++) {
+        uint64_t v = r.contador(c);
+        std::fprintf(r.traza, ",%llu", static_cast<unsigned long long>(v - r.contadoresPrevios[c]));
+        r.contadoresPrevios[c] = v;
+    }
+    std::fprintf(r.traza, "\n");
+}
+
+/**
+ * @brief Escribe el resumen en JSON y cierra la traza.
+ * @param ruta Archivo de salida.
+ * @param pasos Pasos simulados.
+ * @param n Número de esferas.
+ * @return false si no se pudo abrir el archivo.
+ */
+inline bool escribirResumen(const std::string &ruta, long pasos, int n) {
+    Registro &r = registro();
+    if (r.traza) {
+        std::fclose(r.traza);
+        r.traza = nullptr;
+    }
+    std::FILE *f = std::fopen(ruta.c_str(), "w");
+    if (!f) return false;
+    double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - r.reloj0).count();
+    uint64_t total = ciclos() - r.ciclos0;
+    double segPorCiclo = total > 0 ? segundos / total : 0;
+    std::fprintf(f, "{\n  \"pasos\": %ld,\n  \"n\": %d,\n  \"segundos\": %.6f,\n  \"ciclos\": %llu,\n",
+                 pasos, n, segundos, static_cast<unsigned long long>(total));
+    std::fprintf(f, "  \"fases\": {\n");
+    for (int k = 0; k < kNumFases; k++) {
+        uint64_t c = r.ciclosFase[k].load();
+        std::fprintf(f, "    \"%s\": {\"ciclos\": %llu, \"llamadas\": %llu, \"segundos\": %.6f, \"fraccion\": %.4f}%s\n",
+                     nombreFase(k), static_cast<unsigned long long>(c),
+                     static_cast<unsigned long long>(r.llamadas[k].load()), c * segPorCiclo,
+                     total > 0 ? static_cast<double>(c) / total : 0.0, k + 1 < kNumFases ? "," : "");
+    }
+    std::fprintf(f, "  },\n  \"contadores\": {\n");
+    for (int k = 0; k < kNumContadores; k++) {
+        std::fprintf(f, "    \"%s\": %llu%s\n", nombreContador(k),
+                     static_cast<unsigned long long>(r.contador(k)), k + 1 < kNumContadores ? "," : "");
+    }
+    std::fprintf(f, "  }\n}\n");
+    std::fclose(f);
+    return true;
+}
+
+#define CAJA_CONCAT2(a, b) a##b
+#define CAJA_CONCAT(a, b) CAJA_CONCAT2(a, b)
+/// Mide el resto del ámbito actual en la fase @p fase (p. ej. instr::kColisiones).
+#define CAJA_MEDIR(fase) ::instr::Temporizador CAJA_CONCAT(caja_temporizador_, __LINE__)(fase)
+/// Suma @p v al contador @p c (p. ej. instr::kChoquesPared).
+#define CAJA_CONTAR(c, v) ::instr::contar((c), static_cast<uint64_t>(v))
+
+#else  // !CAJA_INSTRUMENTAR
+
+constexpr bool kActiva = false;
+
+inline void iniciar() {}
+inline bool abrirTraza(const std::string &) { return false; }
+inline void cerrarPaso(int) {}
+inline bool escribirResumen(const std::string &, long, int) { return false; }
+
+#define CAJA_MEDIR(fase) ((void)0)
+#define CAJA_CONTAR(c, v) ((void)0)
+
+#endif  // CAJA_INSTRUMENTAR
+
+}  // namespace instr
+
+#endif  // INSTRUMENTACION_HPP
@@ -0,0 +1,399 @@
+/**
+ * @file KernelsSimd.hpp
+ * @brief Núcleos vectorizados (AVX2 / AVX-512) para los recorridos por paso.
+ *
+ * Movimiento, rebote contra las paredes y energía cinética son bucles
+ * independientes por partícula sobre los arreglos SoA. Aquí se implementan
+ * con intrínsecos AVX2 y AVX-512, eligiendo en tiempo de ejecución la mejor
+ * versión que soporte la CPU, con una versión escalar de respaldo.
+ *
+ * El movimiento usa multiplicación y suma separadas (sin FMA), así que las
+ * posiciones son idénticas bit a bit en los tres niveles y en la GPU
+ * compilada con -fmad=false. Las reducciones (energía, impulso) sí usan FMA
+ * y pueden diferir en el último bit; no realimentan la dinámica.
+ *
+ * El nivel se puede forzar con la variable de entorno CAJA_SIMD
+ * (escalar, avx2 o avx512), útil para comparar resultados y rendimiento.
+ *
+ * @authors
+ * - Santiago Suárez
+ * - Eric Arciniegas
+ */
+
+#ifndef KERNELS_SIMD_HPP
+#define KERNELS_SIMD_HPP
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include "FisicaComun.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CAJA_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace simd {
+
+/// Conjuntos de instrucciones disponibles.
+enum class Nivel { kEscalar, kAVX2, kAVX512 };
+
+/// Contribuciones de los choques con las paredes (compartidas con la GPU).
+using ResultadoParedes = fisica::ResultadoParedes;
+
+/**
+ * @brief Límites de la caja reducidos por el radio (x válida en [xmin+R, xmax-R]).
+ */
+struct Limites {
+    double xmin, xmax, ymin, ymax;
+};
+
+// ======================= Versión escalar =======================
+
+inline void muevaseEscalar(double *x, double *y, const double *vx, const double *vy,
+                           int i0, int n, double dt) {
+    for (int i = i0; i < n; i++) {
+        x[i] += vx[i] * dt;
+        y[i] += vy[i] * dt;
+    }
+}
+
+inline void reboteEscalar(const double *x, const double *y, double *vx, double *vy,
+                          int i0, int n, double m, const Limites &l, ResultadoParedes &r) {
+    for (int i = i0; i < n; i++) {
+        fisica::rebotePared(x[i], y[i], vx[i], vy[i], m, l.xmin, l.xmax, l.ymin, l.ymax, r);
+    }
+}
+
+inline double sumaV2Escalar(const double *vx, const double *vy, int i0, int n) {
+    double s = 0;
+    for (int i = i0; i < n; i++) s += vx[i] * vx[i] + vy[i] * vy[i];
+    return s;
+}
+
+inline void rapidecesEscalar(const double *vx, const double *vy, int i0, int n, double *v) {
+    for (int i = i0; i < n; i++) v[i] = std::sqrt(vx[i] * vx[i] + vy[i] * vy[i]);
+}
+
+inline void angulosEscalar(const double *vx, const double *vy, int i0, int n, double *theta) {
+    for (int i = i0; i < n; i++) theta[i] = std::atan2(vy[i], vx[i]);
+}
+
+#ifdef CAJA_SIMD_X86
+
+// ======================= AVX2 =======================
+
+__attribute__((target("avx2,fma")))
+inline double sumaHorizontal(__m256d v) {
+    __m128d s = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+}
+
+__attribute__((target("avx2,fma")))
+inline void muevaseAVX2(double *x, double *y, const double *vx, const double *vy, int n, double dt) {
+    __m256d vdt = _mm256_set1_pd(dt);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm256_storeu_pd(x + i, _mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(vx + i), vdt), _mm256_loadu_pd(x + i)));
+        _mm256_storeu_pd(y + i, _mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(vy + i), vdt), _mm256_loadu_pd(y + i)));
+    }
+    muevaseEscalar(x, y, vx, vy, i, n, dt);
+}
+
+__attribute__((target("avx2,fma")))
+inline void reboteAVX2(const double *x, const double *y, double *vx, double *vy, int n,
+                       double m, const Limites &l, ResultadoParedes &r) {
+    const __m256d signo = _mm256_set1_pd(-0.0);
+    const __m256d uno = _mm256_set1_pd(1.0);
+    const __m256d xmin = _mm256_set1_pd(l.xmin), xmax = _mm256_set1_pd(l.xmax);
+    const __m256d ymin = _mm256_set1_pd(l.ymin), ymax = _mm256_set1_pd(l.ymax);
+    __m256d smv2 = _mm256_setzero_pd(), sch = _mm256_setzero_pd(), simp = _mm256_setzero_pd();
+    __m256d spx = _mm256_setzero_pd(), spy = _mm256_setzero_pd();
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d px = _mm256_loadu_pd(x + i), py = _mm256_loadu_pd(y + i);
+        __m256d pvx = _mm256_loadu_pd(vx + i), pvy = _mm256_loadu_pd(vy + i);
+        __m256d v2 = _mm256_fmadd_pd(pvx, pvx, _mm256_mul_pd(pvy, pvy));
+
+        __m256d mx = _mm256_or_pd(_mm256_cmp_pd(px, xmin, _CMP_LE_OQ), _mm256_cmp_pd(px, xmax, _CMP_GE_OQ));
+        __m256d my = _mm256_or_pd(_mm256_cmp_pd(py, ymin, _CMP_LE_OQ), _mm256_cmp_pd(py, ymax, _CMP_GE_OQ));
+        pvx = _mm256_xor_pd(pvx, _mm256_and_pd(mx, signo));
+        pvy = _mm256_xor_pd(pvy, _mm256_and_pd(my, signo));
+        _mm256_storeu_pd(vx + i, pvx);
+        _mm256_storeu_pd(vy + i, pvy);
+
+        __m256d cx = _mm256_and_pd(mx, uno), cy = _mm256_and_pd(my, uno);
+        __m256d c = _mm256_add_pd(cx, cy);
+        sch = _mm256_add_pd(sch, c);
+        smv2 = _mm256_fmadd_pd(c, v2, smv2);
+        simp = _mm256_fmadd_pd(cx, _mm256_andnot_pd(signo, pvx), simp);
+        simp = _mm256_fmadd_pd(cy, _mm256_andnot_pd(signo, pvy), simp);
+        spx = _mm256_fmadd_pd(cx, pvx, spx);
+        spy = _mm256_fmadd_pd(cy, pvy, spy);
+    }
+    r.sumaMv2 += m * sumaHorizontal(smv2);
+    r.choques += sumaHorizontal(sch);
+    r.impulso += 2 * m * sumaHorizontal(simp);
+    r.dPx += 2 * m * sumaHorizontal(spx);
+    r.dPy += 2 * m * sumaHorizontal(spy);
+    reboteEscalar(x, y, vx, vy, i, n, m, l, r);
+}
+
+__attribute__((target("avx2,fma")))
+inline double sumaV2AVX2(const double *vx, const double *vy, int n) {
+    __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d a = _mm256_loadu_pd(vx + i), b = _mm256_loadu_pd(vy + i);
+        s0 = _mm256_fmadd_pd(a, a, s0);
+        s1 = _mm256_fmadd_pd(b, b, s1);
+    }
+    return sumaHorizontal(_mm256_add_pd(s0, s1)) + sumaV2Escalar(vx, vy, i, n);
+}
+
+__attribute__((target("avx2,fma")))
+inline void rapidecesAVX2(const double *vx, const double *vy, int n, double *v) {
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d a = _mm256_loadu_pd(vx + i), b = _mm256_loadu_pd(vy + i);
+        _mm256_storeu_pd(v + i, _mm256_sqrt_pd(_mm256_fmadd_pd(a, a, _mm256_mul_pd(b, b))));
+    }
+    rapidecesEscalar(vx, vy, i, n, v);
+}
+
+/**
+ * atan2 por carril: se reduce a atan(a) con a = min/max en [0, 1], luego a
+ * |t| <= tan(π/8) con atan(a) = π/4 + atan((a-1)/(a+1)), y se evalúa la serie
+ * impar hasta t^23 (error < 1e-10 respecto a std::atan2).
+ */
+__attribute__((target("avx2,fma")))
+inline void angulosAVX2(const double *vx, const double *vy, int n, double *theta) {
+    const __m256d signo = _mm256_set1_pd(-0.0);
+    const __m256d cero = _mm256_setzero_pd(), uno = _mm256_set1_pd(1.0);
+    const __m256d tanpi8 = _mm256_set1_pd(0.41421356237309503);
+    const __m256d pi4 = _mm256_set1_pd(0.78539816339744831);
+    const __m256d pi2 = _mm256_set1_pd(1.5707963267948966);
+    const __m256d pi = _mm256_set1_pd(3.1415926535897931);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d x = _mm256_loadu_pd(vx + i), y = _mm256_loadu_pd(vy + i);
+        __m256d ax = _mm256_andnot_pd(signo, x), ay = _mm256_andnot_pd(signo, y);
+        __m256d mayor = _mm256_max_pd(ax, ay), menor = _mm256_min_pd(ax, ay);
+        __m256d a = _mm256_div_pd(menor, mayor);
+        a = _mm256_blendv_pd(a, cero, _mm256_cmp_pd(mayor, cero, _CMP_EQ_OQ));
+
+        __m256d grande = _mm256_cmp_pd(a, tanpi8, _CMP_GT_OQ);
+        __m256d t = _mm256_blendv_pd(a, _mm256_div_pd(_mm256_sub_pd(a, uno), _mm256_add_pd(a, uno)), grande);
+        __m256d t2 = _mm256_mul_pd(t, t);
+        __m256d p = _mm256_set1_pd(-1.0 / 23);
+        for (int k = 21; k >= 1; k -= 2) {
+            double c = ((k / 2) % 2 == 0) ? 1.0 / k : -1.0 / k;
+            p = _mm256_fmadd_pd(p, t2, _mm256_set1_pd(c));
+        }
+        __m256d r = _mm256_add_pd(_mm256_mul_pd(p, t), _mm256_and_pd(grande, pi4));
+
+        r = _mm256_blendv_pd(r, _mm256_sub_pd(pi2, r), _mm256_cmp_pd(ay, ax, _CMP_GT_OQ));
+        r = _mm256_blendv_pd(r, _mm256_sub_pd(pi, r), x);  // bit de signo de x
+        r = _mm256_or_pd(r, _mm256_and_pd(y, signo));
+        _mm256_storeu_pd(theta + i, r);
+    }
+    angulosEscalar(vx, vy, i, n, theta);
+}
+
+// ======================= AVX-512 =======================
+
+/**
+ * Suma de los 8 carriles en el mismo orden que _mm512_reduce_add_pd, pero
+ * sin su extracción con _mm256_undefined_pd, que en GCC 12 con -O2 produce
+ * avisos -Wuninitialized falsos.
+ */
+__attribute__((target("avx512f")))
+inline double sumaHorizontal512(__m512d v) {
+    alignas(64) double t[8];
+    _mm512_store_pd(t, v);
+    double a0 = t[4] + t[0], a1 = t[5] + t[1], a2 = t[6] + t[2], a3 = t[7] + t[3];
+    return (a2 + a0) + (a3 + a1);
+}
+
+__attribute__((target("avx512f")))
+inline void muevaseAVX512(double *x, double *y, const double *vx, const double *vy, int n, double dt) {
+    __m512d vdt = _mm512_set1_pd(dt);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm512_storeu_pd(x + i, _mm512_add_pd(_mm512_mul_pd(_mm512_loadu_pd(vx + i), vdt), _mm512_loadu_pd(x + i)));
+        _mm512_storeu_pd(y + i, _mm512_add_pd(_mm512_mul_pd(_mm512_loadu_pd(vy + i), vdt), _mm512_loadu_pd(y + i)));
+    }
+    muevaseEscalar(x, y, vx, vy, i, n, dt);
+}
+
+__attribute__((target("avx512f")))
+inline void reboteAVX512(const double *x, const double *y, double *vx, double *vy, int n,
+                         double m, const Limites &l, ResultadoParedes &r) {
+    const __m512d xmin = _mm512_set1_pd(l.xmin), xmax = _mm512_set1_pd(l.xmax);
+    const __m512d ymin = _mm512_set1_pd(l.ymin), ymax = _mm512_set1_pd(l.ymax);
+    const __m512d cero = _mm512_setzero_pd();
+    const __m512d uno = _mm512_set1_pd(1.0);
+    __m512d smv2 = cero, sch = cero, simp = cero, spx = cero, spy = cero;
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512d px = _mm512_loadu_pd(x + i), py = _mm512_loadu_pd(y + i);
+        __m512d pvx = _mm512_loadu_pd(vx + i), pvy = _mm512_loadu_pd(vy + i);
+        __m512d v2 = _mm512_fmadd_pd(pvx, pvx, _mm512_mul_pd(pvy, pvy));
+
+        __mmask8 mx = _mm512_cmp_pd_mask(px, xmin, _CMP_LE_OQ) | _mm512_cmp_pd_mask(px, xmax, _CMP_GE_OQ);
+        __mmask8 my = _mm512_cmp_pd_mask(py, ymin, _CMP_LE_OQ) | _mm512_cmp_pd_mask(py, ymax, _CMP_GE_OQ);
+        pvx = _mm512_mask_sub_pd(pvx, mx, cero, pvx);
+        pvy = _mm512_mask_sub_pd(pvy, my, cero, pvy);
+        _mm512_storeu_pd(vx + i, pvx);
+        _mm512_storeu_pd(vy + i, pvy);
+
+        __m512d cx = _mm512_maskz_mov_pd(mx, uno), cy = _mm512_maskz_mov_pd(my, uno);
+        __m512d c = _mm512_add_pd(cx, cy);
+        sch = _mm512_add_pd(sch, c);
+        smv2 = _mm512_fmadd_pd(c, v2, smv2);
+        simp = _mm512_mask_add_pd(simp, mx, simp, _mm512_abs_pd(pvx));
+        simp = _mm512_mask_add_pd(simp, my, simp, _mm512_abs_pd(pvy));
+        spx = _mm512_mask_add_pd(spx, mx, spx, pvx);
+        spy = _mm512_mask_add_pd(spy, my, spy, pvy);
+    }
+    r.sumaMv2 += m * sumaHorizontal512(smv2);
+    r.choques += sumaHorizontal512(sch);
+    r.impulso += 2 * m * sumaHorizontal512(simp);
+    r.dPx += 2 * m * sumaHorizontal512(spx);
+    r.dPy += 2 * m * sumaHorizontal512(spy);
+    reboteEscalar(x, y, vx, vy, i, n, m, l, r);
+}
+
+__attribute__((target("avx512f")))
+inline double sumaV2AVX512(const double *vx, const double *vy, int n) {
+    __m512d s0 = _mm512_setzero_pd(), s1 = _mm512_setzero_pd();
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512d a = _mm512_loadu_pd(vx + i), b = _mm512_loadu_pd(vy + i);
+        s0 = _mm512_fmadd_pd(a, a, s0);
+        s1 = _mm512_fmadd_pd(b, b, s1);
+    }
+    return sumaHorizontal512(_mm512_add_pd(s0, s1)) + sumaV2Escalar(vx, vy, i, n);
+}
+
+#endif  // CAJA_SIMD_X86
+
+// ======================= Despacho =======================
+
+/**
+ * @brief Detecta el mejor nivel soportado por la CPU (o el pedido en CAJA_SIMD).
+ */
+inline Nivel detectarNivel() {
+    Nivel mejor = Nivel::kEscalar;
+#ifdef CAJA_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) mejor = Nivel::kAVX2;
+    if (__builtin_cpu_supports("avx512f")) mejor = Nivel::kAVX512;
+#endif
+    const char *pedido = std::getenv("CAJA_SIMD");
+    if (pedido) {
+        Nivel n = mejor;
+        if (std::strcmp(pedido, "escalar") == 0) n = Nivel::kEscalar;
+        if (std::strcmp(pedido, "avx2") == 0) n = Nivel::kAVX2;
+        if (std::strcmp(pedido, "avx512") == 0) n = Nivel::kAVX512;
+        if (static_cast<int>(n) < static_cast<int>(mejor)) mejor = n;
+    }
+    return mejor;
+}
+
+/**
+ * @brief Nivel en uso; se detecta una vez y puede cambiarse (p. ej. en benchmarks).
+ */
+inline Nivel &nivelActivo() {
+    static Nivel nivel = detectarNivel();
+    return nivel;
+}
+
+/**
+ * @brief Nombre legible del nivel en uso.
+ */
+inline const char *nombreNivel() {
+    switch (nivelActivo()) {
+        case Nivel::kAVX512: return "avx512";
+        case Nivel::kAVX2: return "avx2";
+        default: return "escalar";
+    }
+}
+
+/**
+ * @brief x += vx·dt, y += vy·dt para las @p n partículas.
+ */
+inline void muevase(double *x, double *y, const double *vx, const double *vy, int n, double dt) {
+#ifdef CAJA_SIMD_X86
+    switch (nivelActivo()) {
+        case Nivel::kAVX512: muevaseAVX512(x, y, vx, vy, n, dt); return;
+        case Nivel::kAVX2: muevaseAVX2(x, y, vx, vy, n, dt); return;
+        default: break;
+    }
+#endif
+    muevaseEscalar(x, y, vx, vy, 0, n, dt);
+}
+
+/**
+ * @brief Rebote contra las cuatro paredes con masa y radio uniformes.
+ *
+ * Las contribuciones a la presión se acumulan por carril y se suman en @p r.
+ */
+inline void rebotePared(const double *x, const double *y, double *vx, double *vy, int n,
+                        double m, const Limites &l, ResultadoParedes &r) {
+#ifdef CAJA_SIMD_X86
+    switch (nivelActivo()) {
+        case Nivel::kAVX512: reboteAVX512(x, y, vx, vy, n, m, l, r); return;
+        case Nivel::kAVX2: reboteAVX2(x, y, vx, vy, n, m, l, r); return;
+        default: break;
+    }
+#endif
+    reboteEscalar(x, y, vx, vy, 0, n, m, l, r);
+}
+
+/**
+ * @brief Suma de vx² + vy² de las @p n partículas.
+ */
+inline double sumaV2(const double *vx, const double *vy, int n) {
+#ifdef CAJA_SIMD_X86
+    switch (nivelActivo()) {
+        case Nivel::kAVX512: return sumaV2AVX512(vx, vy, n);
+        case Nivel::kAVX2: return sumaV2AVX2(vx, vy, n);
+        default: break;
+    }
+#endif
+    return sumaV2Escalar(vx, vy, 0, n);
+}
+
+/**
+ * @brief Rapidez sqrt(vx² + vy²) de las @p n partículas, escrita en @p v.
+ */
+inline void rapideces(const double *vx, const double *vy, int n, double *v) {
+#ifdef CAJA_SIMD_X86
+    if (nivelActivo() != Nivel::kEscalar) {
+        rapidecesAVX2(vx, vy, n, v);
+        return;
+    }
+#endif
+    rapidecesEscalar(vx, vy, 0, n, v);
+}
+
+/**
+ * @brief Ángulo atan2(vy, vx) de las @p n partículas, escrito en @p theta.
+ *
+ * Pensado para diagnósticos (distribución angular), no para el bucle de
+ * simulación. La versión vectorial difiere de std::atan2 en menos de 1e-10.
+ */
+inline void angulos(const double *vx, const double *vy, int n, double *theta) {
+#ifdef CAJA_SIMD_X86
+    if (nivelActivo() != Nivel::kEscalar) {
+        angulosAVX2(vx, vy, n, theta);
+        return;
+    }
+#endif
+    angulosEscalar(vx, vy, 0, n, theta);
+}
+
+}  // namespace simd
+
+#endif  // KERNELS_SIMD_HPP
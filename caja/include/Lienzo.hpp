@@ -0,0 +1,187 @@
+/**
+ * @file Lienzo.hpp
+ * @brief Framebuffer de 8 bits con paleta: discos, rectángulos, líneas y texto.
+ *
+ * Es el rasterizador de las animaciones nativas: los discos se pintan por
+ * tramos horizontales precalculados para el radio en uso, directamente desde
+ * los arreglos de posiciones, sin pasar por texto. Cada píxel es un índice a
+ * la paleta de 16 colores (paletaRender), que es lo que necesita el
+ * codificador GIF.
+ *
+ * @authors
+ * - Santiago Suárez
+ * - Eric Arciniegas
+ */
+
+#ifndef LIENZO_HPP
+#define LIENZO_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+/// Índices de la paleta de render.
+enum ColorRender : uint8_t {
+    kBlanco,
+    kNegro,
+    kGrisOscuro,
+    kEsfera,      ///< Morado de gnuplot (lc 1).
+    kBarra,       ///< Azul de las barras del histograma.
+    kCurva,       ///< Rojo del ajuste de Maxwell–Boltzmann.
+    kGrisClaro,
+    kNumColores = 16
+};
+
+/**
+ * @brief Paleta RGB (0xRRGGBB) de 16 entradas; las no usadas son negras.
+ */
+inline const std::vector<uint32_t> &paletaRender() {
+    static const std::vector<uint32_t> p = {0xffffff, 0x000000, 0x333333, 0x9400d3, 0x1f77b4, 0xd62728,
+                                            0xdddddd, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+    return p;
+}
+
+/**
+ * @class Lienzo
+ * @brief Imagen de ancho × alto índices de color, fila 0 arriba.
+ */
+class Lienzo {
+private:
+    int ancho = 0, alto = 0;
+    std::vector<uint8_t> px;
+    double radioTramos = -1;     ///< Radio de los tramos precalculados.
+    std::vector<int> tramos;     ///< Medio ancho de cada fila del disco.
+
+    /// Fuente de 3×5 píxeles: 5 filas de 3 bits por carácter.
+    static const uint8_t *glifo(char c) {
+        static const uint8_t digitos[10][5] = {
+            {7, 5, 5, 5, 7}, {2, 6, 2, 2, 7}, {7, 1, 7, 4, 7}, {7, 1, 7, 1, 7}, {5, 5, 7, 1, 1},
+            {7, 4, 7, 1, 7}, {7, 4, 7, 5, 7}, {7, 1, 1, 1, 1}, {7, 5, 7, 5, 7}, {7, 5, 7, 1, 7}};
+        static const uint8_t punto[5] = {0, 0, 0, 0, 2}, menos[5] = {0, 0, 7, 0, 0},
+                             igual[5] = {0, 7, 0, 7, 0}, mas[5] = {0, 2, 7, 2, 0},
+                             t[5] = {2, 7, 2, 2, 3}, P[5] = {6, 5, 6, 4, 4}, E[5] = {7, 4, 6, 4, 7},
+                             N[5] = {5, 7, 7, 5, 5}, k[5] = {4, 5, 6, 5, 5}, T[5] = {7, 2, 2, 2, 2},
+                             vacio[5] = {0, 0, 0, 0, 0};
+        if (c >= '0' && c <= '9') return digitos[c - '0'];
+        switch (c) {
+            case '.': return punto;
+            case '-': return menos;
+            case '=': return igual;
+            case '+': return mas;
+            case 't': return t;
+            case 'P': return P;
+            case 'E': return E;
+            case 'N': return N;
+            case 'k': return k;
+            case 'T': return T;
+            default: return vacio;
+        }
+    }
+
+public:
+    /**
+     * @brief Define el tamaño de la imagen (se borra en blanco).
+     */
+    void inicio(int w, int h) {
+        ancho = w;
+        alto = h;
+        px.assign(static_cast<size_t>(w) * h, kBlanco);
+    }
+
+    int Getancho() const { return ancho; }
+    int Getalto() const { return alto; }
+    const uint8_t *datos() const { return px.data(); }
+
+    void limpiar(uint8_t c) { std::fill(px.begin(), px.end(), c); }
+
+    void punto(int x, int y, uint8_t c) {
+        if (x >= 0 && x < ancho && y >= 0 && y < alto) px[static_cast<size_t>(y) * ancho + x] = c;
+    }
+
+    /**
+     * @brief Rellena el rectángulo [x0, x1) × [y0, y1), recortado a la imagen.
+     */
+    void rectangulo(int x0, int y0, int x1, int y1, uint8_t c) {
+        x0 = std::max(x0, 0);
+        y0 = std::max(y0, 0);
+        x1 = std::min(x1, ancho);
+        y1 = std::min(y1, alto);
+        for (int y = y0; y < y1; y++) {
+            std::fill(px.begin() + static_cast<size_t>(y) * ancho + x0,
+                      px.begin() + static_cast<size_t>(y) * ancho + std::max(x0, x1), c);
+        }
+    }
+
+    /**
+     * @brief Disco de radio @p r (en píxeles) centrado en (cx, cy).
+     *
+     * Los tramos de cada fila se calculan una vez por radio; pintar un disco
+     * es copiar 2r+1 tramos.
+     */
+    void disco(double cx, double cy, double r, uint8_t c) {
+        if (r != radioTramos) {
+            radioTramos = r;
+            int ri = static_cast<int>(r);
+            tramos.resize(2 * ri + 1);
+            for (int dy = -ri; dy <= ri; dy++) {
+                tramos[dy + ri] = static_cast<int>(std::sqrt(std::max(0.0, r * r - dy * dy)));
+            }
+        }
+        int ri = static_cast<int>(tramos.size() / 2);
+        int x = static_cast<int>(std::lround(cx));
+        int y = static_cast<int>(std::lround(cy));
+        for (int dy = -ri; dy <= ri; dy++) {
+            int w = tramos[dy + ri];
+            int fila = y + dy;
+            if (fila < 0 || fila >= alto) continue;
+            int a = std::max(x - w, 0), b = std::min(x + w + 1, ancho);
+            if (a < b) std::fill(px.begin() + static_cast<size_t>(fila) * ancho + a,
+                                 px.begin() + static_cast<size_t>(fila) * ancho + b, c);
+        }
+    }
+
+    /**
+     * @brief Segmento de (x0, y0) a (x1, y1) con grosor @p g píxeles (Bresenham).
+     */
+    void linea(int x0, int y0, int x1, int y1, uint8_t c, int g = 1) {
+        int dx = std::abs(x1 - x0), dy = -std::abs(y1 - y0);
+        int sx = x0 < x1 ? 1 : -1, sy = y0 < y1 ? 1 : -1;
+        int err = dx + dy;
+        while (true) {
+            rectangulo(x0 - g / 2, y0 - g / 2, x0 - g / 2 + g, y0 - g / 2 + g, c);
+            if (x0 == x1 && y0 == y1) break;
+            int e2 = 2 * err;
+            if (e2 >= dy) {
+                err += dy;
+                x0 += sx;
+            }
+            if (e2 <= dx) {
+                err += dx;
+                y0 += sy;
+            }
+        }
+    }
+
+    /**
+     * @brief Escribe @p s con la fuente de 3×5 ampliada @p escala veces.
+     *
+     * Sólo hay dígitos, '.', '-', '=', '+' y las letras t, P, E, N, k, T; el
+     * resto se deja en blanco.
+     */
+    void texto(int x, int y, const char *s, uint8_t c, int escala = 2) {
+        for (; *s; s++, x += 4 * escala) {
+            const uint8_t *g = glifo(*s);
+            for (int f = 0; f < 5; f++) {
+                for (int b = 0; b < 3; b++) {
+                    if (g[f] & (4 >> b)) {
+                        rectangulo(x + b * escala, y + f * escala, x + (b + 1) * escala, y + (f + 1) * escala, c);
+                    }
+                }
+            }
+        }
+    }
+};
+
+#endif  // LIENZO_HPP
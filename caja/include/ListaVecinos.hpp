@@ -0,0 +1,178 @@
+/**
+ * @file ListaVecinos.hpp
+ * @brief Listas de vecinos de Verlet con piel (skin) sobre la rejilla de celdas.
+ *
+ * En cada paso una esfera se mueve sólo v·dt, así que los pares candidatos
+ * cambian poco entre pasos. La lista guarda todos los pares a distancia menor
+ * que 2R + piel y sólo se reconstruye cuando alguna esfera se ha desplazado
+ * más de piel/2 desde la última construcción: mientras eso no pase, ningún
+ * par fuera de la lista puede estar en contacto.
+ *
+ * @authors
+ * - Santiago Suárez
+ * - Eric Arciniegas
+ */
+
+#ifndef LISTA_VECINOS_HPP
+#define LISTA_VECINOS_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "Esfera.hpp"
+#include "MallaCeldas.hpp"
+#include "SistemaParticulas.hpp"
+
+/**
+ * @class ListaVecinos
+ * @brief Lista de pares candidatos que se reconstruye de forma automática.
+ */
+class ListaVecinos {
+private:
+    MallaCeldas malla;            ///< Rejilla con celdas de lado >= 2R + piel.
+    double piel;                  ///< Margen extra sobre el contacto.
+    double corte2;                ///< (2·Rmax + piel)².
+    std::vector<int> pi, pj;      ///< Pares candidatos (pi[k] < pj[k]).
+    std::vector<double> x0, y0;   ///< Posiciones en la última construcción.
+    long reconstrucciones = 0;    ///< Veces que se ha reconstruido la lista.
+    long actualizaciones = 0;     ///< Veces que se ha llamado a actualizar().
+
+    /**
+     * @brief Construye la lista desde cero con la rejilla de celdas.
+     */
+    void construir(const SistemaParticulas &sis) {
+        int n = sis.size();
+        const double *x = sis.datosX();
+        const double *y = sis.datosY();
+        malla.construir(sis);
+        pi.clear();
+        pj.clear();
+        malla.recorrerPares([&](int i, int j) {
+            double dx = x[j] - x[i];
+            double dy = y[j] - y[i];
+            if (dx * dx + dy * dy < corte2) {
+                pi.push_back(i);
+                pj.push_back(j);
+            }
+        });
+        x0.assign(x, x + n);
+        y0.assign(y, y + n);
+        reconstrucciones++;
+    }
+
+    /**
+     * @brief Desplazamiento máximo al cuadrado desde la última construcción.
+     */
+    double desplazamientoMax2(const SistemaParticulas &sis) const {
+        const double *x = sis.datosX();
+        const double *y = sis.datosY();
+        double d2max = 0;
+        for (int i = 0; i < sis.size(); i++) {
+            double dx = x[i] - x0[i];
+            double dy = y[i] - y0[i];
+            d2max = std::max(d2max, dx * dx + dy * dy);
+        }
+        return d2max;
+    }
+
+public:
+    /**
+     * @brief Define la rejilla y la piel.
+     * @param caja Caja de la simulación.
+     * @param Rmax Radio máximo de las esferas.
+     * @param piel_ Margen extra sobre la distancia de contacto.
+     */
+    void inicio(const Cajas &caja, double Rmax, double piel_) {
+        piel = piel_;
+        corte2 = (2 * Rmax + piel) * (2 * Rmax + piel);
+        malla.inicio(caja, Rmax + piel / 2);
+        pi.clear();
+        pj.clear();
+        x0.clear();
+        y0.clear();
+        reconstrucciones = 0;
+        actualizaciones = 0;
+    }
+
+    /**
+     * @brief Reconstruye la lista si alguna esfera se movió más de piel/2.
+     * @param sis Partículas.
+     * @return true si hubo reconstrucción.
+     */
+    bool actualizar(const SistemaParticulas &sis) {
+        actualizaciones++;
+        if (static_cast<int>(x0.size()) != sis.size() ||
+            4 * desplazamientoMax2(sis) > piel * piel) {
+            construir(sis);
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Fuerza una reconstrucción en la siguiente actualización.
+     *
+     * Necesario si las partículas se reordenan o se mueven fuera del paso normal.
+     */
+    void invalidar() { x0.clear(); }
+
+    /**
+     * @brief Corrige los índices tras reordenar las partículas.
+     *
+     * La lista sigue siendo válida (las posiciones no cambiaron), sólo se
+     * renombran los índices y se ordenan los pares para recorrerlos en el
+     * nuevo orden de memoria.
+     *
+     * @param nueva nueva[i] es la ranura nueva de la partícula que estaba en i.
+     */
+    void permutar(const std::vector<int> &nueva) {
+        if (x0.size() != nueva.size()) {
+            invalidar();
+            return;
+        }
+        std::vector<uint64_t> pares(pi.size());
+        for (size_t k = 0; k < pi.size(); k++) {
+            uint32_t a = nueva[pi[k]], b = nueva[pj[k]];
+            if (a > b) std::swap(a, b);
+            pares[k] = (static_cast<uint64_t>(a) << 32) | b;
+        }
+        std::sort(pares.begin(), pares.end());
+        for (size_t k = 0; k < pares.size(); k++) {
+            pi[k] = static_cast<int>(pares[k] >> 32);
+            pj[k] = static_cast<int>(pares[k] & 0xFFFFFFFFu);
+        }
+        std::vector<double> tx(x0.size()), ty(y0.size());
+        for (size_t i = 0; i < x0.size(); i++) {
+            tx[nueva[i]] = x0[i];
+            ty[nueva[i]] = y0[i];
+        }
+        x0.swap(tx);
+        y0.swap(ty);
+    }
+
+    /**
+     * @brief Recorre los pares candidatos de la lista.
+     * @param f Función a evaluar sobre cada par (i < j).
+     */
+    template <typename F>
+    void recorrerPares(F &&f) const {
+        for (size_t k = 0; k < pi.size(); k++) f(pi[k], pj[k]);
+    }
+
+    /**
+     * @brief Devuelve el número de reconstrucciones.
+     */
+    long Getreconstrucciones() const { return reconstrucciones; }
+
+    /**
+     * @brief Devuelve el número de actualizaciones (pasos).
+     */
+    long Getactualizaciones() const { return actualizaciones; }
+
+    /**
+     * @brief Devuelve el número de pares en la lista.
+     */
+    long Getpares() const { return static_cast<long>(pi.size()); }
+};
+
+#endif  // LISTA_VECINOS_HPP
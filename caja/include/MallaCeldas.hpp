@@ -0,0 +1,322 @@
+/**
+ * @file MallaCeldas.hpp
+ * @brief Rejilla uniforme (cell list) para la detección de colisiones entre esferas.
+ *
+ * La caja se divide en celdas cuadradas (cúbicas en 3D) de lado mayor o igual
+ * a 2R, de modo que dos esferas sólo pueden tocarse si están en la misma celda
+ * o en celdas vecinas. Así el costo de cada paso pasa de O(n²) a O(n).
+ *
+ * @authors
+ * - Santiago Suárez
+ * - Eric Arciniegas
+ */
+
+#ifndef MALLA_CELDAS_HPP
+#define MALLA_CELDAS_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <type_traits>
+#include <vector>
+#include "Esfera.hpp"
+#include "FisicaComun.hpp"
+#include "PoolHilos.hpp"
+#include "SistemaParticulas.hpp"
+
+/**
+ * @class MallaCeldasT
+ * @brief Fase amplia (broadphase) de colisiones basada en una rejilla uniforme.
+ *
+ * Las esferas se ordenan por celda con un conteo (counting sort), de forma que
+ * los índices de cada celda quedan contiguos en memoria y en orden creciente.
+ * Las celdas se numeran con X como eje más rápido (c = cy·nx + cx en 2D).
+ *
+ * @tparam Dim Número de dimensiones (2 o 3). El recorrido en paralelo por
+ * colores sólo existe en 2D.
+ */
+template <int Dim>
+class MallaCeldasT {
+    static_assert(Dim == 2 || Dim == 3, "La rejilla debe ser 2D o 3D");
+
+private:
+    std::array<double, Dim> minimo;  ///< Esquina inferior de la caja.
+    std::array<double, Dim> lado;    ///< Tamaño de cada celda (>= 2R).
+    std::array<int, Dim> nceldas;    ///< Número de celdas por eje.
+    int total = 0;                ///< Número total de celdas.
+    std::vector<int> comienzo;    ///< Posición de inicio de cada celda en @c indices.
+    std::vector<int> indices;     ///< Índices de las esferas ordenados por celda.
+    std::vector<int> celdaDe;     ///< Celda asignada a cada esfera.
+
+    /// Recorre los pares de la celda @p c con los de la celda vecina @p v.
+    template <typename F>
+    void recorrerVecina(int c, int v, F &&f) const {
+        for (int a = comienzo[c]; a < comienzo[c + 1]; a++) {
+            for (int b = comienzo[v]; b < comienzo[v + 1]; b++) {
+                int i = indices[a];
+                int j = indices[b];
+                if (i < j) f(i, j);
+                else f(j, i);
+            }
+        }
+    }
+
+    /// Recorre los pares internos de la celda @p c.
+    template <typename F>
+    void recorrerInternos(int c, F &&f) const {
+        for (int a = comienzo[c]; a < comienzo[c + 1]; a++) {
+            for (int b = a + 1; b < comienzo[c + 1]; b++) {
+                f(indices[a], indices[b]);
+            }
+        }
+    }
+
+public:
+    /**
+     * @brief Devuelve el número de celdas en X.
+     */
+    int Getnx() const { return nceldas[0]; }
+
+    /**
+     * @brief Devuelve el número de celdas en Y.
+     */
+    int Getny() const { return nceldas[1]; }
+
+    /**
+     * @brief Devuelve el número de celdas en el eje @p d.
+     */
+    int Getceldas(int d) const { return nceldas[d]; }
+
+    /**
+     * @brief Devuelve la esquina inferior de la rejilla en X.
+     */
+    double Getxmin() const { return minimo[0]; }
+
+    /**
+     * @brief Devuelve la esquina inferior de la rejilla en Y.
+     */
+    double Getymin() const { return minimo[1]; }
+
+    /**
+     * @brief Devuelve el tamaño de cada celda en X.
+     */
+    double Getladox() const { return lado[0]; }
+
+    /**
+     * @brief Devuelve el tamaño de cada celda en Y.
+     */
+    double Getladoy() const { return lado[1]; }
+
+    /**
+     * @brief Define la rejilla a partir de los límites de la caja.
+     * @param caja Caja de la simulación.
+     * @param Rmax Radio máximo de las esferas; las celdas miden al menos 2·Rmax.
+     */
+    template <typename T>
+    void inicio(const CajasT<T, Dim> &caja, double Rmax) {
+        double d = 2.0 * Rmax;
+        total = 1;
+        for (int k = 0; k < Dim; k++) {
+            minimo[k] = caja.Getmin(k);
+            double L = caja.Getmax(k) - caja.Getmin(k);
+            nceldas[k] = std::max(1, static_cast<int>(std::floor(L / d)));
+            lado[k] = L / nceldas[k];
+            total *= nceldas[k];
+        }
+        comienzo.assign(total + 1, 0);
+    }
+
+    /**
+     * @brief Calcula la celda que contiene el punto (x, y) (2D).
+     *
+     * Las esferas que se salen ligeramente de la caja se asignan a la celda
+     * del borde más cercana.
+     */
+    template <int D = Dim, std::enable_if_t<(D == 2), int> = 0>
+    int celda(double x, double y) const {
+        return fisica::celda(x, y, minimo[0], minimo[1], lado[0], lado[1], nceldas[0], nceldas[1]);
+    }
+
+    /**
+     * @brief Calcula la celda que contiene el punto @p p, en cualquier dimensión.
+     */
+    int celda(const std::array<double, Dim> &p) const {
+        if constexpr (Dim == 2) {
+            return celda(p[0], p[1]);
+        } else {
+            int c = 0;
+            for (int k = Dim - 1; k >= 0; k--) {
+                int ck = static_cast<int>((p[k] - minimo[k]) / lado[k]);
+                ck = ck < 0 ? 0 : (ck > nceldas[k] - 1 ? nceldas[k] - 1 : ck);
+                c = c * nceldas[k] + ck;
+            }
+            return c;
+        }
+    }
+
+    /**
+     * @brief Reparte las esferas en las celdas dada la celda de cada una.
+     * @param n Número de esferas.
+     * @param celdaDeEsfera Función int(i) con la celda de la esfera @p i.
+     */
+    template <typename F>
+    void construirCon(int n, F &&celdaDeEsfera) {
+        celdaDe.resize(n);
+        indices.resize(n);
+        std::fill(comienzo.begin(), comienzo.end(), 0);
+
+        for (int i = 0; i < n; i++) {
+            celdaDe[i] = celdaDeEsfera(i);
+            comienzo[celdaDe[i] + 1]++;
+        }
+        for (int c = 0; c < total; c++) {
+            comienzo[c + 1] += comienzo[c];
+        }
+        std::vector<int> llenado(comienzo.begin(), comienzo.end() - 1);
+        for (int i = 0; i < n; i++) {
+            indices[llenado[celdaDe[i]]++] = i;
+        }
+    }
+
+    /**
+     * @brief Reparte las esferas en las celdas según su posición actual (2D).
+     * @param x Posiciones en X.
+     * @param y Posiciones en Y.
+     * @param n Número de esferas.
+     */
+    template <int D = Dim, std::enable_if_t<(D == 2), int> = 0>
+    void construir(const double *x, const double *y, int n) {
+        construirCon(n, [&](int i) { return celda(x[i], y[i]); });
+    }
+
+    /**
+     * @brief Reparte en las celdas las partículas de un sistema SoA.
+     */
+    template <typename T>
+    void construir(const SistemaParticulasT<T, Dim> &sis) {
+        if constexpr (Dim == 2 && std::is_same<T, double>::value) {
+            construir(sis.datosX(), sis.datosY(), sis.size());
+        } else {
+            construirCon(sis.size(), [&](int i) {
+                std::array<double, Dim> p;
+                for (int k = 0; k < Dim; k++) p[k] = sis.Getpos(i, k);
+                return celda(p);
+            });
+        }
+    }
+
+    /**
+     * @brief Recorre los pares que le corresponden a la celda (cx, cy) (2D).
+     *
+     * Son los pares internos de la celda y los pares con cuatro vecinas
+     * "hacia adelante" (derecha y fila superior), de modo que al recorrer
+     * todas las celdas se cubren los ocho vecinos sin repetir pares. Se
+     * llama @p f(i, j) con i < j.
+     */
+    template <typename F, int D = Dim, std::enable_if_t<(D == 2), int> = 0>
+    void recorrerParesCelda(int cx, int cy, F &&f) const {
+        static const int vecinos[4][2] = {{1, 0}, {-1, 1}, {0, 1}, {1, 1}};
+        const int nx = nceldas[0], ny = nceldas[1];
+        int c = cy * nx + cx;
+        recorrerInternos(c, f);
+        for (const auto &v : vecinos) {
+            int vx = cx + v[0];
+            int vy = cy + v[1];
+            if (vx < 0 || vx >= nx || vy >= ny) continue;
+            recorrerVecina(c, vy * nx + vx, f);
+        }
+    }
+
+    /**
+     * @brief Recorre los pares que le corresponden a la celda (cx, cy, cz) (3D).
+     *
+     * Igual que en 2D, con las trece vecinas "hacia adelante" de las 26.
+     */
+    template <typename F, int D = Dim, std::enable_if_t<(D == 3), int> = 0>
+    void recorrerParesCelda(int cx, int cy, int cz, F &&f) const {
+        static const int vecinos[13][3] = {
+            {1, 0, 0},  {-1, 1, 0},  {0, 1, 0},  {1, 1, 0},
+            {-1, -1, 1}, {0, -1, 1}, {1, -1, 1}, {-1, 0, 1}, {0, 0, 1},
+            {1, 0, 1},  {-1, 1, 1},  {0, 1, 1},  {1, 1, 1}};
+        const int nx = nceldas[0], ny = nceldas[1], nz = nceldas[2];
+        int c = (cz * ny + cy) * nx + cx;
+        recorrerInternos(c, f);
+        for (const auto &v : vecinos) {
+            int vx = cx + v[0];
+            int vy = cy + v[1];
+            int vz = cz + v[2];
+            if (vx < 0 || vx >= nx || vy < 0 || vy >= ny || vz >= nz) continue;
+            recorrerVecina(c, (vz * ny + vy) * nx + vx, f);
+        }
+    }
+
+    /**
+     * @brief Recorre una sola vez cada par de esferas en celdas vecinas.
+     * @param f Función a evaluar sobre cada par candidato.
+     */
+    template <typename F>
+    void recorrerPares(F &&f) const {
+        if constexpr (Dim == 2) {
+            for (int cy = 0; cy < nceldas[1]; cy++) {
+                for (int cx = 0; cx < nceldas[0]; cx++) {
+                    recorrerParesCelda(cx, cy, f);
+                }
+            }
+        } else {
+            for (int cz = 0; cz < nceldas[2]; cz++) {
+                for (int cy = 0; cy < nceldas[1]; cy++) {
+                    for (int cx = 0; cx < nceldas[0]; cx++) {
+                        recorrerParesCelda(cx, cy, cz, f);
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Recorre los pares en paralelo con un calendario de 9 colores (2D).
+     *
+     * Una celda sólo toca esferas de las columnas cx-1..cx+1 y de las filas
+     * cy, cy+1, así que dos celdas con el mismo (cx mod 3, cy mod 3) nunca
+     * comparten esferas y se pueden procesar a la vez. Los colores se
+     * recorren siempre en el mismo orden, por lo que el resultado es
+     * idéntico bit a bit con cualquier número de hilos.
+     *
+     * @param pool Hilos que reparten las celdas de cada color.
+     * @param f Función a evaluar sobre cada par candidato.
+     */
+    template <typename F, int D = Dim, std::enable_if_t<(D == 2), int> = 0>
+    void recorrerParesColoreado(PoolHilos &pool, F &&f) const {
+        recorrerParesColoreadoCelda(pool, [&](int, int i, int j) { f(i, j); });
+    }
+
+    /**
+     * @brief Igual que recorrerParesColoreado(), pero @p f recibe también la celda.
+     *
+     * Se llama @p f(c, i, j) con c = cy·nx + cx. Como cada celda la procesa
+     * un solo hilo, @p c sirve para indexar acumuladores por celda sin
+     * sincronización.
+     */
+    template <typename F, int D = Dim, std::enable_if_t<(D == 2), int> = 0>
+    void recorrerParesColoreadoCelda(PoolHilos &pool, F &&f) const {
+        const int nx = nceldas[0], ny = nceldas[1];
+        for (int color = 0; color < 9; color++) {
+            int ox = color % 3;
+            int oy = color / 3;
+            int mx = (nx - ox + 2) / 3;  // celdas de este color por fila
+            int my = (ny - oy + 2) / 3;
+            if (mx <= 0 || my <= 0) continue;
+            pool.paraCada(mx * my, [&](int k) {
+                int cx = ox + 3 * (k % mx);
+                int cy = oy + 3 * (k / mx);
+                int c = cy * nx + cx;
+                recorrerParesCelda(cx, cy, [&](int i, int j) { f(c, i, j); });
+            }, 16);
+        }
+    }
+};
+
+/// Rejilla original en 2D.
+using MallaCeldas = MallaCeldasT<2>;
+
+#endif  // MALLA_CELDAS_HPP
@@ -0,0 +1,426 @@
+/**
+ * @file MotorEventos.hpp
+ * @brief Motor de dinámica dirigida por eventos para esferas duras.
+ *
+ * En lugar de avanzar con un paso fijo y buscar solapamientos, se calculan los
+ * tiempos exactos de choque esfera–esfera y esfera–pared, se guardan en una
+ * cola de prioridad y la simulación salta directamente al siguiente evento.
+ * Los eventos que quedan obsoletos (porque alguna de las esferas chocó antes)
+ * se descartan al sacarlos de la cola comparando contadores de colisiones.
+ *
+ * Para no comparar cada esfera con todas las demás se usa una rejilla de
+ * celdas de lado >= 2R, con eventos de cruce de celda.
+ *
+ * @authors
+ * - Santiago Suárez
+ * - Eric Arciniegas
+ */
+
+#ifndef MOTOR_EVENTOS_HPP
+#define MOTOR_EVENTOS_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+#include <vector>
+#include "Esfera.hpp"
+#include "Instrumentacion.hpp"
+#include "Observables.hpp"
+#include "SistemaParticulas.hpp"
+
+/**
+ * @class MotorEventos
+ * @brief Simulación exacta de esferas duras avanzando de evento en evento.
+ *
+ * Cada esfera guarda su estado en el instante de su último evento
+ * (@c tpropio); la posición en cualquier otro instante se obtiene por
+ * extrapolación lineal, así que un evento sólo toca una o dos esferas.
+ */
+class MotorEventos {
+private:
+    /// Tipos de evento distintos de un choque entre dos esferas (j < 0).
+    enum { kParedX = -1, kParedY = -2, kCruce = -3 };
+
+    /**
+     * @brief Evento pendiente en la cola.
+     *
+     * Para cruces de celda @c j vale kCruce - dir, con dir en {0: +x, 1: -x,
+     * 2: +y, 3: -y}.
+     */
+    struct Evento {
+        double t;     ///< Instante del evento.
+        int i, j;     ///< Esferas involucradas (j < 0 para paredes y cruces).
+        long ci, cj;  ///< Contadores de colisión al momento de predecir.
+        bool operator>(const Evento &o) const { return t > o.t; }
+    };
+
+    // --- Estado de las esferas ---
+    std::vector<double> x, y, vx, vy, m, R;
+    std::vector<double> tpropio;  ///< Instante en que (x, y) es válido.
+    std::vector<long> cuenta;     ///< Número de colisiones de cada esfera.
+    std::vector<int> celdaDe;     ///< Celda actual de cada esfera.
+
+    // --- Rejilla ---
+    double xmin, xmax, ymin, ymax;
+    double ladox, ladoy;
+    int nx, ny;
+    std::vector<std::vector<int>> celdas;
+
+    std::priority_queue<Evento, std::vector<Evento>, std::greater<Evento>> cola;
+    double tiempo;       ///< Tiempo actual de la simulación.
+    long nColisiones;    ///< Choques entre esferas procesados.
+    long nParedes;       ///< Choques con paredes procesados.
+    Observables *obs = nullptr;  ///< Observables que se corrigen con cada evento.
+
+    /**
+     * @brief Lleva la esfera @p i al instante @p t.
+     */
+    void avanzar(int i, double t) {
+        double dtl = t - tpropio[i];
+        x[i] += vx[i] * dtl;
+        y[i] += vy[i] * dtl;
+        tpropio[i] = t;
+    }
+
+    /**
+     * @brief Calcula el tiempo (relativo) hasta el choque entre @p i y @p j.
+     *
+     * Ambas esferas se suponen referidas al instante actual @c tiempo.
+     * @return Tiempo hasta el contacto, o infinito si no se acercan.
+     */
+    double tiempoChoque(int i, int j) const {
+        CAJA_CONTAR(instr::kParesProbados, 1);
+        double tj = tiempo - tpropio[j];
+        double ti = tiempo - tpropio[i];
+        double dx = (x[j] + vx[j] * tj) - (x[i] + vx[i] * ti);
+        double dy = (y[j] + vy[j] * tj) - (y[i] + vy[i] * ti);
+        double dvx = vx[j] - vx[i];
+        double dvy = vy[j] - vy[i];
+        double b = dx * dvx + dy * dvy;
+        if (b >= 0) return std::numeric_limits<double>::infinity();
+        double dv2 = dvx * dvx + dvy * dvy;
+        double s = R[i] + R[j];
+        double dr2 = dx * dx + dy * dy - s * s;
+        if (dr2 <= 0) return 0.0;  // ya en contacto y acercándose
+        double d = b * b - dv2 * dr2;
+        if (d < 0) return std::numeric_limits<double>::infinity();
+        return dr2 / (-b + std::sqrt(d));  // forma estable de -(b + √d)/dv2
+    }
+
+    /**
+     * @brief Predice los choques de @p i con las esferas de la celda @p c.
+     */
+    void predecirConCelda(int i, int c) {
+        for (int j : celdas[c]) {
+            if (j == i) continue;
+            double dtc = tiempoChoque(i, j);
+            if (std::isfinite(dtc)) {
+                cola.push({tiempo + dtc, i, j, cuenta[i], cuenta[j]});
+            }
+        }
+    }
+
+    /**
+     * @brief Predice los choques contra las paredes y el próximo cruce de celda.
+     */
+    void predecirParedesYCruce(int i) {
+        if (vx[i] > 0) cola.push({tiempo + std::max(0.0, (xmax - R[i] - x[i]) / vx[i]), i, kParedX, cuenta[i], 0});
+        if (vx[i] < 0) cola.push({tiempo + std::max(0.0, (xmin + R[i] - x[i]) / vx[i]), i, kParedX, cuenta[i], 0});
+        if (vy[i] > 0) cola.push({tiempo + std::max(0.0, (ymax - R[i] - y[i]) / vy[i]), i, kParedY, cuenta[i], 0});
+        if (vy[i] < 0) cola.push({tiempo + std::max(0.0, (ymin + R[i] - y[i]) / vy[i]), i, kParedY, cuenta[i], 0});
+
+        int cx = celdaDe[i] % nx;
+        int cy = celdaDe[i] / nx;
+        double tmin = std::numeric_limits<double>::infinity();
+        int dir = -1;
+        if (vx[i] > 0 && cx + 1 < nx) { tmin = (xmin + (cx + 1) * ladox - x[i]) / vx[i]; dir = 0; }
+        if (vx[i] < 0 && cx > 0) { tmin = (xmin + cx * ladox - x[i]) / vx[i]; dir = 1; }
+        if (vy[i] > 0 && cy + 1 < ny) {
+            double t = (ymin + (cy + 1) * ladoy - y[i]) / vy[i];
+            if (t < tmin) { tmin = t; dir = 2; }
+        }
+        if (vy[i] < 0 && cy > 0) {
+            double t = (ymin + cy * ladoy - y[i]) / vy[i];
+            if (t < tmin) { tmin = t; dir = 3; }
+        }
+        if (dir >= 0) cola.push({tiempo + std::max(0.0, tmin), i, kCruce - dir, cuenta[i], 0});
+    }
+
+    /**
+     * @brief Predice todos los eventos futuros de la esfera @p i.
+     */
+    void predecir(int i) {
+        predecirParedesYCruce(i);
+        int cx = celdaDe[i] % nx;
+        int cy = celdaDe[i] / nx;
+        for (int b = std::max(cy - 1, 0); b <= std::min(cy + 1, ny - 1); b++) {
+            for (int a = std::max(cx - 1, 0); a <= std::min(cx + 1, nx - 1); a++) {
+                predecirConCelda(i, b * nx + a);
+            }
+        }
+    }
+
+    /**
+     * @brief Saca a la esfera @p i de su celda (borrado por intercambio).
+     */
+    void quitarDeCelda(int i) {
+        auto &lista = celdas[celdaDe[i]];
+        auto it = std::find(lista.begin(), lista.end(), i);
+        *it = lista.back();
+        lista.pop_back();
+    }
+
+    /**
+     * @brief Procesa el cruce de la esfera @p i hacia la celda vecina en @p dir.
+     *
+     * Sólo se predicen choques con la fila o columna de celdas que entra en
+     * la vecindad; los eventos ya previstos siguen siendo válidos.
+     */
+    void cruzarCelda(int i, int dir) {
+        avanzar(i, tiempo);
+        quitarDeCelda(i);
+        int cx = celdaDe[i] % nx;
+        int cy = celdaDe[i] / nx;
+        int dx = (dir == 0) - (dir == 1);
+        int dy = (dir == 2) - (dir == 3);
+        cx += dx;
+        cy += dy;
+        celdaDe[i] = cy * nx + cx;
+        celdas[celdaDe[i]].push_back(i);
+
+        predecirParedesYCruce(i);
+        if (dx != 0) {
+            int a = cx + dx;
+            if (a >= 0 && a < nx) {
+                for (int b = std::max(cy - 1, 0); b <= std::min(cy + 1, ny - 1); b++) {
+                    predecirConCelda(i, b * nx + a);
+                }
+            }
+        } else {
+            int b = cy + dy;
+            if (b >= 0 && b < ny) {
+                for (int a = std::max(cx - 1, 0); a <= std::min(cx + 1, nx - 1); a++) {
+                    predecirConCelda(i, b * nx + a);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Resuelve el choque elástico entre @p i y @p j en el instante actual.
+     *
+     * Usa el mismo modelo que Esfera::colision: se intercambian las
+     * componentes normales de la velocidad.
+     */
+    void resolverChoque(int i, int j) {
+        avanzar(i, tiempo);
+        avanzar(j, tiempo);
+        double dx = x[j] - x[i];
+        double dy = y[j] - y[i];
+        double dist = std::sqrt(dx * dx + dy * dy);
+        if (dist == 0) return;
+        double nxn = dx / dist;
+        double nyn = dy / dist;
+        double vn1 = vx[i] * nxn + vy[i] * nyn;
+        double vn2 = vx[j] * nxn + vy[j] * nyn;
+        DeltaObservables d;
+        if (obs) {
+            d.dK = -0.5 * (m[i] * (vx[i] * vx[i] + vy[i] * vy[i]) + m[j] * (vx[j] * vx[j] + vy[j] * vy[j]));
+            d.dPx = -(m[i] * vx[i] + m[j] * vx[j]);
+            d.dPy = -(m[i] * vy[i] + m[j] * vy[j]);
+        }
+        vx[i] += (vn2 - vn1) * nxn;
+        vy[i] += (vn2 - vn1) * nyn;
+        vx[j] += (vn1 - vn2) * nxn;
+        vy[j] += (vn1 - vn2) * nyn;
+        if (obs) {
+            d.dK += 0.5 * (m[i] * (vx[i] * vx[i] + vy[i] * vy[i]) + m[j] * (vx[j] * vx[j] + vy[j] * vy[j]));
+            d.dPx += m[i] * vx[i] + m[j] * vx[j];
+            d.dPy += m[i] * vy[i] + m[j] * vy[j];
+            d.eventos = 1;
+            obs->colision(d);
+        }
+        cuenta[i]++;
+        cuenta[j]++;
+        nColisiones++;
+        CAJA_CONTAR(instr::kColisionesResueltas, 1);
+    }
+
+    /**
+     * @brief Resuelve el choque de la esfera @p i con una pared.
+     */
+    void resolverPared(int i, int pared, Cajas &caja) {
+        avanzar(i, tiempo);
+        double vn;
+        if (pared == kParedX) {
+            x[i] = std::min(std::max(x[i], xmin + R[i]), xmax - R[i]);
+            vx[i] = -vx[i];
+            vn = vx[i];
+        } else {
+            y[i] = std::min(std::max(y[i], ymin + R[i]), ymax - R[i]);
+            vy[i] = -vy[i];
+            vn = vy[i];
+        }
+        caja.calcularPresionN(m[i] * (vx[i] * vx[i] + vy[i] * vy[i]));
+        caja.registrarImpulso(2 * m[i] * std::fabs(vn));
+        if (obs) {
+            if (pared == kParedX) obs->paredes(2 * m[i] * vn, 0, 1);
+            else obs->paredes(0, 2 * m[i] * vn, 1);
+        }
+        cuenta[i]++;
+        nParedes++;
+        CAJA_CONTAR(instr::kChoquesPared, 1);
+    }
+
+    /**
+     * @brief Vacía la cola y vuelve a predecir todos los eventos.
+     *
+     * Se usa al inicio y cuando la cola acumula demasiados eventos obsoletos.
+     */
+    void reconstruirCola() {
+        cola = decltype(cola)();
+        int n = static_cast<int>(x.size());
+        for (int i = 0; i < n; i++) avanzar(i, tiempo);
+        for (int i = 0; i < n; i++) {
+            predecirParedesYCruce(i);
+            int cx = celdaDe[i] % nx;
+            int cy = celdaDe[i] / nx;
+            // Cada par se predice una sola vez: sólo j > i.
+            for (int b = std::max(cy - 1, 0); b <= std::min(cy + 1, ny - 1); b++) {
+                for (int a = std::max(cx - 1, 0); a <= std::min(cx + 1, nx - 1); a++) {
+                    for (int j : celdas[b * nx + a]) {
+                        if (j <= i) continue;
+                        double dtc = tiempoChoque(i, j);
+                        if (std::isfinite(dtc)) cola.push({tiempo + dtc, i, j, cuenta[i], cuenta[j]});
+                    }
+                }
+            }
+        }
+    }
+
+public:
+    /**
+     * @brief Devuelve el tiempo actual de la simulación.
+     */
+    double Gettiempo() const { return tiempo; }
+
+    /**
+     * @brief Devuelve el número de choques entre esferas procesados.
+     */
+    long GetnColisiones() const { return nColisiones; }
+
+    /**
+     * @brief Devuelve el número de choques con las paredes procesados.
+     */
+    long GetnParedes() const { return nParedes; }
+
+    /**
+     * @brief Conecta unos observables que se corrigen con cada evento.
+     *
+     * Debe llamarse después de inicio(); se sincronizan una vez con la
+     * energía y el momento actuales.
+     */
+    void conectar(Observables *o) {
+        obs = o;
+        if (!obs) return;
+        double K = 0, Px = 0, Py = 0;
+        for (size_t i = 0; i < x.size(); i++) {
+            K += 0.5 * m[i] * (vx[i] * vx[i] + vy[i] * vy[i]);
+            Px += m[i] * vx[i];
+            Py += m[i] * vy[i];
+        }
+        obs->fijar(K, Px, Py);
+    }
+
+    /**
+     * @brief Copia el estado de las esferas y prepara la cola de eventos.
+     * @param caja Caja de la simulación.
+     * @param esferas Estado inicial (sin solapamientos).
+     */
+    void inicio(const Cajas &caja, const SistemaParticulas &esferas) {
+        xmin = caja.Getxmin();
+        xmax = caja.Getxmax();
+        ymin = caja.Getymin();
+        ymax = caja.Getymax();
+
+        int n = static_cast<int>(esferas.size());
+        x.resize(n); y.resize(n); vx.resize(n); vy.resize(n); m.resize(n); R.resize(n);
+        double Rmax = 0;
+        for (int i = 0; i < n; i++) {
+            x[i] = esferas.Getx(i);
+            y[i] = esferas.Gety(i);
+            vx[i] = esferas.Getvx(i);
+            vy[i] = esferas.Getvy(i);
+            m[i] = esferas.Getm(i);
+            R[i] = esferas.GetR(i);
+            Rmax = std::max(Rmax, R[i]);
+        }
+        tpropio.assign(n, 0.0);
+        cuenta.assign(n, 0);
+        tiempo = 0;
+        nColisiones = 0;
+        nParedes = 0;
+
+        nx = std::max(1, static_cast<int>(std::floor((xmax - xmin) / (2 * Rmax))));
+        ny = std::max(1, static_cast<int>(std::floor((ymax - ymin) / (2 * Rmax))));
+        ladox = (xmax - xmin) / nx;
+        ladoy = (ymax - ymin) / ny;
+        celdas.assign(nx * ny, {});
+        celdaDe.resize(n);
+        for (int i = 0; i < n; i++) {
+            int cx = std::min(std::max(static_cast<int>((x[i] - xmin) / ladox), 0), nx - 1);
+            int cy = std::min(std::max(static_cast<int>((y[i] - ymin) / ladoy), 0), ny - 1);
+            celdaDe[i] = cy * nx + cx;
+            celdas[celdaDe[i]].push_back(i);
+        }
+        reconstruirCola();
+    }
+
+    /**
+     * @brief Procesa todos los eventos hasta el instante @p tfinal.
+     *
+     * Los choques con las paredes se registran en @p caja como en
+     * Esfera::rebotePared, pero exactamente una vez por choque.
+     *
+     * @param tfinal Instante hasta el cual avanzar.
+     * @param caja Caja donde se acumula la presión.
+     */
+    void avanzarHasta(double tfinal, Cajas &caja) {
+        size_t limite = 16 * x.size() + 1024;
+        while (!cola.empty() && cola.top().t <= tfinal) {
+            Evento ev = cola.top();
+            cola.pop();
+            if (cuenta[ev.i] != ev.ci) continue;
+            if (ev.j >= 0 && cuenta[ev.j] != ev.cj) continue;
+
+            tiempo = ev.t;
+            if (ev.j >= 0) {
+                resolverChoque(ev.i, ev.j);
+                predecir(ev.i);
+                predecir(ev.j);
+            } else if (ev.j == kParedX || ev.j == kParedY) {
+                resolverPared(ev.i, ev.j, caja);
+                predecir(ev.i);
+            } else {
+                cruzarCelda(ev.i, kCruce - ev.j);
+            }
+
+            if (cola.size() > limite) reconstruirCola();
+        }
+        tiempo = tfinal;
+    }
+
+    /**
+     * @brief Escribe en @p esferas el estado en el instante actual.
+     * @param esferas Sistema que recibe posiciones y velocidades.
+     */
+    void volcar(SistemaParticulas &esferas) const {
+        for (int i = 0; i < static_cast<int>(x.size()); i++) {
+            double dtl = tiempo - tpropio[i];
+            esferas.fijar(i, x[i] + vx[i] * dtl, y[i] + vy[i] * dtl, vx[i], vy[i]);
+        }
+    }
+};
+
+#endif  // MOTOR_EVENTOS_HPP
@@ -0,0 +1,76 @@
+/**
+ * @file NucleosGpu.hpp
+ * @brief Interfaz de los núcleos CUDA de src/PasoGpu.cu.
+ *
+ * Sólo usa tipos simples para que nvcc no tenga que compilar el resto de los
+ * encabezados (intrínsecos x86, hilos); la clase PasoGpu la envuelve con
+ * Cajas y SistemaParticulas.
+ *
+ * @authors
+ * - Santiago Suárez
+ * - Eric Arciniegas
+ */
+
+#ifndef NUCLEOS_GPU_HPP
+#define NUCLEOS_GPU_HPP
+
+#include <string>
+#include "FisicaComun.hpp"
+
+namespace gpu {
+
+/**
+ * @struct Geometria
+ * @brief Caja y rejilla de celdas tal como las usa el dispositivo.
+ */
+struct Geometria {
+    double xmin, xmax, ymin, ymax;  ///< Límites de la caja.
+    double ladox, ladoy;            ///< Tamaño de cada celda (igual que MallaCeldas).
+    int nx, ny;                     ///< Celdas por eje.
+};
+
+/**
+ * @struct Resultado
+ * @brief Lo que vuelve al host en cada paso: paredes y cambios por choques.
+ */
+struct Resultado {
+    fisica::ResultadoParedes paredes;
+    double dK = 0, dPx = 0, dPy = 0;  ///< Cambios de las colisiones entre esferas.
+    double eventos = 0;               ///< Colisiones resueltas.
+};
+
+/// Estado en el dispositivo (definido en src/PasoGpu.cu).
+struct Estado;
+
+#ifdef CAJA_CUDA
+
+constexpr bool kCompilado = true;
+
+bool disponible();
+std::string nombreDispositivo();
+Estado *crear(const Geometria &g, int n, double m0, double R0, const double *m, const double *R,
+              bool conObservables);
+void destruir(Estado *e);
+bool subir(Estado *e, const double *x, const double *y, const double *vx, const double *vy);
+bool bajar(Estado *e, double *x, double *y, double *vx, double *vy);
+bool paso(Estado *e, double dt, Resultado &r);
+
+#else  // !CAJA_CUDA
+
+constexpr bool kCompilado = false;
+
+inline bool disponible() { return false; }
+inline std::string nombreDispositivo() { return ""; }
+inline Estado *crear(const Geometria &, int, double, double, const double *, const double *, bool) {
+    return nullptr;
+}
+inline void destruir(Estado *) {}
+inline bool subir(Estado *, const double *, const double *, const double *, const double *) { return false; }
+inline bool bajar(Estado *, double *, double *, double *, double *) { return false; }
+inline bool paso(Estado *, double, Resultado &) { return false; }
+
+#endif  // CAJA_CUDA
+
+}  // namespace gpu
+
+#endif  // NUCLEOS_GPU_HPP
@@ -0,0 +1,205 @@
+/**
+ * @file Observables.hpp
+ * @brief Energía, momento y presión actualizados a partir de cada evento.
+ *
+ * En vez de recorrer todas las esferas en cada paso para sumar la energía,
+ * los observables se calculan una vez al inicio y luego se corrigen con el
+ * cambio que produce cada colisión y cada rebote. Por paso se guardan medias
+ * y varianzas en línea (algoritmo de Welford), total y por ventanas, de modo
+ * que el error de la media se puede estimar por promedios de bloque.
+ *
+ * @authors
+ * - Santiago Suárez
+ * - Eric Arciniegas
+ */
+
+#ifndef OBSERVABLES_HPP
+#define OBSERVABLES_HPP
+
+#include <cmath>
+#include "Esfera.hpp"
+
+/**
+ * @class Welford
+ * @brief Media y varianza en línea, numéricamente estables.
+ */
+class Welford {
+private:
+    long n = 0;
+    double media = 0;
+    double m2 = 0;
+
+public:
+    void agregar(double x) {
+        n++;
+        double d = x - media;
+        media += d / n;
+        m2 += d * (x - media);
+    }
+
+    void reiniciar() {
+        n = 0;
+        media = 0;
+        m2 = 0;
+    }
+
+    long Getn() const { return n; }
+    double Getmedia() const { return media; }
+    double Getvarianza() const { return n > 1 ? m2 / (n - 1) : 0; }
+
+    /**
+     * @brief Error estándar de la media (supone muestras independientes).
+     */
+    double Geterror() const { return n > 1 ? std::sqrt(Getvarianza() / n) : 0; }
+};
+
+/**
+ * @class EstadisticaVentana
+ * @brief Estadística total, de la ventana actual y de las medias por ventana.
+ *
+ * Como los pasos consecutivos están correlacionados, el error de la media se
+ * estima a partir de las medias de ventanas de @c tam pasos.
+ */
+class EstadisticaVentana {
+private:
+    int tam = 100;
+    Welford total;     ///< Todas las muestras.
+    Welford actual;    ///< Ventana en curso.
+    Welford ultima;    ///< Última ventana completa.
+    Welford bloques;   ///< Medias de las ventanas completas.
+
+public:
+    void inicio(int tam_) {
+        tam = tam_ > 0 ? tam_ : 1;
+        total.reiniciar();
+        actual.reiniciar();
+        ultima.reiniciar();
+        bloques.reiniciar();
+    }
+
+    void agregar(double x) {
+        total.agregar(x);
+        actual.agregar(x);
+        if (actual.Getn() >= tam) {
+            ultima = actual;
+            bloques.agregar(actual.Getmedia());
+            actual.reiniciar();
+        }
+    }
+
+    const Welford &Gettotal() const { return total; }
+    const Welford &Getultima() const { return ultima; }
+    const Welford &Getbloques() const { return bloques; }
+
+    /**
+     * @brief Media de todas las muestras.
+     */
+    double media() const { return total.Getmedia(); }
+
+    /**
+     * @brief Error de la media por promedios de bloque (o ingenuo si hay menos de 2 bloques).
+     */
+    double error() const {
+        return bloques.Getn() > 1 ? bloques.Geterror() : total.Geterror();
+    }
+};
+
+/**
+ * @struct DeltaObservables
+ * @brief Cambio de energía cinética y momento producido por uno o más eventos.
+ */
+struct DeltaObservables {
+    double dK = 0;
+    double dPx = 0, dPy = 0;
+    long eventos = 0;
+
+    void sumar(const DeltaObservables &o) {
+        dK += o.dK;
+        dPx += o.dPx;
+        dPy += o.dPy;
+        eventos += o.eventos;
+    }
+};
+
+/**
+ * @class Observables
+ * @brief Energía cinética, momento total y presión con costo O(eventos) por paso.
+ */
+class Observables {
+private:
+    double K = 0;              ///< Energía cinética total.
+    double Px = 0, Py = 0;     ///< Momento total.
+    long colisiones = 0;       ///< Colisiones entre esferas registradas.
+    long choquesPared = 0;     ///< Choques con las paredes registrados.
+    long pasos = 0;
+    double ultimaP = 0, ultimaPmec = 0;
+    EstadisticaVentana estK, estP, estPmec;
+
+public:
+    /**
+     * @brief Define el tamaño de las ventanas (en pasos).
+     */
+    explicit Observables(int ventana = 100) {
+        estK.inicio(ventana);
+        estP.inicio(ventana);
+        estPmec.inicio(ventana);
+    }
+
+    /**
+     * @brief Fija los valores absolutos (sincronización O(N), sólo al conectar).
+     */
+    void fijar(double K_, double Px_, double Py_) {
+        K = K_;
+        Px = Px_;
+        Py = Py_;
+    }
+
+    /**
+     * @brief Aplica el cambio producido por colisiones entre esferas.
+     */
+    void colision(const DeltaObservables &d) {
+        K += d.dK;
+        Px += d.dPx;
+        Py += d.dPy;
+        colisiones += d.eventos;
+    }
+
+    /**
+     * @brief Aplica el cambio de momento de los rebotes contra las paredes.
+     *
+     * Un rebote elástico no cambia la energía cinética.
+     */
+    void paredes(double dPx, double dPy, double choques) {
+        Px += dPx;
+        Py += dPy;
+        choquesPared += static_cast<long>(choques);
+    }
+
+    /**
+     * @brief Cierra un paso: guarda energía y presiones en las estadísticas.
+     * @param caja Caja con la presión del paso ya calculada.
+     * @param dt Duración del paso.
+     */
+    void cerrarPaso(const Cajas &caja, double dt) {
+        ultimaP = caja.Getp();
+        ultimaPmec = caja.GetpMecanica(dt);
+        estK.agregar(K);
+        estP.agregar(ultimaP);
+        estPmec.agregar(ultimaPmec);
+        pasos++;
+    }
+
+    double Getenergia() const { return K; }
+    double GetPx() const { return Px; }
+    double GetPy() const { return Py; }
+    long Getcolisiones() const { return colisiones; }
+    long GetchoquesPared() const { return choquesPared; }
+    long Getpasos() const { return pasos; }
+    double Getpresion() const { return ultimaP; }
+    double GetpresionMecanica() const { return ultimaPmec; }
+    const EstadisticaVentana &GetestK() const { return estK; }
+    const EstadisticaVentana &GetestP() const { return estP; }
+    const EstadisticaVentana &GetestPmec() const { return estPmec; }
+};
+
+#endif  // OBSERVABLES_HPP
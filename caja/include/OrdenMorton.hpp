@@ -0,0 +1,119 @@
+/**
+ * @file OrdenMorton.hpp
+ * @brief Reordenamiento periódico de las partículas a lo largo de una curva de Morton.
+ *
+ * Las esferas empiezan ordenadas por la malla inicial, pero al difundirse dos
+ * vecinas en el espacio terminan lejos en los arreglos y el recorrido de
+ * colisiones salta por la memoria. Cada cierto número de pasos se ordenan las
+ * partículas por su clave de Morton (bits de x e y intercalados) sobre el
+ * dominio de la caja, de modo que las esferas cercanas vuelven a quedar
+ * cercanas en memoria.
+ *
+ * @authors
+ * - Santiago Suárez
+ * - Eric Arciniegas
+ */
+
+#ifndef ORDEN_MORTON_HPP
+#define ORDEN_MORTON_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "Esfera.hpp"
+#include "SistemaParticulas.hpp"
+
+/**
+ * @brief Separa los 16 bits bajos de @p v dejando un cero entre cada par.
+ */
+inline uint32_t separarBits(uint32_t v) {
+    v &= 0xFFFF;
+    v = (v | (v << 8)) & 0x00FF00FF;
+    v = (v | (v << 4)) & 0x0F0F0F0F;
+    v = (v | (v << 2)) & 0x33333333;
+    v = (v | (v << 1)) & 0x55555555;
+    return v;
+}
+
+/**
+ * @brief Clave de Morton de 32 bits del punto (x, y) dentro de la caja.
+ */
+inline uint32_t claveMorton(double x, double y, const Cajas &caja) {
+    const double escala = 65535.0;
+    double u = (x - caja.Getxmin()) / (caja.Getxmax() - caja.Getxmin());
+    double v = (y - caja.Getymin()) / (caja.Getymax() - caja.Getymin());
+    u = std::min(std::max(u, 0.0), 1.0);
+    v = std::min(std::max(v, 0.0), 1.0);
+    uint32_t ix = static_cast<uint32_t>(u * escala);
+    uint32_t iy = static_cast<uint32_t>(v * escala);
+    return separarBits(ix) | (separarBits(iy) << 1);
+}
+
+/**
+ * @class OrdenMorton
+ * @brief Decide cuándo reordenar y calcula la permutación.
+ *
+ * Tras reordenar(), Getnueva()[i] es la nueva posición de la partícula que
+ * estaba en i; sirve para corregir índices guardados fuera del sistema
+ * (por ejemplo, en ListaVecinos::permutar).
+ */
+class OrdenMorton {
+private:
+    int cada = 0;                    ///< Pasos entre reordenamientos (0 = nunca).
+    std::vector<uint64_t> claves;    ///< Clave de Morton << 32 | índice anterior.
+    std::vector<int> orden;          ///< orden[k]: índice anterior de la ranura k.
+    std::vector<int> nueva;          ///< nueva[i]: ranura nueva de la partícula i.
+    long reordenamientos = 0;
+
+public:
+    /**
+     * @brief Define el intervalo de reordenamiento.
+     * @param cada_ Pasos entre reordenamientos (0 lo desactiva).
+     */
+    void inicio(int cada_) {
+        cada = cada_ > 0 ? cada_ : 0;
+        reordenamientos = 0;
+    }
+
+    /**
+     * @brief Indica si en el paso @p paso toca reordenar.
+     */
+    bool toca(int paso) const { return cada > 0 && paso > 0 && paso % cada == 0; }
+
+    /**
+     * @brief Ordena las partículas de @p sis por su clave de Morton.
+     *
+     * El índice anterior desempata, así el resultado es determinista.
+     */
+    void reordenar(SistemaParticulas &sis, const Cajas &caja) {
+        int n = sis.size();
+        const double *x = sis.datosX();
+        const double *y = sis.datosY();
+        claves.resize(n);
+        for (int i = 0; i < n; i++) {
+            claves[i] = (static_cast<uint64_t>(claveMorton(x[i], y[i], caja)) << 32) |
+                        static_cast<uint32_t>(i);
+        }
+        std::sort(claves.begin(), claves.end());
+        orden.resize(n);
+        nueva.resize(n);
+        for (int k = 0; k < n; k++) {
+            orden[k] = static_cast<int>(claves[k] & 0xFFFFFFFFu);
+            nueva[orden[k]] = k;
+        }
+        sis.permutar(orden);
+        reordenamientos++;
+    }
+
+    /**
+     * @brief Devuelve la ranura nueva de cada partícula tras el último reordenamiento.
+     */
+    const std::vector<int> &Getnueva() const { return nueva; }
+
+    /**
+     * @brief Devuelve el número de reordenamientos realizados.
+     */
+    long Getreordenamientos() const { return reordenamientos; }
+};
+
+#endif  // ORDEN_MORTON_HPP
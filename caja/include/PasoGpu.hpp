@@ -0,0 +1,152 @@
+/**
+ * @file PasoGpu.hpp
+ * @brief Paso de simulación en una GPU con CUDA (opcional, make CUDA=1).
+ *
+ * Posiciones y velocidades viven en la memoria de la tarjeta durante toda la
+ * corrida. Cada paso son núcleos: celda de cada esfera, ordenamiento por
+ * celda, choques con el mismo calendario de 9 colores que PasoParalelo,
+ * rebote más movimiento, y una reducción de la presión y de los observables
+ * que deja en el host sólo unos pocos números por paso. Los arreglos se
+ * copian al host únicamente cuando se necesitan (frames de salida,
+ * instantáneas).
+ *
+ * La física por par y por partícula viene de FisicaComun.hpp, la misma que
+ * usa la CPU. Con -fmad=false el movimiento es multiplicación y suma
+ * separadas, igual que en los núcleos de KernelsSimd.hpp en cualquier nivel
+ * de CAJA_SIMD, así que las trayectorias coinciden con las de PasoParalelo.
+ * La presión y los observables sólo coinciden dentro del redondeo: la
+ * reducción en la GPU suma en otro orden.
+ *
+ * Sin -DCAJA_CUDA las funciones de NucleosGpu.hpp son vacías y
+ * PasoGpu::compilado() devuelve false, de modo que el resto del programa no
+ * necesita #ifdef.
+ *
+ * @authors
+ * - Santiago Suárez
+ * - Eric Arciniegas
+ */
+
+#ifndef PASO_GPU_HPP
+#define PASO_GPU_HPP
+
+#include <string>
+#include <vector>
+#include "Esfera.hpp"
+#include "Instrumentacion.hpp"
+#include "MallaCeldas.hpp"
+#include "NucleosGpu.hpp"
+#include "Observables.hpp"
+#include "SistemaParticulas.hpp"
+
+/**
+ * @class PasoGpu
+ * @brief Avanza en la GPU un SistemaParticulas que se copió una vez al dispositivo.
+ *
+ * Mientras está activo, el SistemaParticulas del host queda desactualizado:
+ * hay que llamar a descargar() antes de leerlo y a subir() si se modifica
+ * (por ejemplo, al reordenarlo).
+ */
+class PasoGpu {
+private:
+    gpu::Estado *estado = nullptr;
+    Observables *obs = nullptr;
+
+public:
+    PasoGpu() = default;
+    PasoGpu(const PasoGpu &) = delete;
+    PasoGpu &operator=(const PasoGpu &) = delete;
+    ~PasoGpu() { gpu::destruir(estado); }
+
+    /**
+     * @brief Indica si el programa se compiló con soporte CUDA.
+     */
+    static bool compilado() { return gpu::kCompilado; }
+
+    /**
+     * @brief Indica si hay una GPU utilizable.
+     */
+    static bool disponible() { return gpu::disponible(); }
+
+    /**
+     * @brief Nombre de la GPU en uso.
+     */
+    static std::string Getdispositivo() { return gpu::nombreDispositivo(); }
+
+    /**
+     * @brief Indica si hay un estado en el dispositivo.
+     */
+    bool activo() const { return estado != nullptr; }
+
+    /**
+     * @brief Reserva la memoria del dispositivo y copia el sistema.
+     * @param caja Caja de la simulación.
+     * @param sis Partículas (sus observables conectados se actualizan en cada paso).
+     * @return false si no hay GPU o no alcanzó la memoria.
+     */
+    bool inicio(const Cajas &caja, const SistemaParticulas &sis) {
+        gpu::destruir(estado);
+        estado = nullptr;
+        if (!disponible()) return false;
+
+        MallaCeldas malla;
+        malla.inicio(caja, sis.GetRmax());
+        gpu::Geometria g{caja.Getxmin(), caja.Getxmax(), caja.Getymin(), caja.Getymax(),
+                         malla.Getladox(), malla.Getladoy(), malla.Getnx(), malla.Getny()};
+
+        int n = sis.size();
+        std::vector<double> m, R;
+        if (sis.masasPropias()) {
+            m.resize(n);
+            for (int i = 0; i < n; i++) m[i] = sis.Getm(i);
+        }
+        if (sis.radiosPropios()) {
+            R.resize(n);
+            for (int i = 0; i < n; i++) R[i] = sis.GetR(i);
+        }
+        obs = sis.Getobservables();
+        estado = gpu::crear(g, n, sis.GetmComun(), sis.GetRComun(), m.empty() ? nullptr : m.data(),
+                            R.empty() ? nullptr : R.data(), obs != nullptr);
+        return estado && subir(sis);
+    }
+
+    /**
+     * @brief Copia posiciones y velocidades del host al dispositivo.
+     */
+    bool subir(const SistemaParticulas &sis) {
+        return gpu::subir(estado, sis.datosX(), sis.datosY(), sis.datosVX(), sis.datosVY());
+    }
+
+    /**
+     * @brief Copia posiciones y velocidades del dispositivo al host.
+     * @return false si falló la copia (el host queda con un estado viejo).
+     */
+    bool descargar(SistemaParticulas &sis) {
+        return gpu::bajar(estado, sis.datosX(), sis.datosY(), sis.datosVX(), sis.datosVY());
+    }
+
+    /**
+     * @brief Avanza el sistema un paso en el dispositivo.
+     * @param caja Caja donde se acumula la presión.
+     * @param dt Paso temporal.
+     * @return false si falló algún núcleo.
+     */
+    bool paso(Cajas &caja, double dt) {
+        gpu::Resultado r;
+        if (!gpu::paso(estado, dt, r)) return false;
+        caja.acumularPresion(r.paredes.sumaMv2, r.paredes.choques, r.paredes.impulso);
+        CAJA_CONTAR(instr::kChoquesPared, r.paredes.choques);
+        CAJA_CONTAR(instr::kColisionesResueltas, r.eventos);
+        if (obs) {
+            DeltaObservables d;
+            d.dK = r.dK;
+            d.dPx = r.dPx;
+            d.dPy = r.dPy;
+            d.eventos = static_cast<long>(r.eventos);
+            obs->colision(d);
+            obs->paredes(r.paredes.dPx, r.paredes.dPy, r.paredes.choques);
+        }
+        return true;
+    }
+};
+
+#endif  // PASO_GPU_HPP
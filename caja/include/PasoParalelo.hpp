@@ -0,0 +1,111 @@
+/**
+ * @file PasoParalelo.hpp
+ * @brief Paso de simulación con paso fijo repartido entre varios hilos.
+ *
+ * Las colisiones se resuelven sobre la rejilla de celdas con un calendario de
+ * colores (ver MallaCeldas::recorrerParesColoreado) y los rebotes y el
+ * movimiento se hacen por bloques fijos de partículas. El resultado no
+ * depende del número de hilos, lo que permite comparar corridas bit a bit.
+ *
+ * @authors
+ * - Santiago Suárez
+ * - Eric Arciniegas
+ */
+
+#ifndef PASO_PARALELO_HPP
+#define PASO_PARALELO_HPP
+
+#include <vector>
+#include "Esfera.hpp"
+#include "Instrumentacion.hpp"
+#include "KernelsSimd.hpp"
+#include "MallaCeldas.hpp"
+#include "PoolHilos.hpp"
+#include "SistemaParticulas.hpp"
+
+/**
+ * @class PasoParalelo
+ * @brief Avanza un SistemaParticulas usando un pool de hilos.
+ *
+ * La presión de las paredes se acumula en un acumulador por bloque de
+ * partículas y los bloques se suman siempre en el mismo orden; así la suma
+ * en punto flotante es la misma sin importar qué hilo procesó cada bloque.
+ * Lo mismo vale para los cambios de energía y momento de las colisiones,
+ * que se acumulan por celda.
+ */
+class PasoParalelo {
+private:
+    static const int kBloque = 4096;  ///< Partículas por bloque de rebote/movimiento.
+
+    PoolHilos pool;
+    MallaCeldas malla;
+    std::vector<simd::ResultadoParedes> parciales;  ///< Acumuladores por bloque.
+    std::vector<DeltaObservables> deltas;           ///< Cambios de las colisiones por celda.
+
+public:
+    /**
+     * @brief Crea el paso paralelo.
+     * @param hilos Número de hilos (0 = todos los núcleos).
+     */
+    explicit PasoParalelo(int hilos) : pool(hilos) {}
+
+    /**
+     * @brief Devuelve el número de hilos en uso.
+     */
+    int Gethilos() const { return pool.size(); }
+
+    /**
+     * @brief Define la rejilla de celdas.
+     * @param caja Caja de la simulación.
+     * @param Rmax Radio máximo de las esferas.
+     */
+    void inicio(const Cajas &caja, double Rmax) { malla.inicio(caja, Rmax); }
+
+    /**
+     * @brief Avanza el sistema un paso: colisiones, rebotes y movimiento.
+     * @param sis Partículas.
+     * @param caja Caja donde se acumula la presión.
+     * @param dt Paso temporal.
+     */
+    void paso(SistemaParticulas &sis, Cajas &caja, double dt) {
+        {
+            CAJA_MEDIR(instr::kMalla);
+            malla.construir(sis);
+        }
+        Observables *obs = sis.Getobservables();
+        {
+            CAJA_MEDIR(instr::kColisiones);
+            if (obs) {
+                deltas.assign(malla.Getnx() * malla.Getny(), DeltaObservables());
+                malla.recorrerParesColoreadoCelda(pool, [&](int c, int i, int j) {
+                    sis.colision(i, j, &deltas[c]);
+                });
+                DeltaObservables total;
+                for (const auto &d : deltas) total.sumar(d);
+                obs->colision(total);
+            } else {
+                malla.recorrerParesColoreado(pool, [&](int i, int j) { sis.colision(i, j, nullptr); });
+            }
+        }
+
+        // Rebote y movimiento van fusionados por bloque: se cuentan juntos en kParedes.
+        CAJA_MEDIR(instr::kParedes);
+        int n = sis.size();
+        int nb = (n + kBloque - 1) / kBloque;
+        parciales.assign(nb, simd::ResultadoParedes());
+        pool.paraCada(nb, [&](int b) {
+            int a = b * kBloque;
+            int f = std::min(a + kBloque, n);
+            sis.reboteParedRango(a, f, caja, parciales[b]);
+            sis.muevaseRango(a, f, dt);
+        });
+
+        for (const auto &r : parciales) {
+            caja.acumularPresion(r.sumaMv2, r.choques, r.impulso);
+            CAJA_CONTAR(instr::kChoquesPared, r.choques);
+            if (obs) obs->paredes(r.dPx, r.dPy, r.choques);
+        }
+    }
+};
+
+#endif  // PASO_PARALELO_HPP
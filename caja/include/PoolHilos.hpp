@@ -0,0 +1,126 @@
+/**
+ * @file PoolHilos.hpp
+ * @brief Conjunto fijo de hilos para repartir bucles independientes.
+ *
+ * Los hilos se crean una sola vez y se reutilizan en cada paso, evitando el
+ * costo de lanzar std::thread dentro del bucle de simulación.
+ *
+ * @authors
+ * - Santiago Suárez
+ * - Eric Arciniegas
+ */
+
+#ifndef POOL_HILOS_HPP
+#define POOL_HILOS_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class PoolHilos
+ * @brief Ejecuta bucles "para cada índice" repartidos entre varios hilos.
+ *
+ * El hilo que llama también trabaja, así que un pool de @c n hilos crea
+ * n - 1 hilos auxiliares. Los índices se reparten en bloques con un contador
+ * atómico; quien llama debe garantizar que las iteraciones son independientes.
+ */
+class PoolHilos {
+private:
+    std::vector<std::thread> hilos;
+    std::mutex mtx;
+    std::condition_variable cvInicio, cvFin;
+    std::function<void(int, int)> tarea;  ///< Trabajo sobre el rango [inicio, fin).
+    int total = 0;                        ///< Número de índices del bucle actual.
+    int bloque = 1;                       ///< Índices tomados en cada reparto.
+    std::atomic<int> siguiente{0};
+    int pendientes = 0;
+    long generacion = 0;
+    bool salir = false;
+
+    void ejecutar() {
+        int a;
+        while ((a = siguiente.fetch_add(bloque)) < total) {
+            tarea(a, std::min(a + bloque, total));
+        }
+    }
+
+    void trabajar() {
+        long visto = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> l(mtx);
+                cvInicio.wait(l, [&] { return salir || generacion != visto; });
+                if (salir) return;
+                visto = generacion;
+            }
+            ejecutar();
+            {
+                std::lock_guard<std::mutex> l(mtx);
+                if (--pendientes == 0) cvFin.notify_one();
+            }
+        }
+    }
+
+public:
+    /**
+     * @brief Crea el pool.
+     * @param n Número total de hilos (incluye al que llama); 0 usa todos los núcleos.
+     */
+    explicit PoolHilos(int n = 1) {
+        if (n <= 0) n = std::max(1u, std::thread::hardware_concurrency());
+        for (int t = 1; t < n; t++) hilos.emplace_back([this] { trabajar(); });
+    }
+
+    ~PoolHilos() {
+        {
+            std::lock_guard<std::mutex> l(mtx);
+            salir = true;
+        }
+        cvInicio.notify_all();
+        for (auto &h : hilos) h.join();
+    }
+
+    PoolHilos(const PoolHilos &) = delete;
+    PoolHilos &operator=(const PoolHilos &) = delete;
+
+    /**
+     * @brief Devuelve el número total de hilos.
+     */
+    int size() const { return static_cast<int>(hilos.size()) + 1; }
+
+    /**
+     * @brief Ejecuta @p f(i) para i en [0, n) y espera a que todos terminen.
+     * @param n Número de iteraciones.
+     * @param f Función a evaluar en cada índice.
+     * @param tamBloque Índices que toma cada hilo por reparto.
+     */
+    template <typename F>
+    void paraCada(int n, F &&f, int tamBloque = 1) {
+        if (hilos.empty() || n <= tamBloque) {
+            for (int i = 0; i < n; i++) f(i);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> l(mtx);
+            tarea = [&f](int a, int b) {
+                for (int i = a; i < b; i++) f(i);
+            };
+            total = n;
+            bloque = std::max(1, tamBloque);
+            siguiente = 0;
+            pendientes = static_cast<int>(hilos.size());
+            generacion++;
+        }
+        cvInicio.notify_all();
+        ejecutar();
+        std::unique_lock<std::mutex> l(mtx);
+        cvFin.wait(l, [&] { return pendientes == 0; });
+    }
+};
+
+#endif  // POOL_HILOS_HPP
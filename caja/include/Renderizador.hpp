@@ -0,0 +1,336 @@
+/**
+ * @file Renderizador.hpp
+ * @brief Etapa de render asíncrona: las animaciones se dibujan en su propio hilo.
+ *
+ * El bucle de física sólo copia una instantánea del frame en un anillo sin
+ * bloqueos (AnilloSPSC) y sigue; un hilo aparte la dibuja. Por defecto el
+ * hilo pinta los discos y el histograma en un Lienzo y los codifica a GIF
+ * (o los manda a ffmpeg); con el motor gnuplot escribe, como antes, los
+ * comandos y datos en texto a las tuberías de gnuplot. Se puede renderizar
+ * uno de cada K pasos o desactivar el render por completo (modo sin gráficos).
+ *
+ * @authors
+ * - Santiago Suárez
+ * - Eric Arciniegas
+ */
+
+#ifndef RENDERIZADOR_HPP
+#define RENDERIZADOR_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "AnilloSPSC.hpp"
+#include "HistogramaVelocidades.hpp"
+#include "Instrumentacion.hpp"
+#include "Lienzo.hpp"
+#include "SalidaVideo.hpp"
+#include "SistemaParticulas.hpp"
+
+/// Quién dibuja las animaciones.
+enum class MotorRender {
+    kNativo,   ///< Lienzo propio y GIF (directorio/*.gif).
+    kFfmpeg,   ///< Lienzo propio y tubería a ffmpeg (directorio/*.mp4).
+    kGnuplot   ///< Texto a gnuplot, como la versión original.
+};
+
+/**
+ * @struct ConfigRender
+ * @brief Opciones de la etapa de render.
+ */
+struct ConfigRender {
+    bool activo = true;     ///< false: no se dibuja nada (modo sin gráficos).
+    MotorRender motor = MotorRender::kNativo;
+    int cada = 1;           ///< Se renderiza un frame cada @c cada pasos.
+    double largo = 1;       ///< Lado de la caja (rango de los ejes).
+    double ps = 1;          ///< Tamaño de punto de las esferas (gnuplot).
+    double radio = 0;       ///< Radio de las esferas (motor nativo; 0: un píxel).
+    size_t capacidad = 4;   ///< Frames que caben en el anillo.
+    bool descartar = false; ///< true: con el anillo lleno se descarta el frame en vez de esperar.
+    std::string directorio = "results"; ///< Carpeta de las animaciones.
+};
+
+/**
+ * @struct FrameRender
+ * @brief Instantánea de un paso, lista para enviar a gnuplot.
+ */
+struct FrameRender {
+    int paso;
+    double t, presion, energia;
+    std::vector<double> x, y;     ///< Posiciones de las esferas.
+    std::vector<long> cuentas;    ///< Histograma de rapideces.
+    std::vector<double> ajuste;   ///< Cuentas esperadas (Maxwell–Boltzmann).
+    double ancho, vtope, kT;
+};
+
+/**
+ * @class Renderizador
+ * @brief Productor/consumidor de frames entre el bucle de física y gnuplot.
+ *
+ * Si el anillo está lleno, enviar() espera a que el hilo de render libere una
+ * ranura: la animación tiene todos los frames pedidos y la física avanza al
+ * ritmo del dibujo. Con ConfigRender::descartar (corridas de producción que
+ * sólo quieren una muestra) el frame se descarta y se cuenta
+ * (Getdescartados(), contador @c frames_descartados), así el dibujo nunca
+ * frena la física.
+ */
+class Renderizador {
+private:
+    ConfigRender cfg;
+    FILE *gnuplot = nullptr;    ///< Animación de posiciones.
+    FILE *gnuplot2 = nullptr;   ///< Animación del histograma.
+    SalidaVideo video;          ///< Animación de posiciones (motor nativo).
+    SalidaVideo video2;         ///< Animación del histograma (motor nativo).
+    Lienzo lienzo, lienzo2;
+    std::unique_ptr<AnilloSPSC<FrameRender>> anillo;
+    std::thread hilo;
+    std::atomic<bool> terminado{false};
+    long frames = 0;
+    long descartados = 0;       ///< Frames que no cupieron en el anillo.
+
+    static const int kLadoCaja = 500;             ///< Píxeles del frame de posiciones.
+    static const int kAnchoHist = 800, kAltoHist = 600;
+
+    /**
+     * @brief Dibuja el frame en los lienzos y lo agrega a las animaciones.
+     */
+    void dibujarNativo(const FrameRender &f) {
+        char titulo[128];
+        int lado = lienzo.Getancho();
+        double escala = lado / cfg.largo;
+        double r = std::max(cfg.radio * escala, 0.5);
+        lienzo.limpiar(kBlanco);
+        for (size_t k = 0; k < f.x.size(); k++) {
+            lienzo.disco((f.x[k] + cfg.largo / 2) * escala, (cfg.largo / 2 - f.y[k]) * escala, r, kEsfera);
+        }
+        std::snprintf(titulo, sizeof(titulo), "t = %.2f  P = %.4f  E = %.4f", f.t, f.presion, f.energia);
+        lienzo.texto(6, 6, titulo, kGrisOscuro);
+        video.frame(lienzo);
+
+        // --- Histograma: barras, ajuste y ejes ---
+        const int izq = 60, der = 20, arriba = 40, abajo = 40;
+        int w = lienzo2.Getancho() - izq - der, h = lienzo2.Getalto() - arriba - abajo;
+        double ytope = 1;
+        for (long c : f.cuentas) ytope = std::max(ytope, static_cast<double>(c));
+        for (double a : f.ajuste) ytope = std::max(ytope, a);
+        ytope *= 1.05;
+        auto px = [&](double v) { return izq + static_cast<int>(v / f.vtope * w); };
+        auto py = [&](double c) { return arriba + h - static_cast<int>(c / ytope * h); };
+        lienzo2.limpiar(kBlanco);
+        for (int k = 1; k <= 4; k++) lienzo2.linea(izq, arriba + h - k * h / 4, izq + w, arriba + h - k * h / 4, kGrisClaro);
+        for (size_t b = 0; b < f.cuentas.size(); b++) {
+            double c = (b + 0.5) * f.ancho;
+            lienzo2.rectangulo(px(c - 0.45 * f.ancho), py(static_cast<double>(f.cuentas[b])),
+                               px(c + 0.45 * f.ancho), arriba + h, kBarra);
+        }
+        for (size_t b = 1; b < f.ajuste.size(); b++) {
+            lienzo2.linea(px((b - 0.5) * f.ancho), py(f.ajuste[b - 1]), px((b + 0.5) * f.ancho), py(f.ajuste[b]),
+                          kCurva, 2);
+        }
+        lienzo2.linea(izq, arriba, izq, arriba + h, kNegro);
+        lienzo2.linea(izq, arriba + h, izq + w, arriba + h, kNegro);
+        std::snprintf(titulo, sizeof(titulo), "t = %.2f", f.t);
+        lienzo2.texto(izq + 10, arriba + 10, titulo, kGrisOscuro);
+        std::snprintf(titulo, sizeof(titulo), "N = %zu", f.x.size());
+        lienzo2.texto(izq + 10, arriba + 30, titulo, kGrisOscuro);
+        std::snprintf(titulo, sizeof(titulo), "kT = %.3f", f.kT);
+        lienzo2.texto(izq + w - 120, arriba + 10, titulo, kCurva);
+        video2.frame(lienzo2);
+    }
+
+    void dibujar(const FrameRender &f) {
+        if (cfg.motor != MotorRender::kGnuplot) {
+            dibujarNativo(f);
+            return;
+        }
+        fprintf(gnuplot, "set title sprintf('t = %.2f s   P = %.4f (Pa·m³)   E = %.4f J')\n",
+                f.t, f.presion, f.energia);
+        fprintf(gnuplot, "plot '-' using 1:2 with points pt 7 ps %f notitle \n", cfg.ps);
+        for (size_t k = 0; k < f.x.size(); k++) {
+            fprintf(gnuplot, "%f\t%f\n", f.x[k], f.y[k]);
+        }
+        fprintf(gnuplot, "e\n");
+        fflush(gnuplot);
+
+        int n = static_cast<int>(f.x.size());
+        fprintf(gnuplot2, "set xrange [0:%f]\n", f.vtope);
+        fprintf(gnuplot2, "set yrange [0:*]\n");
+        fprintf(gnuplot2,
+                "set label 1 sprintf('t = %.2f s', %f) at graph 0.02, 0.95 front tc rgb '#333333' font ',12'\n",
+                f.t, f.t);
+        fprintf(gnuplot2,
+                "set label 2 sprintf('N = %d', %d) at graph 0.02, 0.88 front tc rgb '#333333' font ',12'\n",
+                n, n);
+        fprintf(gnuplot2,
+                "set title sprintf('Distribución de velocidades - paso %d', %d)\n",
+                f.paso, f.paso);
+        fprintf(gnuplot2,
+                "plot '-' using 1:2 with boxes lc rgb '#1f77b4' title 'Velocidades', "
+                "'-' using 1:2 with lines lw 2 lc rgb '#d62728' title sprintf('Maxwell-Boltzmann (kT = %%.3f)', %f)\n",
+                f.kT);
+        for (size_t b = 0; b < f.cuentas.size(); b++) {
+            fprintf(gnuplot2, "%f\t%ld\n", (b + 0.5) * f.ancho, f.cuentas[b]);
+        }
+        fprintf(gnuplot2, "e\n");
+        for (size_t b = 0; b < f.ajuste.size(); b++) {
+            fprintf(gnuplot2, "%f\t%f\n", (b + 0.5) * f.ancho, f.ajuste[b]);
+        }
+        fprintf(gnuplot2, "e\n");
+        fprintf(gnuplot2, "unset label 1\nunset label 2\n");
+        fflush(gnuplot2);
+    }
+
+    void trabajar() {
+        while (true) {
+            FrameRender *f = anillo->frente();
+            if (!f) {
+                if (terminado.load(std::memory_order_acquire) && anillo->vacio()) break;
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+                continue;
+            }
+            dibujar(*f);
+            anillo->liberar();
+        }
+    }
+
+    void configurar() {
+        fprintf(gnuplot, "set terminal gif animate delay 10 size 600,400\n");
+        fprintf(gnuplot, "set output '%s/animacion.gif'\n", cfg.directorio.c_str());
+        fprintf(gnuplot, "set xrange [-%f:%f]\n", cfg.largo / 2, cfg.largo / 2);
+        fprintf(gnuplot, "set yrange [-%f:%f]\n", cfg.largo / 2, cfg.largo / 2);
+        fflush(gnuplot);
+
+        fprintf(gnuplot2, "reset\n");
+        fprintf(gnuplot2, "set encoding utf8\n");
+        fprintf(gnuplot2, "set terminal gif animate delay 10 size 800,600 enhanced font 'Arial,12'\n");
+        fprintf(gnuplot2, "set output '%s/histograma_velocidades.gif'\n", cfg.directorio.c_str());
+        fprintf(gnuplot2, "set xlabel 'Velocidad'\n");
+        fprintf(gnuplot2, "set ylabel 'Frecuencia'\n");
+        fprintf(gnuplot2, "set style fill solid 0.7 border -1\n");
+        fprintf(gnuplot2, "set boxwidth 0.9 relative\n");
+        fprintf(gnuplot2, "set grid ytics\n");
+        fprintf(gnuplot2, "set key top right\n");  // leyenda arriba derecha
+        fflush(gnuplot2);
+    }
+
+public:
+    ~Renderizador() { terminar(); }
+
+    /**
+     * @brief Abre las salidas (archivos, ffmpeg o gnuplot) y lanza el hilo de render.
+     * @param c Opciones; con @c c.activo = false no se hace nada.
+     * @return false si se pidió render y no se pudo abrir la salida.
+     */
+    bool inicio(const ConfigRender &c) {
+        cfg = c;
+        if (cfg.cada < 1) cfg.cada = 1;
+        if (!cfg.activo) return true;
+        if (cfg.motor != MotorRender::kGnuplot) {
+            FormatoVideo fmt = cfg.motor == MotorRender::kFfmpeg ? FormatoVideo::kFfmpeg : FormatoVideo::kGif;
+            const char *ext = cfg.motor == MotorRender::kFfmpeg ? ".mp4" : ".gif";
+            lienzo.inicio(kLadoCaja, kLadoCaja);
+            lienzo2.inicio(kAnchoHist, kAltoHist);
+            if (!video.abrir(cfg.directorio + "/animacion" + ext, kLadoCaja, kLadoCaja, fmt, 10) ||
+                !video2.abrir(cfg.directorio + "/histograma_velocidades" + ext, kAnchoHist, kAltoHist, fmt, 10)) {
+                video.cerrar();
+                video2.cerrar();
+                cfg.activo = false;
+                return false;
+            }
+        } else {
+            gnuplot = popen("gnuplot -persist", "w");
+            gnuplot2 = popen("gnuplot -persist", "w");
+            if (!gnuplot || !gnuplot2) {
+                if (gnuplot) pclose(gnuplot);
+                if (gnuplot2) pclose(gnuplot2);
+                gnuplot = gnuplot2 = nullptr;
+                cfg.activo = false;
+                return false;
+            }
+            configurar();
+        }
+        anillo.reset(new AnilloSPSC<FrameRender>(cfg.capacidad));
+        terminado = false;
+        hilo = std::thread([this] { trabajar(); });
+        return true;
+    }
+
+    /**
+     * @brief Indica si el paso @p paso se renderiza.
+     */
+    bool toca(int paso) const { return cfg.activo && paso % cfg.cada == 0; }
+
+    /**
+     * @brief Copia el estado actual en el anillo para que lo dibuje el hilo de render.
+     * @details Si el anillo está lleno espera una ranura, o descarta y cuenta
+     * el frame si ConfigRender::descartar.
+     */
+    void enviar(int paso, double t, double presion, double energia,
+                const SistemaParticulas &sis, const HistogramaVelocidades &hist) {
+        if (!cfg.activo) return;
+        FrameRender *f = anillo->reservar();
+        if (!f && cfg.descartar) {
+            descartados++;
+            CAJA_CONTAR(instr::kFramesDescartados, 1);
+            return;
+        }
+        while (!f) {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            f = anillo->reservar();
+        }
+        f->paso = paso;
+        f->t = t;
+        f->presion = presion;
+        f->energia = energia;
+        f->x.assign(sis.datosX(), sis.datosX() + sis.size());
+        f->y.assign(sis.datosY(), sis.datosY() + sis.size());
+        f->cuentas = hist.Getcuentas();
+        f->ancho = hist.Getancho();
+        f->vtope = hist.Getvtope();
+        f->kT = hist.GetkT();
+        f->ajuste.resize(hist.Getnbins());
+        for (int b = 0; b < hist.Getnbins(); b++) f->ajuste[b] = hist.maxwell(hist.centro(b), f->kT);
+        anillo->publicar();
+        frames++;
+        CAJA_CONTAR(instr::kFramesRender, 1);
+    }
+
+    /**
+     * @brief Espera a que se dibujen los frames pendientes y cierra las salidas.
+     */
+    void terminar() {
+        if (!anillo) return;
+        terminado = true;
+        if (hilo.joinable()) hilo.join();
+        if (gnuplot) {
+            fprintf(gnuplot, "unset output \n");
+            fflush(gnuplot);
+            pclose(gnuplot);
+            fprintf(gnuplot2, "unset output\n");
+            fflush(gnuplot2);
+            pclose(gnuplot2);
+            gnuplot = gnuplot2 = nullptr;
+        }
+        video.cerrar();
+        video2.cerrar();
+        anillo.reset();
+    }
+
+    /**
+     * @brief Devuelve el número de frames enviados a render.
+     */
+    long Getframes() const { return frames; }
+
+    /**
+     * @brief Devuelve el número de frames descartados porque el anillo estaba lleno.
+     */
+    long Getdescartados() const { return descartados; }
+};
+
+#endif  // RENDERIZADOR_HPP
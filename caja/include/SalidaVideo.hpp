@@ -0,0 +1,273 @@
+/**
+ * @file SalidaVideo.hpp
+ * @brief Animaciones a partir de frames de Lienzo: GIF propio o tubería a ffmpeg.
+ *
+ * El codificador GIF escribe GIF89a animado con la paleta de 16 colores de
+ * Lienzo.hpp y compresión LZW, sin bibliotecas externas. Con ffmpeg los
+ * frames se expanden a RGB y se mandan crudos (rawvideo rgb24); ffmpeg
+ * produce el video (por ejemplo .mp4) según la extensión del archivo.
+ *
+ * @authors
+ * - Santiago Suárez
+ * - Eric Arciniegas
+ */
+
+#ifndef SALIDA_VIDEO_HPP
+#define SALIDA_VIDEO_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "Lienzo.hpp"
+
+/**
+ * @class CodificadorGif
+ * @brief Escritor de GIF animado con paleta global y bucle infinito.
+ */
+class CodificadorGif {
+private:
+    std::FILE *f = nullptr;
+    std::vector<uint8_t> bufer;  ///< Bufer de stdio.
+    int ancho = 0, alto = 0;
+    int bitsColor = 4;           ///< log2 del tamaño de la paleta.
+    int retardo = 10;            ///< Centésimas de segundo entre frames.
+
+    // --- Estado del LZW ---
+    static const int kTabla = 5003;  ///< Tamaño primo de la tabla hash de códigos.
+    std::vector<int32_t> claves;     ///< (prefijo << 8 | píxel), -1 si libre.
+    std::vector<int16_t> codigos;
+    uint32_t acumulado = 0;          ///< Bits pendientes (LSB primero).
+    int nbits = 0;
+    std::vector<uint8_t> bloque;     ///< Subbloque de hasta 255 bytes.
+
+    void byte(uint8_t b) { std::fputc(b, f); }
+    void palabra(int v) {
+        byte(v & 0xff);
+        byte((v >> 8) & 0xff);
+    }
+
+    void emitirBloque() {
+        if (bloque.empty()) return;
+        byte(static_cast<uint8_t>(bloque.size()));
+        std::fwrite(bloque.data(), 1, bloque.size(), f);
+        bloque.clear();
+    }
+
+    void codigo(int c, int tam) {
+        acumulado |= static_cast<uint32_t>(c) << nbits;
+        nbits += tam;
+        while (nbits >= 8) {
+            bloque.push_back(acumulado & 0xff);
+            acumulado >>= 8;
+            nbits -= 8;
+            if (bloque.size() == 255) emitirBloque();
+        }
+    }
+
+    /**
+     * @brief Busca (prefijo, píxel); devuelve el código o -1 y deja en @p ranura dónde insertarlo.
+     */
+    int buscar(int32_t clave, int &ranura) const {
+        int h = static_cast<int>(static_cast<uint32_t>(clave) * 2654435761u % kTabla);
+        while (claves[h] != -1) {
+            if (claves[h] == clave) {
+                ranura = h;
+                return codigos[h];
+            }
+            h = h + 1 == kTabla ? 0 : h + 1;
+        }
+        ranura = h;
+        return -1;
+    }
+
+    void comprimir(const uint8_t *p, size_t n) {
+        int minimo = bitsColor < 2 ? 2 : bitsColor;
+        int limpiar = 1 << minimo, fin = limpiar + 1;
+        int tam = minimo + 1, siguiente = fin + 1;
+        claves.assign(kTabla, -1);
+        codigos.assign(kTabla, 0);
+        acumulado = 0;
+        nbits = 0;
+        bloque.clear();
+
+        byte(static_cast<uint8_t>(minimo));
+        codigo(limpiar, tam);
+        int prefijo = p[0];
+        for (size_t k = 1; k < n; k++) {
+            int32_t clave = (prefijo << 8) | p[k];
+            int ranura;
+            int c = buscar(clave, ranura);
+            if (c >= 0) {
+                prefijo = c;
+                continue;
+            }
+            codigo(prefijo, tam);
+            if (siguiente < 4096) {
+                if (siguiente == (1 << tam)) tam++;
+                claves[ranura] = clave;
+                codigos[ranura] = static_cast<int16_t>(siguiente++);
+            } else {
+                codigo(limpiar, tam);
+                claves.assign(kTabla, -1);
+                tam = minimo + 1;
+                siguiente = fin + 1;
+            }
+            prefijo = p[k];
+        }
+        codigo(prefijo, tam);
+        codigo(fin, tam);
+        if (nbits > 0) {
+            bloque.push_back(acumulado & 0xff);
+            nbits = 0;
+        }
+        emitirBloque();
+        byte(0);  // fin de los datos de la imagen
+    }
+
+public:
+    ~CodificadorGif() { cerrar(); }
+
+    /**
+     * @brief Crea el archivo y escribe la cabecera, la paleta y el bucle infinito.
+     * @param ruta Archivo de salida.
+     * @param w Ancho en píxeles.
+     * @param h Alto en píxeles.
+     * @param paleta Colores 0xRRGGBB (una potencia de 2, de 2 a 256).
+     * @param centesimas Retardo entre frames.
+     * @return false si no se pudo abrir el archivo.
+     */
+    bool abrir(const std::string &ruta, int w, int h, const std::vector<uint32_t> &paleta, int centesimas) {
+        cerrar();
+        f = std::fopen(ruta.c_str(), "wb");
+        if (!f) return false;
+        bufer.resize(1 << 20);
+        std::setvbuf(f, reinterpret_cast<char *>(bufer.data()), _IOFBF, bufer.size());
+        ancho = w;
+        alto = h;
+        retardo = centesimas;
+        bitsColor = 1;
+        while ((1u << bitsColor) < paleta.size()) bitsColor++;
+
+        std::fwrite("GIF89a", 1, 6, f);
+        palabra(w);
+        palabra(h);
+        byte(static_cast<uint8_t>(0x80 | ((bitsColor - 1) << 4) | (bitsColor - 1)));
+        byte(0);  // color de fondo
+        byte(0);  // sin relación de aspecto
+        for (int c = 0; c < (1 << bitsColor); c++) {
+            uint32_t rgb = c < static_cast<int>(paleta.size()) ? paleta[c] : 0;
+            byte((rgb >> 16) & 0xff);
+            byte((rgb >> 8) & 0xff);
+            byte(rgb & 0xff);
+        }
+        // Extensión NETSCAPE2.0: repetir para siempre.
+        const uint8_t bucle[] = {0x21, 0xff, 0x0b, 'N', 'E', 'T', 'S', 'C', 'A', 'P', 'E',
+                                 '2',  '.',  '0',  0x03, 0x01, 0x00, 0x00, 0x00};
+        std::fwrite(bucle, 1, sizeof(bucle), f);
+        return true;
+    }
+
+    /**
+     * @brief Agrega un frame de ancho × alto índices de paleta.
+     */
+    void frame(const uint8_t *indices) {
+        if (!f) return;
+        const uint8_t control[] = {0x21, 0xf9, 0x04, 0x00, static_cast<uint8_t>(retardo & 0xff),
+                                   static_cast<uint8_t>(retardo >> 8), 0x00, 0x00};
+        std::fwrite(control, 1, sizeof(control), f);
+        byte(0x2c);
+        palabra(0);
+        palabra(0);
+        palabra(ancho);
+        palabra(alto);
+        byte(0);  // sin paleta local, sin entrelazado
+        comprimir(indices, static_cast<size_t>(ancho) * alto);
+    }
+
+    /**
+     * @brief Escribe el terminador y cierra el archivo.
+     */
+    void cerrar() {
+        if (!f) return;
+        byte(0x3b);
+        std::fclose(f);
+        f = nullptr;
+    }
+};
+
+/// Formato de las animaciones nativas.
+enum class FormatoVideo { kGif, kFfmpeg };
+
+/**
+ * @class SalidaVideo
+ * @brief Destino de los frames de un Lienzo: archivo GIF o tubería a ffmpeg.
+ */
+class SalidaVideo {
+private:
+    FormatoVideo formato = FormatoVideo::kGif;
+    CodificadorGif gif;
+    std::FILE *tuberia = nullptr;
+    std::vector<uint8_t> rgb;
+    int ancho = 0, alto = 0;
+
+public:
+    ~SalidaVideo() { cerrar(); }
+
+    /**
+     * @brief Abre la salida.
+     * @param ruta Archivo (.gif, o cualquier extensión que entienda ffmpeg).
+     * @param w Ancho (par, si se usa ffmpeg con yuv420p).
+     * @param h Alto.
+     * @param fmt GIF propio o ffmpeg.
+     * @param centesimas Retardo entre frames (10 = 10 frames por segundo).
+     * @return false si no se pudo abrir el archivo o lanzar ffmpeg.
+     */
+    bool abrir(const std::string &ruta, int w, int h, FormatoVideo fmt, int centesimas) {
+        cerrar();
+        formato = fmt;
+        ancho = w;
+        alto = h;
+        if (formato == FormatoVideo::kGif) return gif.abrir(ruta, w, h, paletaRender(), centesimas);
+
+        // Sin ffmpeg, popen abriría igual un shell y el primer frame mataría el programa con SIGPIPE.
+        if (std::system("command -v ffmpeg > /dev/null 2>&1") != 0) return false;
+        std::string orden = "ffmpeg -loglevel error -y -f rawvideo -pix_fmt rgb24 -s " + std::to_string(w) +
+                            "x" + std::to_string(h) + " -r " + std::to_string(100 / centesimas) +
+                            " -i - -pix_fmt yuv420p '" + ruta + "'";
+        tuberia = popen(orden.c_str(), "w");
+        rgb.resize(3 * static_cast<size_t>(w) * h);
+        return tuberia != nullptr;
+    }
+
+    /**
+     * @brief Agrega el contenido actual de @p l como un frame.
+     */
+    void frame(const Lienzo &l) {
+        if (formato == FormatoVideo::kGif) {
+            gif.frame(l.datos());
+            return;
+        }
+        if (!tuberia) return;
+        const std::vector<uint32_t> &pal = paletaRender();
+        const uint8_t *p = l.datos();
+        for (size_t k = 0; k < static_cast<size_t>(ancho) * alto; k++) {
+            uint32_t c = pal[p[k]];
+            rgb[3 * k] = (c >> 16) & 0xff;
+            rgb[3 * k + 1] = (c >> 8) & 0xff;
+            rgb[3 * k + 2] = c & 0xff;
+        }
+        std::fwrite(rgb.data(), 1, rgb.size(), tuberia);
+    }
+
+    void cerrar() {
+        gif.cerrar();
+        if (tuberia) {
+            pclose(tuberia);
+            tuberia = nullptr;
+        }
+    }
+};
+
+#endif  // SALIDA_VIDEO_HPP
@@ -0,0 +1,214 @@
+/**
+ * @file Simulacion.hpp
+ * @brief Inicialización y corrida completa de una caja sin interacción con el usuario.
+ *
+ * Agrupa lo que main() hacía paso a paso (malla inicial, velocidades
+ * aleatorias, bucle de paso fijo) para poder correr muchas cajas
+ * independientes, cada una con su propio generador de números aleatorios.
+ *
+ * La corrida sin salidas (simularCaja) también sirve para cajas 3D y para
+ * float: elige SistemaParticulasT, CajasT y MallaCeldasT según
+ * ParametrosCaja::dim y ParametrosCaja::simple.
+ *
+ * @authors
+ * - Santiago Suárez
+ * - Eric Arciniegas
+ */
+
+#ifndef SIMULACION_HPP
+#define SIMULACION_HPP
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include "Esfera.hpp"
+#include "MallaCeldas.hpp"
+#include "SistemaParticulas.hpp"
+
+/**
+ * @struct ParametrosCaja
+ * @brief Parámetros de una corrida.
+ */
+struct ParametrosCaja {
+    double largo = 10;       ///< Lado de la caja.
+    int n = 100;             ///< Número de esferas.
+    double vmax = 1;         ///< Rapidez inicial máxima.
+    double R = 0.1;          ///< Radio de las esferas.
+    double m = 1;            ///< Masa de las esferas.
+    double dt = 0.01;        ///< Paso temporal.
+    int pasos = 300;         ///< Número de pasos.
+    uint64_t semilla = 1;    ///< Semilla del generador.
+    int dim = 2;             ///< Dimensión de la caja (2 o 3).
+    bool simple = false;     ///< true: posiciones y velocidades en float.
+};
+
+/**
+ * @struct ResultadoCaja
+ * @brief Observables promediados sobre toda la corrida.
+ */
+struct ResultadoCaja {
+    double presion = 0;          ///< Promedio de m·v²/3 por choque con las paredes.
+    double presionMecanica = 0;  ///< Impulso / (borde × tiempo total); borde: perímetro o área.
+    double kT = 0;               ///< 2·E/(dim·n), con E la energía cinética al final.
+    double choques = 0;          ///< Choques con las paredes.
+};
+
+/**
+ * @brief Mezcla una semilla base con el índice de la corrida (splitmix64).
+ *
+ * Da semillas reproducibles y bien separadas para corridas consecutivas.
+ */
+inline uint64_t semillaCorrida(uint64_t base, uint64_t indice) {
+    uint64_t z = base + 0x9E3779B97F4A7C15ull * (indice + 1);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief Esferas por eje de la malla inicial: el menor k con k^dim >= n.
+ */
+inline int ladoMalla(int n, int dim = 2) {
+    if (dim == 2) return static_cast<int>(std::ceil(std::sqrt(n)));
+    int k = static_cast<int>(std::cbrt(static_cast<double>(n)));
+    while (k * k * k < n) k++;
+    return k;
+}
+
+/**
+ * @brief Radio máximo permitido por la malla inicial.
+ */
+inline double radioMaximo(double largo, int n, int dim = 2) {
+    return largo / (2.0 * ladoMalla(n, dim));
+}
+
+/**
+ * @brief Genera la malla inicial llamando @p f(idx, x, y, vx, vy) por esfera.
+ *
+ * Cada esfera recibe una dirección uniforme en [0, 2π) y una rapidez
+ * uniforme en [0, vmax], igual que en la versión interactiva. Las esferas
+ * salen siempre en el mismo orden y con los mismos números aleatorios, de
+ * modo que quien sólo guarda una parte (un subdominio MPI) obtiene las
+ * mismas esferas que la corrida completa.
+ */
+template <typename F>
+void recorrerMallaInicial(const ParametrosCaja &p, std::mt19937_64 &rng, F &&f) {
+    std::uniform_real_distribution<double> uniforme(0.0, 1.0);
+    int malla = static_cast<int>(std::ceil(std::sqrt(p.n)));
+    double half = p.largo / 2.0;
+    int idx = 0;
+    for (int i = 0; i < malla && idx < p.n; i++) {
+        for (int j = 0; j < malla && idx < p.n; j++) {
+            double x0 = -half + (i + 0.5) * (p.largo / malla);
+            double y0 = -half + (j + 0.5) * (p.largo / malla);
+            double ang = 2.0 * 3.14159265358979323846 * uniforme(rng);
+            double v = p.vmax * uniforme(rng);
+            f(idx, x0, y0, v * std::cos(ang), v * std::sin(ang));
+            idx++;
+        }
+    }
+}
+
+/**
+ * @brief Malla inicial en 3D: llama @p f(idx, posición, velocidad) por esfera.
+ *
+ * Las direcciones son uniformes sobre la esfera unidad y las rapideces
+ * uniformes en [0, vmax].
+ */
+template <typename F>
+void recorrerMallaInicial3D(const ParametrosCaja &p, std::mt19937_64 &rng, F &&f) {
+    std::uniform_real_distribution<double> uniforme(0.0, 1.0);
+    int malla = ladoMalla(p.n, 3);
+    double half = p.largo / 2.0;
+    double paso = p.largo / malla;
+    int idx = 0;
+    for (int i = 0; i < malla && idx < p.n; i++) {
+        for (int j = 0; j < malla && idx < p.n; j++) {
+            for (int k = 0; k < malla && idx < p.n; k++) {
+                std::array<double, 3> pos{-half + (i + 0.5) * paso, -half + (j + 0.5) * paso,
+                                          -half + (k + 0.5) * paso};
+                double cz = 2.0 * uniforme(rng) - 1.0;
+                double phi = 2.0 * 3.14159265358979323846 * uniforme(rng);
+                double v = p.vmax * uniforme(rng);
+                double sz = std::sqrt(1.0 - cz * cz);
+                f(idx, pos, std::array<double, 3>{v * sz * std::cos(phi), v * sz * std::sin(phi), v * cz});
+                idx++;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Coloca las esferas en una malla centrada con velocidades aleatorias.
+ *
+ * @param sis Sistema a inicializar (se redimensiona a p.n).
+ * @param p Parámetros de la corrida.
+ * @param rng Generador de números aleatorios propio de la corrida.
+ */
+template <typename T>
+void inicializarEsferas(SistemaParticulasT<T, 2> &sis, const ParametrosCaja &p, std::mt19937_64 &rng) {
+    sis.inicio(p.n, p.m, p.R);
+    recorrerMallaInicial(p, rng, [&](int idx, double x0, double y0, double vx0, double vy0) {
+        sis.fijar(idx, x0, y0, vx0, vy0);
+    });
+}
+
+/**
+ * @brief Igual que la versión 2D, con la malla cúbica de recorrerMallaInicial3D().
+ */
+template <typename T>
+void inicializarEsferas(SistemaParticulasT<T, 3> &sis, const ParametrosCaja &p, std::mt19937_64 &rng) {
+    sis.inicio(p.n, p.m, p.R);
+    recorrerMallaInicial3D(p, rng, [&](int idx, const std::array<double, 3> &x, const std::array<double, 3> &v) {
+        sis.fijar(idx, {T(x[0]), T(x[1]), T(x[2])}, {T(v[0]), T(v[1]), T(v[2])});
+    });
+}
+
+/**
+ * @brief Corre una caja de tipo @p T y dimensión @p Dim con paso fijo y sin salidas a disco.
+ * @param p Parámetros de la corrida (se ignoran p.dim y p.simple).
+ * @return Observables promediados sobre los p.pasos pasos.
+ */
+template <typename T, int Dim>
+ResultadoCaja simularCajaT(const ParametrosCaja &p) {
+    std::mt19937_64 rng(p.semilla);
+    T half = static_cast<T>(p.largo / 2.0);
+    std::array<T, Dim> a, b;
+    a.fill(-half);
+    b.fill(half);
+    CajasT<T, Dim> caja;
+    caja.inicio(a, b);
+    SistemaParticulasT<T, Dim> esferas;
+    inicializarEsferas(esferas, p, rng);
+
+    MallaCeldasT<Dim> malla;
+    malla.inicio(caja, p.R);
+    caja.actualizarPresion();
+    for (int step = 0; step < p.pasos; step++) {
+        malla.construir(esferas);
+        malla.recorrerPares([&](int i, int j) { esferas.colision(i, j); });
+        esferas.rebotePared(caja);
+        esferas.muevase(p.dt);
+    }
+
+    ResultadoCaja r;
+    caja.calcularPresion();
+    r.presion = caja.Getp();
+    r.presionMecanica = caja.GetpMecanica(p.pasos * p.dt);
+    r.choques = caja.Getchoques();
+    r.kT = p.n > 0 ? 2 * esferas.energiaCinetica() / (Dim * p.n) : 0;
+    return r;
+}
+
+/**
+ * @brief Corre una caja completa con paso fijo y sin salidas a disco.
+ * @param p Parámetros de la corrida; p.dim y p.simple eligen la versión.
+ * @return Observables promediados sobre los p.pasos pasos.
+ */
+inline ResultadoCaja simularCaja(const ParametrosCaja &p) {
+    if (p.dim == 3) return p.simple ? simularCajaT<float, 3>(p) : simularCajaT<double, 3>(p);
+    return p.simple ? simularCajaT<float, 2>(p) : simularCajaT<double, 2>(p);
+}
+
+#endif  // SIMULACION_HPP
@@ -0,0 +1,537 @@
+/**
+ * @file SistemaParticulas.hpp
+ * @brief Almacén de partículas en formato estructura de arreglos (SoA).
+ *
+ * En lugar de un std::vector<Esfera>, donde cada esfera guarda intercalados
+ * m, x, y, vx, vy y R, aquí cada campo vive en su propio arreglo
+ * contiguo. Los recorridos de movimiento, rebote y colisión sólo leen los
+ * campos que usan, y los bucles quedan listos para vectorizar o repartir
+ * entre hilos.
+ *
+ * SistemaParticulasT es una plantilla sobre el tipo escalar y la dimensión,
+ * igual que EsferaT y CajasT. El alias SistemaParticulas (double, 2D) es el
+ * que usa el bucle principal y usa los núcleos AVX2/AVX-512 de KernelsSimd;
+ * las demás combinaciones (p. ej. cajas 3D en el modo por lotes) recorren
+ * los mismos campos con bucles escalares genéricos.
+ *
+ * @authors
+ * - Santiago Suárez
+ * - Eric Arciniegas
+ */
+
+#ifndef SISTEMA_PARTICULAS_HPP
+#define SISTEMA_PARTICULAS_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <type_traits>
+#include <vector>
+#include "Esfera.hpp"
+#include "FisicaComun.hpp"
+#include "Instrumentacion.hpp"
+#include "KernelsSimd.hpp"
+#include "Observables.hpp"
+
+template <typename T, int Dim>
+class SistemaParticulasT;
+
+/// Sistema original: double y 2D.
+using SistemaParticulas = SistemaParticulasT<double, 2>;
+
+/**
+ * @class EsferaVista
+ * @brief Vista ligera con la interfaz de Esfera sobre una partícula del sistema.
+ *
+ * Permite que el código escrito para Esfera (Getx(), Getv(), colision(), ...)
+ * siga funcionando sin copiar datos.
+ */
+class EsferaVista {
+private:
+    SistemaParticulas *sis;  ///< Sistema al que pertenece la partícula.
+    int i;                   ///< Índice de la partícula.
+
+public:
+    EsferaVista(SistemaParticulas *s, int idx) : sis(s), i(idx) {}
+
+    double Getx() const;
+    double Gety() const;
+    double Getvx() const;
+    double Getvy() const;
+    double Getv() const;
+    double Gettheta() const;
+    double Getm() const;
+    double GetR() const;
+    void muevase(double t);
+    void rebotePared(Cajas &caja);
+    void colision(EsferaVista otra);
+};
+
+/**
+ * @class SistemaParticulasT
+ * @brief Conjunto de esferas guardado como arreglos paralelos.
+ *
+ * La masa y el radio son opcionales por partícula: mientras todas compartan
+ * el mismo valor sólo se guarda un escalar, y los arreglos se crean la
+ * primera vez que se asigna un valor distinto.
+ *
+ * Los observables (Observables) y las vistas EsferaVista son de 2D; en 3D
+ * la energía se calcula con energiaCinetica().
+ *
+ * @tparam T Tipo escalar de posiciones, velocidades, masas y radios.
+ * @tparam Dim Número de dimensiones (2 o 3).
+ */
+template <typename T, int Dim>
+class SistemaParticulasT {
+    static_assert(Dim == 2 || Dim == 3, "El sistema debe ser 2D o 3D");
+
+    /// Los núcleos de KernelsSimd y FisicaComun son de double y 2D.
+    static constexpr bool kDoble2D = std::is_same<T, double>::value && Dim == 2;
+
+private:
+    std::array<std::vector<T>, Dim> pos;  ///< Posiciones, un arreglo por eje.
+    std::array<std::vector<T>, Dim> vel;  ///< Velocidades, un arreglo por eje.
+    std::vector<T> m, R;         ///< Masas y radios (vacíos si son uniformes).
+    std::vector<int> id;         ///< Índice original de cada ranura (vacío si no se ha reordenado).
+    T m0, R0;                    ///< Masa y radio comunes.
+    Observables *obs = nullptr;  ///< Observables que se actualizan con cada evento (sólo 2D).
+
+    /// Rapidez al cuadrado de la partícula @p i.
+    T v2(int i) const {
+        T s = 0;
+        paraCadaDim<Dim>([&](auto d) { s += vel[d][i] * vel[d][i]; });
+        return s;
+    }
+
+public:
+    static constexpr int kDim = Dim;
+    using Escalar = T;
+
+    /**
+     * @brief Reserva @p n partículas en reposo en el origen.
+     * @param n Número de partículas.
+     * @param masa Masa común.
+     * @param radio Radio común.
+     */
+    void inicio(int n, T masa, T radio) {
+        for (int d = 0; d < Dim; d++) {
+            pos[d].assign(n, T(0));
+            vel[d].assign(n, T(0));
+        }
+        m.clear();
+        R.clear();
+        id.clear();
+        m0 = masa;
+        R0 = radio;
+    }
+
+    /**
+     * @brief Asigna posición y velocidad a la partícula @p i en cualquier dimensión.
+     */
+    void fijar(int i, const std::array<T, Dim> &p, const std::array<T, Dim> &v) {
+        for (int d = 0; d < Dim; d++) {
+            pos[d][i] = p[d];
+            vel[d][i] = v[d];
+        }
+    }
+
+    /**
+     * @brief Asigna posición y velocidad a la partícula @p i (2D).
+     */
+    template <int D = Dim, std::enable_if_t<(D == 2), int> = 0>
+    void fijar(int i, T x0, T y0, T vx0, T vy0) {
+        pos[0][i] = x0;
+        pos[1][i] = y0;
+        vel[0][i] = vx0;
+        vel[1][i] = vy0;
+    }
+
+    /**
+     * @brief Conecta unos observables que se corrigen con cada colisión y rebote (2D).
+     *
+     * Se sincronizan una vez (O(N)) con la energía y el momento actuales;
+     * @p o = nullptr los desconecta.
+     */
+    template <int D = Dim, std::enable_if_t<(D == 2), int> = 0>
+    void conectar(Observables *o) {
+        obs = o;
+        if (!obs) return;
+        double Px = 0, Py = 0;
+        for (int i = 0; i < size(); i++) {
+            Px += Getm(i) * vel[0][i];
+            Py += Getm(i) * vel[1][i];
+        }
+        obs->fijar(energiaCinetica(), Px, Py);
+    }
+
+    /**
+     * @brief Devuelve los observables conectados (o nullptr).
+     */
+    Observables *Getobservables() const { return obs; }
+
+    /**
+     * @brief Asigna el identificador estable de la partícula @p i (al reanudar).
+     */
+    void fijarId(int i, int ident) {
+        if (id.empty()) {
+            if (ident == i) return;
+            id.resize(size());
+            for (int k = 0; k < size(); k++) id[k] = k;
+        }
+        id[i] = ident;
+    }
+
+    /**
+     * @brief Asigna una masa propia a la partícula @p i.
+     */
+    void fijarMasa(int i, T masa) {
+        if (m.empty()) {
+            if (masa == m0) return;
+            m.assign(size(), m0);
+        }
+        m[i] = masa;
+    }
+
+    /**
+     * @brief Asigna un radio propio a la partícula @p i.
+     */
+    void fijarRadio(int i, T radio) {
+        if (R.empty()) {
+            if (radio == R0) return;
+            R.assign(size(), R0);
+        }
+        R[i] = radio;
+    }
+
+    // --- Acceso por partícula ---
+    int size() const { return static_cast<int>(pos[0].size()); }
+    T Getpos(int i, int d) const { return pos[d][i]; }
+    T Getvel(int i, int d) const { return vel[d][i]; }
+    T Getx(int i) const { return pos[0][i]; }
+    T Gety(int i) const { return pos[1][i]; }
+    T Getvx(int i) const { return vel[0][i]; }
+    T Getvy(int i) const { return vel[1][i]; }
+    T Getv(int i) const { return std::sqrt(v2(i)); }
+    T Getm(int i) const { return m.empty() ? m0 : m[i]; }
+    T GetR(int i) const { return R.empty() ? R0 : R[i]; }
+
+    template <int D = Dim, std::enable_if_t<(D == 2), int> = 0>
+    T Gettheta(int i) const {
+        return std::atan2(vel[1][i], vel[0][i]);
+    }
+
+    T GetmComun() const { return m0; }
+    T GetRComun() const { return R0; }
+    bool masasPropias() const { return !m.empty(); }
+    bool radiosPropios() const { return !R.empty(); }
+
+    /**
+     * @brief Índice original (identificador estable) de la partícula en la ranura @p i.
+     */
+    int Getid(int i) const { return id.empty() ? i : id[i]; }
+
+    /**
+     * @brief Devuelve el radio máximo (para dimensionar las celdas).
+     */
+    T GetRmax() const {
+        return R.empty() ? R0 : *std::max_element(R.begin(), R.end());
+    }
+
+    // --- Acceso a los arreglos ---
+    T *datos(int d) { return pos[d].data(); }
+    T *datosV(int d) { return vel[d].data(); }
+    const T *datos(int d) const { return pos[d].data(); }
+    const T *datosV(int d) const { return vel[d].data(); }
+    T *datosX() { return pos[0].data(); }
+    T *datosY() { return pos[1].data(); }
+    T *datosVX() { return vel[0].data(); }
+    T *datosVY() { return vel[1].data(); }
+    const T *datosX() const { return pos[0].data(); }
+    const T *datosY() const { return pos[1].data(); }
+    const T *datosVX() const { return vel[0].data(); }
+    const T *datosVY() const { return vel[1].data(); }
+
+    /**
+     * @brief Rapidez de todas las partículas en un solo recorrido vectorizado.
+     */
+    void rapideces(std::vector<T> &v) const {
+        v.resize(size());
+        if constexpr (kDoble2D) {
+            simd::rapideces(vel[0].data(), vel[1].data(), size(), v.data());
+        } else {
+            for (int i = 0; i < size(); i++) v[i] = Getv(i);
+        }
+    }
+
+    /**
+     * @brief Ángulo de la velocidad de todas las partículas (para diagnósticos, 2D).
+     *
+     * La dinámica sólo guarda posición y velocidad; el ángulo se calcula aquí
+     * en bloque cuando se necesita.
+     */
+    template <int D = Dim, std::enable_if_t<(D == 2), int> = 0>
+    void angulos(std::vector<T> &theta) const {
+        theta.resize(size());
+        if constexpr (kDoble2D) {
+            simd::angulos(vel[0].data(), vel[1].data(), size(), theta.data());
+        } else {
+            for (int i = 0; i < size(); i++) theta[i] = Gettheta(i);
+        }
+    }
+
+    /**
+     * @brief Reordena las partículas: la ranura k pasa a tener la que estaba en @p orden[k].
+     *
+     * Se permutan todos los campos y los identificadores, de modo que
+     * Getid() sigue devolviendo el índice original de cada esfera.
+     */
+    void permutar(const std::vector<int> &orden) { seleccionar(orden); }
+
+    /**
+     * @brief Conserva sólo las ranuras de @p orden, en ese orden (las demás se descartan).
+     *
+     * Con @p orden de tamaño size() es una permutación; más corto, quita
+     * partículas (por ejemplo, las que migran a otro subdominio).
+     */
+    void seleccionar(const std::vector<int> &orden) {
+        int n = size();
+        int k = static_cast<int>(orden.size());
+        if (id.empty()) {
+            id.resize(n);
+            for (int i = 0; i < n; i++) id[i] = i;
+        }
+        std::vector<T> tmp(k);
+        auto aplicar = [&](std::vector<T> &v) {
+            if (v.empty()) return;
+            tmp.resize(k);
+            for (int s = 0; s < k; s++) tmp[s] = v[orden[s]];
+            v.swap(tmp);
+        };
+        for (int d = 0; d < Dim; d++) aplicar(pos[d]);
+        for (int d = 0; d < Dim; d++) aplicar(vel[d]);
+        aplicar(m);
+        aplicar(R);
+        std::vector<int> idn(k);
+        for (int s = 0; s < k; s++) idn[s] = id[orden[s]];
+        id.swap(idn);
+    }
+
+    /**
+     * @brief Agrega al final una partícula con masa y radio comunes (2D).
+     * @param ident Identificador estable (índice en la corrida completa).
+     */
+    template <int D = Dim, std::enable_if_t<(D == 2), int> = 0>
+    void agregar(T x0, T y0, T vx0, T vy0, int ident) {
+        int i = size();
+        pos[0].push_back(x0);
+        pos[1].push_back(y0);
+        vel[0].push_back(vx0);
+        vel[1].push_back(vy0);
+        if (!m.empty()) m.push_back(m0);
+        if (!R.empty()) R.push_back(R0);
+        if (!id.empty()) id.push_back(i);
+        fijarId(i, ident);
+    }
+
+    /**
+     * @brief Vista tipo Esfera de la partícula @p i (sólo double y 2D).
+     */
+    template <bool S = kDoble2D, std::enable_if_t<S, int> = 0>
+    EsferaVista operator[](int i) {
+        return EsferaVista(this, i);
+    }
+
+    /**
+     * @brief Avanza todas las partículas un tiempo @p t (núcleo SIMD).
+     */
+    void muevase(T t) { muevaseRango(0, size(), t); }
+
+    /**
+     * @brief Avanza las partículas [a, b) un tiempo @p t.
+     */
+    void muevaseRango(int a, int b, T t) {
+        if constexpr (kDoble2D) {
+            simd::muevase(pos[0].data() + a, pos[1].data() + a, vel[0].data() + a, vel[1].data() + a,
+                          b - a, t);
+        } else {
+            for (int d = 0; d < Dim; d++) {
+                T *p = pos[d].data();
+                const T *v = vel[d].data();
+                for (int i = a; i < b; i++) p[i] += v[i] * t;
+            }
+        }
+    }
+
+    /**
+     * @brief Avanza una sola partícula un tiempo @p t.
+     */
+    void muevase(int i, T t) {
+        paraCadaDim<Dim>([&](auto d) { pos[d][i] += vel[d][i] * t; });
+    }
+
+    /**
+     * @brief Rebota la partícula @p i contra las paredes (igual que EsferaT::rebotePared).
+     */
+    void rebotePared(int i, CajasT<T, Dim> &caja) {
+        T r = GetR(i);
+        T mi = Getm(i);
+        paraCadaDim<Dim>([&](auto d) {
+            if ((pos[d][i] - caja.Getmin(d)) <= r || (caja.Getmax(d) - pos[d][i]) <= r) {
+                vel[d][i] = -vel[d][i];
+                caja.calcularPresionN(mi * v2(i));
+                caja.registrarImpulso(2 * mi * std::fabs(vel[d][i]));
+            }
+        });
+    }
+
+    /**
+     * @brief Rebota las partículas [a, b) y suma sus contribuciones en @p res.
+     *
+     * Con masa y radio uniformes en double y 2D se usa el núcleo SIMD. No
+     * modifica la caja, de modo que varios hilos pueden procesar rangos
+     * distintos a la vez. @p res sólo lleva el momento en X e Y.
+     */
+    void reboteParedRango(int a, int b, const CajasT<T, Dim> &caja, simd::ResultadoParedes &res) {
+        if constexpr (kDoble2D) {
+            if (m.empty() && R.empty()) {
+                simd::Limites l{caja.Getxmin() + R0, caja.Getxmax() - R0,
+                                caja.Getymin() + R0, caja.Getymax() - R0};
+                simd::rebotePared(pos[0].data() + a, pos[1].data() + a, vel[0].data() + a,
+                                  vel[1].data() + a, b - a, m0, l, res);
+                return;
+            }
+        }
+        for (int i = a; i < b; i++) {
+            T r = GetR(i);
+            T mi = Getm(i);
+            T v2i = v2(i);
+            paraCadaDim<Dim>([&](auto d) {
+                if ((pos[d][i] - caja.Getmin(d)) <= r || (caja.Getmax(d) - pos[d][i]) <= r) {
+                    vel[d][i] = -vel[d][i];
+                    res.sumaMv2 += mi * v2i;
+                    res.choques += 1;
+                    res.impulso += 2 * mi * std::fabs(vel[d][i]);
+                    if (d == 0) res.dPx += 2 * mi * vel[d][i];
+                    if (d == 1) res.dPy += 2 * mi * vel[d][i];
+                }
+            });
+        }
+    }
+
+    /**
+     * @brief Rebota todas las partículas contra las paredes de la caja.
+     *
+     * La presión se acumula en la caja una sola vez por recorrido.
+     */
+    void rebotePared(CajasT<T, Dim> &caja) {
+        simd::ResultadoParedes r;
+        reboteParedRango(0, size(), caja, r);
+        caja.acumularPresion(r.sumaMv2, r.choques, r.impulso);
+        CAJA_CONTAR(instr::kChoquesPared, r.choques);
+        if (obs) obs->paredes(r.dPx, r.dPy, r.choques);
+    }
+
+    /**
+     * @brief Energía cinética total del sistema.
+     */
+    double energiaCinetica() const {
+        int n = size();
+        if constexpr (kDoble2D) {
+            if (m.empty()) return 0.5 * m0 * simd::sumaV2(vel[0].data(), vel[1].data(), n);
+        }
+        double e = 0;
+        for (int i = 0; i < n; i++) e += 0.5 * Getm(i) * v2(i);
+        return e;
+    }
+
+    /**
+     * @brief Resuelve la colisión elástica entre @p i y @p j (igual que EsferaT::colision).
+     *
+     * Si hay observables conectados se les aplica el cambio de energía y momento.
+     */
+    void colision(int i, int j) {
+        if (!obs) {
+            colision(i, j, nullptr);
+            return;
+        }
+        DeltaObservables d;
+        if (colision(i, j, &d)) obs->colision(d);
+    }
+
+    /**
+     * @brief Colisión entre @p i y @p j que anota su efecto en @p d.
+     *
+     * Pensada para los recorridos en paralelo: cada hilo suma en su propio
+     * acumulador y luego se suman en un orden fijo. @p d lleva el momento
+     * en X e Y.
+     *
+     * @return true si las esferas se tocaban y se cambiaron sus velocidades.
+     */
+    bool colision(int i, int j, DeltaObservables *d) {
+        CAJA_CONTAR(instr::kParesProbados, 1);
+        std::array<T, Dim> n;
+        if constexpr (kDoble2D) {
+            T dx = pos[0][j] - pos[0][i];
+            T dy = pos[1][j] - pos[1][i];
+            if (!fisica::normalContacto(dx, dy, GetR(i) + GetR(j), n[0], n[1])) return false;
+        } else {
+            T dist2 = 0;
+            paraCadaDim<Dim>([&](auto k) {
+                n[k] = pos[k][j] - pos[k][i];
+                dist2 += n[k] * n[k];
+            });
+            T Rsum = GetR(i) + GetR(j);
+            if (dist2 > Rsum * Rsum) return false;
+            T dist = std::sqrt(dist2);
+            if (dist == 0) return false;
+            paraCadaDim<Dim>([&](auto k) { n[k] /= dist; });
+        }
+
+        double Kantes = 0, Pxantes = 0, Pyantes = 0;
+        if (d) {
+            double mi = Getm(i), mj = Getm(j);
+            Kantes = 0.5 * (mi * v2(i) + mj * v2(j));
+            Pxantes = mi * vel[0][i] + mj * vel[0][j];
+            Pyantes = mi * vel[1][i] + mj * vel[1][j];
+        }
+
+        if constexpr (kDoble2D) {
+            fisica::intercambiarNormal(n[0], n[1], vel[0][i], vel[1][i], vel[0][j], vel[1][j]);
+        } else {
+            T vn1 = 0, vn2 = 0;
+            paraCadaDim<Dim>([&](auto k) {
+                vn1 += vel[k][i] * n[k];
+                vn2 += vel[k][j] * n[k];
+            });
+            paraCadaDim<Dim>([&](auto k) {
+                vel[k][i] += (vn2 - vn1) * n[k];
+                vel[k][j] += (vn1 - vn2) * n[k];
+            });
+        }
+        CAJA_CONTAR(instr::kColisionesResueltas, 1);
+
+        if (d) {
+            double mi = Getm(i), mj = Getm(j);
+            d->dK += 0.5 * (mi * v2(i) + mj * v2(j)) - Kantes;
+            d->dPx += mi * vel[0][i] + mj * vel[0][j] - Pxantes;
+            d->dPy += mi * vel[1][i] + mj * vel[1][j] - Pyantes;
+            d->eventos++;
+        }
+        return true;
+    }
+};
+
+// --- Implementación de EsferaVista ---
+inline double EsferaVista::Getx() const { return sis->Getx(i); }
+inline double EsferaVista::Gety() const { return sis->Gety(i); }
+inline double EsferaVista::Getvx() const { return sis->Getvx(i); }
+inline double EsferaVista::Getvy() const { return sis->Getvy(i); }
+inline double EsferaVista::Getv() const { return sis->Getv(i); }
+inline double EsferaVista::Gettheta() const { return sis->Gettheta(i); }
+inline double EsferaVista::Getm() const { return sis->Getm(i); }
+inline double EsferaVista::GetR() const { return sis->GetR(i); }
+inline void EsferaVista::muevase(double t) { sis->muevase(i, t); }
+inline void EsferaVista::rebotePared(Cajas &caja) { sis->rebotePared(i, caja); }
+inline void EsferaVista::colision(EsferaVista otra) { sis->colision(i, otra.i); }
+
+#endif  // SISTEMA_PARTICULAS_HPP
@@ -0,0 +1,335 @@
+/**
+ * @file Trayectoria.hpp
+ * @brief Formato binario de trayectorias: escritura por frames y lectura con mmap.
+ *
+ * Un archivo por corrida, con una cabecera fija seguida de frames del mismo
+ * tamaño; una corrida reanudada sigue agregando frames al mismo archivo
+ * (EscritorTrayectoria::continuar). Cada frame guarda el paso, el tiempo y, para cada esfera, los
+ * valores x, y, vx, vy como float64 intercalados, de modo que gnuplot puede
+ * leerlo directamente con @c binary (ver LectorTrayectoria::formatoGnuplot).
+ *
+ * Disposición (little-endian, todo alineado a 8 bytes):
+ * @code
+ *   cabecera (80 bytes) | frame 0 | frame 1 | ...
+ *   frame = int64 paso | float64 t | N × {x, y, vx, vy}
+ * @endcode
+ *
+ * @authors
+ * - Santiago Suárez
+ * - Eric Arciniegas
+ */
+
+#ifndef TRAYECTORIA_HPP
+#define TRAYECTORIA_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "Esfera.hpp"
+#include "Instrumentacion.hpp"
+#include "SistemaParticulas.hpp"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @struct CabeceraTrayectoria
+ * @brief Cabecera de 80 bytes al inicio de cada archivo de trayectoria.
+ */
+struct CabeceraTrayectoria {
+    char magia[8];        ///< "CAJATRJ" + '\0'.
+    uint32_t version;     ///< Versión del formato (1).
+    uint32_t campos;      ///< Valores por esfera (4: x, y, vx, vy).
+    int64_t n;            ///< Número de esferas.
+    double xmin, xmax;    ///< Límites de la caja en X.
+    double ymin, ymax;    ///< Límites de la caja en Y.
+    double dt;            ///< Paso temporal de la simulación.
+    int64_t cada;         ///< Se guarda un frame cada @c cada pasos.
+    int64_t frames;       ///< Frames escritos (se actualiza al cerrar).
+};
+static_assert(sizeof(CabeceraTrayectoria) == 80, "cabecera de trayectoria con relleno inesperado");
+
+/**
+ * @class EscritorTrayectoria
+ * @brief Agrega frames a un archivo de trayectoria con E/S en búfer.
+ */
+class EscritorTrayectoria {
+private:
+    std::FILE *archivo = nullptr;
+    CabeceraTrayectoria cab;
+    std::vector<double> registro;  ///< Frame intercalado listo para escribir.
+    std::vector<char> bufer;       ///< Búfer de stdio.
+    long long bytes = 0;           ///< Bytes escritos en total.
+
+public:
+    ~EscritorTrayectoria() { cerrar(); }
+
+    /**
+     * @brief Abre el archivo y escribe la cabecera.
+     * @param ruta Ruta del archivo (se sobrescribe).
+     * @param caja Caja de la simulación.
+     * @param n Número de esferas.
+     * @param dt Paso temporal.
+     * @param cada Frecuencia de guardado en pasos.
+     * @return false si no se pudo abrir el archivo.
+     */
+    bool abrir(const std::string &ruta, const Cajas &caja, int n, double dt, int cada) {
+        cerrar();
+        archivo = std::fopen(ruta.c_str(), "wb");
+        if (!archivo) return false;
+        bufer.resize(1 << 22);
+        std::setvbuf(archivo, bufer.data(), _IOFBF, bufer.size());
+
+        std::memset(&cab, 0, sizeof(cab));
+        std::memcpy(cab.magia, "CAJATRJ", 8);
+        cab.version = 1;
+        cab.campos = 4;
+        cab.n = n;
+        cab.xmin = caja.Getxmin();
+        cab.xmax = caja.Getxmax();
+        cab.ymin = caja.Getymin();
+        cab.ymax = caja.Getymax();
+        cab.dt = dt;
+        cab.cada = cada;
+        cab.frames = 0;
+        std::fwrite(&cab, sizeof(cab), 1, archivo);
+        bytes = sizeof(cab);
+        registro.resize(4 * static_cast<size_t>(n));
+        return true;
+    }
+
+    /**
+     * @brief Reabre una trayectoria existente para seguir agregando frames.
+     *
+     * Conserva los frames anteriores a @p paso_inicial y descarta los que la
+     * corrida interrumpida haya escrito desde ese paso, que se van a repetir.
+     * Si el archivo no existe se crea uno nuevo, como con abrir().
+     * @param paso_inicial Paso desde el que se reanuda.
+     * @return false si no se pudo abrir, o si el archivo es de otra corrida
+     * (otro número de esferas o de frecuencia de guardado).
+     */
+    bool continuar(const std::string &ruta, const Cajas &caja, int n, double dt, int cada, int paso_inicial) {
+        cerrar();
+        std::FILE *f = std::fopen(ruta.c_str(), "rb");
+        if (!f) return abrir(ruta, caja, n, dt, cada);
+        CabeceraTrayectoria previa;
+        if (std::fread(&previa, sizeof(previa), 1, f) != 1 || std::memcmp(previa.magia, "CAJATRJ", 8) != 0 ||
+            previa.version != 1 || previa.n != n || previa.cada != cada) {
+            std::fclose(f);
+            return false;
+        }
+        const long tam = 16 + sizeof(double) * previa.campos * previa.n;
+        std::fseek(f, 0, SEEK_END);
+        const long en_disco = (std::ftell(f) - static_cast<long>(sizeof(previa))) / tam;
+        // Los frames van en orden de paso: se conservan los anteriores al de reanudación.
+        long k = 0;
+        for (int64_t p; k < en_disco; k++) {
+            std::fseek(f, sizeof(previa) + k * tam, SEEK_SET);
+            if (std::fread(&p, sizeof(p), 1, f) != 1 || p >= paso_inicial) break;
+        }
+        std::fclose(f);
+        bytes = sizeof(previa) + k * tam;
+#ifndef _WIN32
+        if (::truncate(ruta.c_str(), bytes) != 0) return false;
+#endif  // en Windows los frames sobrantes se sobrescriben, pero el archivo no se acorta
+
+        archivo = std::fopen(ruta.c_str(), "r+b");
+        if (!archivo) return false;
+        bufer.resize(1 << 22);
+        std::setvbuf(archivo, bufer.data(), _IOFBF, bufer.size());
+        std::fseek(archivo, bytes, SEEK_SET);
+        cab = previa;
+        cab.frames = k;
+        registro.resize(4 * static_cast<size_t>(n));
+        return true;
+    }
+
+    /**
+     * @brief Indica si el paso @p paso debe guardarse según @c cada.
+     */
+    bool toca(int paso) const { return archivo && paso % cab.cada == 0; }
+
+    /**
+     * @brief Agrega un frame con el estado actual del sistema.
+     * @param paso Número de paso.
+     * @param t Tiempo de simulación.
+     * @param sis Partículas (se escriben en el orden de Getid(), aunque se hayan reordenado).
+     */
+    void escribir(int paso, double t, const SistemaParticulas &sis) {
+        if (!archivo) return;
+        const double *x = sis.datosX(), *y = sis.datosY();
+        const double *vx = sis.datosVX(), *vy = sis.datosVY();
+        int n = sis.size();
+        for (int i = 0; i < n; i++) {
+            int k = sis.Getid(i);  // el archivo va siempre en el orden original
+            registro[4 * k] = x[i];
+            registro[4 * k + 1] = y[i];
+            registro[4 * k + 2] = vx[i];
+            registro[4 * k + 3] = vy[i];
+        }
+        int64_t p = paso;
+        std::fwrite(&p, sizeof(p), 1, archivo);
+        std::fwrite(&t, sizeof(t), 1, archivo);
+        std::fwrite(registro.data(), sizeof(double), registro.size(), archivo);
+        bytes += 16 + sizeof(double) * static_cast<long long>(registro.size());
+        CAJA_CONTAR(instr::kBytesEscritos, 16 + sizeof(double) * registro.size());
+        cab.frames++;
+    }
+
+    /**
+     * @brief Actualiza el número de frames en la cabecera y cierra el archivo.
+     */
+    void cerrar() {
+        if (!archivo) return;
+        std::fseek(archivo, 0, SEEK_SET);
+        std::fwrite(&cab, sizeof(cab), 1, archivo);
+        std::fclose(archivo);
+        archivo = nullptr;
+    }
+
+    /**
+     * @brief Devuelve los bytes escritos.
+     */
+    long long Getbytes() const { return bytes; }
+};
+
+/**
+ * @class LectorTrayectoria
+ * @brief Acceso aleatorio a los frames de un archivo de trayectoria.
+ *
+ * En sistemas POSIX el archivo se proyecta en memoria con mmap y los frames
+ * se leen sin copiar; en Windows se carga completo en memoria.
+ */
+class LectorTrayectoria {
+private:
+    const char *datos = nullptr;
+    size_t tam = 0;
+    std::vector<char> copia;  ///< Respaldo sin mmap.
+    CabeceraTrayectoria cab;
+    long frames = 0;
+
+    size_t tamFrame() const { return 16 + sizeof(double) * cab.campos * cab.n; }
+
+public:
+    ~LectorTrayectoria() { cerrar(); }
+
+    /**
+     * @brief Abre un archivo de trayectoria.
+     * @return false si no existe o no tiene el formato esperado.
+     */
+    bool abrir(const std::string &ruta) {
+        cerrar();
+#ifndef _WIN32
+        int fd = ::open(ruta.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(cab))) {
+            ::close(fd);
+            return false;
+        }
+        tam = static_cast<size_t>(st.st_size);
+        void *p = ::mmap(nullptr, tam, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) return false;
+        datos = static_cast<const char *>(p);
+#else
+        std::FILE *f = std::fopen(ruta.c_str(), "rb");
+        if (!f) return false;
+        std::fseek(f, 0, SEEK_END);
+        tam = static_cast<size_t>(std::ftell(f));
+        std::fseek(f, 0, SEEK_SET);
+        copia.resize(tam);
+        tam = std::fread(copia.data(), 1, tam, f);
+        std::fclose(f);
+        if (tam < sizeof(cab)) return false;
+        datos = copia.data();
+#endif
+        std::memcpy(&cab, datos, sizeof(cab));
+        if (std::memcmp(cab.magia, "CAJATRJ", 8) != 0 || cab.version != 1) {
+            cerrar();
+            return false;
+        }
+        // Los frames completos en disco mandan: sirve aun si la corrida se cortó.
+        frames = static_cast<long>((tam - sizeof(cab)) / tamFrame());
+        return true;
+    }
+
+    /**
+     * @brief Libera el archivo proyectado.
+     */
+    void cerrar() {
+#ifndef _WIN32
+        if (datos) ::munmap(const_cast<char *>(datos), tam);
+#endif
+        datos = nullptr;
+        copia.clear();
+        tam = 0;
+        frames = 0;
+    }
+
+    const CabeceraTrayectoria &Getcabecera() const { return cab; }
+    long Getframes() const { return frames; }
+    int Getn() const { return static_cast<int>(cab.n); }
+
+    /**
+     * @brief Paso de simulación del frame @p k.
+     */
+    int64_t paso(long k) const {
+        int64_t p;
+        std::memcpy(&p, datos + sizeof(cab) + k * tamFrame(), sizeof(p));
+        return p;
+    }
+
+    /**
+     * @brief Tiempo del frame @p k.
+     */
+    double tiempo(long k) const {
+        double t;
+        std::memcpy(&t, datos + sizeof(cab) + k * tamFrame() + 8, sizeof(t));
+        return t;
+    }
+
+    /**
+     * @brief Registros {x, y, vx, vy} del frame @p k (4·N valores).
+     */
+    const double *registros(long k) const {
+        return reinterpret_cast<const double *>(datos + sizeof(cab) + k * tamFrame() + 16);
+    }
+
+    /**
+     * @brief Copia una columna (0: x, 1: y, 2: vx, 3: vy) del rango de esferas [a, b).
+     */
+    void rebanada(long k, int campo, int a, int b, double *destino) const {
+        const double *r = registros(k);
+        for (int i = a; i < b; i++) destino[i - a] = r[cab.campos * i + campo];
+    }
+
+    /**
+     * @brief Especificación de gnuplot para graficar el frame @p k.
+     *
+     * Por ejemplo: @c plot 'results/trayectoria.bin' <spec> using 1:2.
+     */
+    std::string formatoGnuplot(long k) const {
+        size_t salto = sizeof(cab) + k * tamFrame() + 16;
+        return "binary skip=" + std::to_string(salto) + " record=" + std::to_string(cab.n) +
+               " format='%" + std::to_string(cab.campos) + "float64'";
+    }
+
+    /**
+     * @brief Escribe el frame @p k como texto "x y vx vy" (para gnuplot '-').
+     */
+    void escribirTexto(long k, std::FILE *salida) const {
+        const double *r = registros(k);
+        for (int i = 0; i < cab.n; i++) {
+            std::fprintf(salida, "%g\t%g\t%g\t%g\n", r[4 * i], r[4 * i + 1], r[4 * i + 2], r[4 * i + 3]);
+        }
+    }
+};
+
+#endif  // TRAYECTORIA_HPP
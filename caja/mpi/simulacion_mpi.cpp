@@ -0,0 +1,83 @@
+/**
+ * @file simulacion_mpi.cpp
+ * @brief Caja grande repartida en franjas entre procesos MPI (make mpi).
+ *
+ * Corre el paso fijo de DominioMpi sin preguntas: los parámetros vienen de
+ * la línea de comandos, el proceso 0 escribe la presión por paso y al final
+ * todos imprimen lo mismo que el programa serial (P, P_mec y E con sus
+ * errores), más la energía y el número de esferas recontados como control.
+ *
+ * Uso:
+ * @code
+ *   mpirun -np 4 bin/simulacion_mpi --n 1000000 --largo 400 --vmax 5 --radio 0.1 --pasos 300
+ * @endcode
+ *
+ * @authors
+ * - Santiago Suárez
+ * - Eric Arciniegas
+ */
+
+#include <mpi.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "DominioMpi.hpp"
+#include "Simulacion.hpp"
+
+int main(int argc, char *argv[]) {
+    MPI_Init(&argc, &argv);
+
+    ParametrosCaja p;
+    std::string salida = "results/presion_mpi.dat";
+    for (int a = 1; a < argc; a++) {
+        if (std::strcmp(argv[a], "--n") == 0 && a + 1 < argc) p.n = std::atoi(argv[++a]);
+        else if (std::strcmp(argv[a], "--largo") == 0 && a + 1 < argc) p.largo = std::atof(argv[++a]);
+        else if (std::strcmp(argv[a], "--vmax") == 0 && a + 1 < argc) p.vmax = std::atof(argv[++a]);
+        else if (std::strcmp(argv[a], "--radio") == 0 && a + 1 < argc) p.R = std::atof(argv[++a]);
+        else if (std::strcmp(argv[a], "--dt") == 0 && a + 1 < argc) p.dt = std::atof(argv[++a]);
+        else if (std::strcmp(argv[a], "--pasos") == 0 && a + 1 < argc) p.pasos = std::atoi(argv[++a]);
+        else if (std::strcmp(argv[a], "--semilla") == 0 && a + 1 < argc) p.semilla = std::strtoull(argv[++a], nullptr, 10);
+        else if (std::strcmp(argv[a], "--salida") == 0 && a + 1 < argc) salida = argv[++a];
+    }
+
+    DominioMpi dominio;
+    bool raiz = dominio.Getrango() == 0;
+    if (p.largo / dominio.Getprocesos() < 4 * p.R || p.R >= radioMaximo(p.largo, p.n)) {
+        if (raiz) {
+            std::fprintf(stderr, "Cada franja debe medir al menos 4R y R < %g.\n", radioMaximo(p.largo, p.n));
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    dominio.inicio(p);
+
+    std::FILE *archivo = raiz ? std::fopen(salida.c_str(), "w") : nullptr;
+    if (raiz && !archivo) std::fprintf(stderr, "No se pudo abrir %s para escritura.\n", salida.c_str());
+
+    Cajas &caja = dominio.Getcaja();
+    Observables &obs = dominio.Getobservables();
+    auto t0 = std::chrono::steady_clock::now();
+    for (int step = 0; step < p.pasos; step++) {
+        caja.actualizarPresion();
+        dominio.paso(p.dt);
+        caja.calcularPresion();
+        obs.cerrarPaso(caja, p.dt);
+        if (archivo) std::fprintf(archivo, "%g\t%g\t%g\n", step * p.dt, caja.Getp(), caja.GetpMecanica(p.dt));
+    }
+    double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    if (archivo) std::fclose(archivo);
+
+    double energia = dominio.energiaGlobal();
+    long n = dominio.contarGlobal();
+    if (raiz) {
+        std::printf("%d procesos, %ld esferas, %d pasos en %.3f s\n", dominio.Getprocesos(), n, p.pasos, segundos);
+        std::printf("E recalculada = %.10g (observables: %.10g)\n", energia, obs.Getenergia());
+        std::printf("P = %g +- %g   P_mec = %g +- %g   E = %g +- %g\n", obs.GetestP().media(),
+                    obs.GetestP().error(), obs.GetestPmec().media(), obs.GetestPmec().error(),
+                    obs.GetestK().media(), obs.GetestK().error());
+    }
+    MPI_Finalize();
+    return 0;
+}
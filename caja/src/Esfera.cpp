@@ -0,0 +1,29 @@
+/**
+ * @file Esfera.cpp
+ * @brief Instanciaciones explícitas de las plantillas sobre tipo y dimensión.
+ *
+ * El bucle principal usa Cajas, Esfera y SistemaParticulas (double, 2D) y
+ * el modo por lotes corre además cajas 3D y en float (simularCaja). Aquí se
+ * instancian completas todas las combinaciones para que cada método, y no
+ * sólo los que se llaman, compile en cada build.
+ *
+ * @authors
+ * - Santiago Suárez
+ * - Eric Arciniegas
+ */
+
+#include "Esfera.hpp"
+#include "MallaCeldas.hpp"
+#include "SistemaParticulas.hpp"
+
+template class CajasT<float, 2>;
+template class EsferaT<float, 2>;
+template class CajasT<double, 3>;
+template class EsferaT<double, 3>;
+template class CajasT<float, 3>;
+template class EsferaT<float, 3>;
+
+template class SistemaParticulasT<float, 2>;
+template class SistemaParticulasT<double, 3>;
+template class SistemaParticulasT<float, 3>;
+template class MallaCeldasT<3>;
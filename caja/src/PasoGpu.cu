@@ -0,0 +1,341 @@
+/**
+ * @file PasoGpu.cu
+ * @brief Núcleos CUDA del paso fijo (ver PasoGpu.hpp); se compila con make CUDA=1.
+ *
+ * Un paso en el dispositivo:
+ *  -# celdas: cada hilo calcula la celda de una esfera (fisica::celda);
+ *  -# ordenamiento estable de los índices por celda (thrust) y comienzo de
+ *     cada celda por búsqueda binaria, igual que el conteo de MallaCeldas;
+ *  -# choques: un lanzamiento por color del calendario 3×3, un hilo por
+ *     celda, recorriendo los mismos pares que MallaCeldas::recorrerParesCelda;
+ *  -# paredes y movimiento: un hilo por esfera y una suma en árbol por bloque;
+ *  -# reducción: un bloque suma los parciales de los bloques y de las celdas
+ *     y se copian al host nueve números.
+ *
+ * Las sumas en árbol tienen un orden fijo, así que el resultado no cambia
+ * entre corridas en la misma tarjeta.
+ *
+ * @authors
+ * - Santiago Suárez
+ * - Eric Arciniegas
+ */
+
+#include <cstdio>
+#include <cuda_runtime.h>
+#include <thrust/binary_search.h>
+#include <thrust/execution_policy.h>
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/sort.h>
+#include "FisicaComun.hpp"
+#include "NucleosGpu.hpp"
+
+namespace gpu {
+
+namespace {
+
+const int kHilosBloque = 256;  ///< Hilos por bloque (potencia de 2, para la suma en árbol).
+
+/// Campos de fisica::ResultadoParedes y de los cambios por celda.
+const int kCamposParedes = 5;
+const int kCamposCelda = 4;
+
+bool revisar(cudaError_t err, const char *donde) {
+    if (err == cudaSuccess) return true;
+    std::fprintf(stderr, "CUDA (%s): %s\n", donde, cudaGetErrorString(err));
+    return false;
+}
+
+int bloquesPara(int n) { return (n + kHilosBloque - 1) / kHilosBloque; }
+
+/**
+ * @brief Suma en árbol de @c kHilosBloque valores en memoria compartida.
+ * @return La suma en el hilo 0 (los demás hilos reciben basura).
+ */
+__device__ double sumaBloque(double *s, double v) {
+    int t = threadIdx.x;
+    s[t] = v;
+    __syncthreads();
+    for (int k = kHilosBloque / 2; k > 0; k /= 2) {
+        if (t < k) s[t] += s[t + k];
+        __syncthreads();
+    }
+    double r = s[0];
+    __syncthreads();
+    return r;
+}
+
+__global__ void nucleoCeldas(int n, const double *x, const double *y, Geometria g, int *clave,
+                             int *orden) {
+    int i = blockIdx.x * blockDim.x + threadIdx.x;
+    if (i >= n) return;
+    clave[i] = fisica::celda(x[i], y[i], g.xmin, g.ymin, g.ladox, g.ladoy, g.nx, g.ny);
+    orden[i] = i;
+}
+
+/**
+ * @struct Particulas
+ * @brief Punteros del dispositivo que necesitan los núcleos de choques y paredes.
+ */
+struct Particulas {
+    double *x, *y, *vx, *vy;
+    const double *m, *R;  ///< nullptr si son uniformes.
+    double m0, R0;
+
+    __device__ double masa(int i) const { return m ? m[i] : m0; }
+    __device__ double radio(int i) const { return R ? R[i] : R0; }
+};
+
+/**
+ * @brief Choque entre @p i y @p j, con las mismas operaciones que SistemaParticulas::colision.
+ */
+__device__ void choque(const Particulas &p, int i, int j, bool conObs, double *acum) {
+    double nx, ny;
+    if (!fisica::normalContacto(p.x[j] - p.x[i], p.y[j] - p.y[i], p.radio(i) + p.radio(j), nx, ny)) {
+        return;
+    }
+    double mi = 0, mj = 0, Kantes = 0, Pxantes = 0, Pyantes = 0;
+    if (conObs) {
+        mi = p.masa(i);
+        mj = p.masa(j);
+        Kantes = 0.5 * (mi * (p.vx[i] * p.vx[i] + p.vy[i] * p.vy[i]) +
+                        mj * (p.vx[j] * p.vx[j] + p.vy[j] * p.vy[j]));
+        Pxantes = mi * p.vx[i] + mj * p.vx[j];
+        Pyantes = mi * p.vy[i] + mj * p.vy[j];
+    }
+    fisica::intercambiarNormal(nx, ny, p.vx[i], p.vy[i], p.vx[j], p.vy[j]);
+    if (conObs) {
+        acum[0] += 0.5 * (mi * (p.vx[i] * p.vx[i] + p.vy[i] * p.vy[i]) +
+                          mj * (p.vx[j] * p.vx[j] + p.vy[j] * p.vy[j])) - Kantes;
+        acum[1] += mi * p.vx[i] + mj * p.vx[j] - Pxantes;
+        acum[2] += mi * p.vy[i] + mj * p.vy[j] - Pyantes;
+    }
+    acum[3] += 1;
+}
+
+/**
+ * @brief Choques de las celdas de un color: un hilo por celda.
+ *
+ * Cada celda escribe sus cambios en @p deltas una sola vez por paso (cada
+ * celda tiene exactamente un color), así que no hace falta borrarlos.
+ */
+__global__ void nucleoChoques(int color, Geometria g, Particulas p, const int *orden,
+                              const int *comienzo, bool conObs, double *deltas) {
+    int ox = color % 3;
+    int oy = color / 3;
+    int mx = (g.nx - ox + 2) / 3;
+    int my = (g.ny - oy + 2) / 3;
+    int k = blockIdx.x * blockDim.x + threadIdx.x;
+    if (mx <= 0 || my <= 0 || k >= mx * my) return;
+    int cx = ox + 3 * (k % mx);
+    int cy = oy + 3 * (k / mx);
+    int c = cy * g.nx + cx;
+
+    double acum[kCamposCelda] = {0, 0, 0, 0};
+    for (int a = comienzo[c]; a < comienzo[c + 1]; a++) {
+        for (int b = a + 1; b < comienzo[c + 1]; b++) choque(p, orden[a], orden[b], conObs, acum);
+    }
+    const int vecinos[4][2] = {{1, 0}, {-1, 1}, {0, 1}, {1, 1}};
+    for (int v = 0; v < 4; v++) {
+        int vx = cx + vecinos[v][0];
+        int vy = cy + vecinos[v][1];
+        if (vx < 0 || vx >= g.nx || vy >= g.ny) continue;
+        int d = vy * g.nx + vx;
+        for (int a = comienzo[c]; a < comienzo[c + 1]; a++) {
+            for (int b = comienzo[d]; b < comienzo[d + 1]; b++) {
+                int i = orden[a];
+                int j = orden[b];
+                if (i < j) choque(p, i, j, conObs, acum);
+                else choque(p, j, i, conObs, acum);
+            }
+        }
+    }
+    for (int f = 0; f < kCamposCelda; f++) deltas[kCamposCelda * c + f] = acum[f];
+}
+
+/**
+ * @brief Rebote contra las paredes y movimiento; deja un parcial por bloque.
+ */
+__global__ void nucleoParedes(int n, Geometria g, Particulas p, double dt, double *parciales) {
+    __shared__ double s[kHilosBloque];
+    int i = blockIdx.x * blockDim.x + threadIdx.x;
+    fisica::ResultadoParedes r;
+    if (i < n) {
+        double ri = p.radio(i);
+        fisica::rebotePared(p.x[i], p.y[i], p.vx[i], p.vy[i], p.masa(i), g.xmin + ri, g.xmax - ri,
+                            g.ymin + ri, g.ymax - ri, r);
+        p.x[i] += p.vx[i] * dt;
+        p.y[i] += p.vy[i] * dt;
+    }
+    double v[kCamposParedes] = {r.sumaMv2, r.choques, r.impulso, r.dPx, r.dPy};
+    for (int f = 0; f < kCamposParedes; f++) {
+        double t = sumaBloque(s, v[f]);
+        if (threadIdx.x == 0) parciales[kCamposParedes * blockIdx.x + f] = t;
+    }
+}
+
+/**
+ * @brief Suma con un solo bloque los parciales de paredes y de celdas.
+ *
+ * Deja en @p salida los 5 campos de las paredes seguidos de los 4 de las celdas.
+ */
+__global__ void nucleoReducir(const double *parciales, int nb, const double *deltas, int nc,
+                              double *salida) {
+    __shared__ double s[kHilosBloque];
+    for (int f = 0; f < kCamposParedes; f++) {
+        double v = 0;
+        for (int b = threadIdx.x; b < nb; b += kHilosBloque) v += parciales[kCamposParedes * b + f];
+        double t = sumaBloque(s, v);
+        if (threadIdx.x == 0) salida[f] = t;
+    }
+    for (int f = 0; f < kCamposCelda; f++) {
+        double v = 0;
+        for (int c = threadIdx.x; c < nc; c += kHilosBloque) v += deltas[kCamposCelda * c + f];
+        double t = sumaBloque(s, v);
+        if (threadIdx.x == 0) salida[kCamposParedes + f] = t;
+    }
+}
+
+}  // namespace
+
+/**
+ * @struct Estado
+ * @brief Arreglos del sistema y de la rejilla en la memoria del dispositivo.
+ */
+struct Estado {
+    Geometria g;
+    int n = 0;
+    int nc = 0;  ///< Número de celdas.
+    bool conObs = false;
+    Particulas p{};
+    double *m = nullptr, *R = nullptr;
+    int *clave = nullptr, *orden = nullptr, *comienzo = nullptr;
+    double *parciales = nullptr;  ///< kCamposParedes por bloque.
+    double *deltas = nullptr;     ///< kCamposCelda por celda.
+    double *salida = nullptr;     ///< kCamposParedes + kCamposCelda.
+};
+
+bool disponible() {
+    int n = 0;
+    return cudaGetDeviceCount(&n) == cudaSuccess && n > 0;
+}
+
+std::string nombreDispositivo() {
+    int d = 0;
+    cudaDeviceProp prop;
+    if (cudaGetDevice(&d) != cudaSuccess || cudaGetDeviceProperties(&prop, d) != cudaSuccess) return "";
+    return prop.name;
+}
+
+void destruir(Estado *e) {
+    if (!e) return;
+    cudaFree(e->p.x);
+    cudaFree(e->p.y);
+    cudaFree(e->p.vx);
+    cudaFree(e->p.vy);
+    cudaFree(e->m);
+    cudaFree(e->R);
+    cudaFree(e->clave);
+    cudaFree(e->orden);
+    cudaFree(e->comienzo);
+    cudaFree(e->parciales);
+    cudaFree(e->deltas);
+    cudaFree(e->salida);
+    delete e;
+}
+
+Estado *crear(const Geometria &g, int n, double m0, double R0, const double *m, const double *R,
+              bool conObservables) {
+    Estado *e = new Estado();
+    e->g = g;
+    e->n = n;
+    e->nc = g.nx * g.ny;
+    e->conObs = conObservables;
+    size_t bytes = sizeof(double) * static_cast<size_t>(n);
+    int nb = bloquesPara(n);
+    bool ok = revisar(cudaMalloc(&e->p.x, bytes), "cudaMalloc") &&
+              revisar(cudaMalloc(&e->p.y, bytes), "cudaMalloc") &&
+              revisar(cudaMalloc(&e->p.vx, bytes), "cudaMalloc") &&
+              revisar(cudaMalloc(&e->p.vy, bytes), "cudaMalloc") &&
+              revisar(cudaMalloc(&e->clave, sizeof(int) * n), "cudaMalloc") &&
+              revisar(cudaMalloc(&e->orden, sizeof(int) * n), "cudaMalloc") &&
+              revisar(cudaMalloc(&e->comienzo, sizeof(int) * (e->nc + 1)), "cudaMalloc") &&
+              revisar(cudaMalloc(&e->parciales, sizeof(double) * kCamposParedes * nb), "cudaMalloc") &&
+              revisar(cudaMalloc(&e->deltas, sizeof(double) * kCamposCelda * e->nc), "cudaMalloc") &&
+              revisar(cudaMalloc(&e->salida, sizeof(double) * (kCamposParedes + kCamposCelda)), "cudaMalloc");
+    if (ok && m) {
+        ok = revisar(cudaMalloc(&e->m, bytes), "cudaMalloc") &&
+             revisar(cudaMemcpy(e->m, m, bytes, cudaMemcpyHostToDevice), "cudaMemcpy");
+    }
+    if (ok && R) {
+        ok = revisar(cudaMalloc(&e->R, bytes), "cudaMalloc") &&
+             revisar(cudaMemcpy(e->R, R, bytes, cudaMemcpyHostToDevice), "cudaMemcpy");
+    }
+    if (!ok) {
+        destruir(e);
+        return nullptr;
+    }
+    e->p.m = e->m;
+    e->p.R = e->R;
+    e->p.m0 = m0;
+    e->p.R0 = R0;
+    return e;
+}
+
+bool subir(Estado *e, const double *x, const double *y, const double *vx, const double *vy) {
+    if (!e) return false;
+    size_t bytes = sizeof(double) * static_cast<size_t>(e->n);
+    return revisar(cudaMemcpy(e->p.x, x, bytes, cudaMemcpyHostToDevice), "subir") &&
+           revisar(cudaMemcpy(e->p.y, y, bytes, cudaMemcpyHostToDevice), "subir") &&
+           revisar(cudaMemcpy(e->p.vx, vx, bytes, cudaMemcpyHostToDevice), "subir") &&
+           revisar(cudaMemcpy(e->p.vy, vy, bytes, cudaMemcpyHostToDevice), "subir");
+}
+
+bool bajar(Estado *e, double *x, double *y, double *vx, double *vy) {
+    if (!e) return false;
+    size_t bytes = sizeof(double) * static_cast<size_t>(e->n);
+    return revisar(cudaMemcpy(x, e->p.x, bytes, cudaMemcpyDeviceToHost), "bajar") &&
+           revisar(cudaMemcpy(y, e->p.y, bytes, cudaMemcpyDeviceToHost), "bajar") &&
+           revisar(cudaMemcpy(vx, e->p.vx, bytes, cudaMemcpyDeviceToHost), "bajar") &&
+           revisar(cudaMemcpy(vy, e->p.vy, bytes, cudaMemcpyDeviceToHost), "bajar");
+}
+
+bool paso(Estado *e, double dt, Resultado &r) {
+    if (!e) return false;
+    int n = e->n;
+    int nb = bloquesPara(n);
+
+    // --- Rejilla: celda de cada esfera, orden por celda y comienzo de cada celda ---
+    nucleoCeldas<<<nb, kHilosBloque>>>(n, e->p.x, e->p.y, e->g, e->clave, e->orden);
+    thrust::stable_sort_by_key(thrust::device, e->clave, e->clave + n, e->orden);
+    thrust::lower_bound(thrust::device, e->clave, e->clave + n, thrust::counting_iterator<int>(0),
+                        thrust::counting_iterator<int>(e->nc + 1), e->comienzo);
+
+    // --- Choques: los colores van en orden, las celdas de un color en paralelo ---
+    for (int color = 0; color < 9; color++) {
+        int mx = (e->g.nx - color % 3 + 2) / 3;
+        int my = (e->g.ny - color / 3 + 2) / 3;
+        if (mx <= 0 || my <= 0) continue;
+        nucleoChoques<<<bloquesPara(mx * my), kHilosBloque>>>(color, e->g, e->p, e->orden, e->comienzo,
+                                                              e->conObs, e->deltas);
+    }
+
+    // --- Paredes, movimiento y reducción ---
+    nucleoParedes<<<nb, kHilosBloque>>>(n, e->g, e->p, dt, e->parciales);
+    nucleoReducir<<<1, kHilosBloque>>>(e->parciales, nb, e->deltas, e->nc, e->salida);
+    if (!revisar(cudaGetLastError(), "paso")) return false;
+
+    double s[kCamposParedes + kCamposCelda];
+    if (!revisar(cudaMemcpy(s, e->salida, sizeof(s), cudaMemcpyDeviceToHost), "paso")) return false;
+    r.paredes.sumaMv2 = s[0];
+    r.paredes.choques = s[1];
+    r.paredes.impulso = s[2];
+    r.paredes.dPx = s[3];
+    r.paredes.dPy = s[4];
+    r.dK = s[5];
+    r.dPx = s[6];
+    r.dPy = s[7];
+    r.eventos = s[8];
+    return true;
+}
+
+}  // namespace gpu
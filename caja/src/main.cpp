@@ -14,14 +14,33 @@
  * @date Octubre 2025
  */
 
+#include <algorithm>
 #include <iostream>
 #include <vector>
 #include <cmath>
 #include <cstdlib>
 #include <ctime>
+#include <filesystem>
 #include <fstream>
 #include <cstdio>
+#include <cstring>
+#include <random>
+#include "Checkpoint.hpp"
 #include "Esfera.hpp"   // Asumo que guardaste la clase en este archivo
+#include "Ensamble.hpp"
+#include "SistemaParticulas.hpp"
+#include "MallaCeldas.hpp"
+#include "MotorEventos.hpp"
+#include "Observables.hpp"
+#include "OrdenMorton.hpp"
+#include "HistogramaVelocidades.hpp"
+#include "Instrumentacion.hpp"
+#include "ListaVecinos.hpp"
+#include "PasoGpu.hpp"
+#include "PasoParalelo.hpp"
+#include "Renderizador.hpp"
+#include "Simulacion.hpp"
+#include "Trayectoria.hpp"
 
 using namespace std;
 
@@ -32,217 +51,454 @@ using namespace std;
  * esferas, velocidad máxima, radio) y realiza la simulación del sistema.
  * Utiliza Gnuplot para graficar y crear animaciones de la evolución temporal.
  *
+ * Opciones de la línea de comandos:
+ * - @c --eventos: dinámica dirigida por eventos (choques exactos); los
+ *   frames se muestrean cada @c dt.
+ * - @c --hilos N: paso fijo repartido entre N hilos (0 = todos los núcleos),
+ *   con resultados idénticos para cualquier N.
+ * - @c --gpu: paso fijo en la GPU (compilado con make CUDA=1); el estado
+ *   sólo se copia al host en los pasos que escriben o dibujan algo.
+ * - @c --piel S: listas de vecinos de Verlet con piel S en el paso serial.
+ * - @c --reordenar K: reordena las esferas en memoria por curva de Morton
+ *   cada K pasos (0 = nunca, por defecto). Cambia el orden de las colisiones
+ *   en el paso serial, así que los resultados difieren de los de K = 0. No
+ *   aplica con @c --eventos.
+ * - @c --pasos N: número total de pasos (por defecto 300).
+ * - @c --directorio DIR: carpeta de todas las salidas (por defecto results);
+ *   se crea si no existe.
+ * - @c --checkpoint K: escribe una instantánea del estado cada K pasos en
+ *   DIR/checkpoint.bin.{0,1} (doble búfer).
+ * - @c --reanudar ruta: continúa desde la instantánea más reciente de @c ruta
+ *   sin preguntar parámetros ni volver a inicializar. Los resultados siguen
+ *   en los archivos de DIR, recortados al paso de la instantánea; con otro
+ *   @c --directorio la corrida se bifurca en archivos nuevos y la original
+ *   queda intacta.
+ * - @c --perfil archivo.json y @c --traza archivo.csv: resumen por fase y
+ *   traza por paso (sólo si se compiló con make INSTRUMENTAR=1).
+ * - @c --cada K: guarda la trayectoria en DIR/trayectoria.bin cada K pasos.
+ * - @c --render-cada K: dibuja las animaciones en un hilo aparte, una de cada K pasos.
+ * - @c --render-cola N: frames que pueden esperar al hilo de render (por
+ *   defecto 4); con la cola llena la física espera.
+ * - @c --render-descartar: con la cola llena descarta el frame en vez de
+ *   esperar (para muestrear corridas largas sin frenarlas).
+ * - @c --render motor: quién dibuja las animaciones: @c nativo (por defecto,
+ *   GIF propio), @c ffmpeg (DIR/animacion.mp4) o @c gnuplot (como antes).
+ * - @c --sin-render: no dibuja animaciones.
+ * - @c --semilla S: semilla del generador (por defecto, la hora).
+ * - @c --lote archivo y/o @c --param clave=valores: modo por lotes; corre
+ *   en paralelo la rejilla de parámetros (ver Ensamble.hpp) y termina.
+ *   Con @c --param dim=3 y/o @c --param tipo=float las cajas son 3D o en float.
+ *
+ * @param argc Número de argumentos.
+ * @param argv Argumentos de la línea de comandos.
  * @return 0 si la ejecución finaliza correctamente.
  */
-int main() {
-    srand(time(nullptr));  // Semilla para números aleatorios
-
-    cout << "=== Bienvenido al simulador de particulas ===" << endl;
-
-    // --- Definir la caja ---
-    double largo;
-    cout << "Ingrese el largo del lado de la caja (positivo): ";
-    cin >> largo;
-
-    double half = largo / 2.0;
-    Cajas caja;
-    caja.inicio(-half, half, -half, half); // xmin, xmax, ymin, ymax
-
-    // --- Numero de esferas ---
-    int n;
-    cout << "Ingrese el numero de esferas: ";
-    cin >> n;
-
-    // --- Calcular R ---
-    int malla = static_cast<int>(ceil(sqrt(n)));
-
-    // --- Velocidad maxima ---
-    double vmax;
-    cout << "Ingrese la velocidad maxima: ";
-    cin >> vmax;
-
-    // --- Radio ---
-    double R;
-    do {
-        cout << "Ingrese el radio (Sugerido: " << 0.9 * largo / (2.0 * malla) << "): ";
-        cin >> R;
-        if (R <= 0 || R >= largo / (2.0 * malla)) {
-            cout << "Valor fuera de rango. Intenta de nuevo.\n";
+int main(int argc, char *argv[]) {
+    bool modo_eventos = false;
+    bool usar_gpu = false;
+    int hilos = -1;    // -1: paso serial original
+    double piel = 0;   // 0: sin listas de Verlet
+    int cada = 1;      // frecuencia de guardado de la trayectoria
+    int reordenar = 0;    // pasos entre reordenamientos de Morton (0: nunca)
+    int pasos_total = 300;
+    int checkpoint_cada = 0;  // pasos entre instantáneas (0: nunca)
+    string reanudar;          // ruta base de la instantánea a reanudar
+    string directorio = "results";  // carpeta de las salidas
+    string perfil;            // resumen JSON de la instrumentación
+    string traza;             // traza CSV por paso de la instrumentación
+    bool render_activo = true;
+    int render_cada = 1;
+    int render_cola = 4;      // frames en espera del hilo de render
+    bool render_descartar = false;
+    MotorRender motor_render = MotorRender::kNativo;
+    uint64_t semilla = static_cast<uint64_t>(time(nullptr));
+    bool modo_lote = false;
+    Ensamble ensamble;
+    for (int a = 1; a < argc; a++) {
+        if (strcmp(argv[a], "--eventos") == 0) modo_eventos = true;
+        else if (strcmp(argv[a], "--gpu") == 0) usar_gpu = true;
+        else if (strcmp(argv[a], "--hilos") == 0 && a + 1 < argc) hilos = atoi(argv[++a]);
+        else if (strcmp(argv[a], "--piel") == 0 && a + 1 < argc) piel = atof(argv[++a]);
+        else if (strcmp(argv[a], "--reordenar") == 0 && a + 1 < argc) reordenar = max(0, atoi(argv[++a]));
+        else if (strcmp(argv[a], "--pasos") == 0 && a + 1 < argc) pasos_total = max(0, atoi(argv[++a]));
+        else if (strcmp(argv[a], "--checkpoint") == 0 && a + 1 < argc) checkpoint_cada = max(0, atoi(argv[++a]));
+        else if (strcmp(argv[a], "--reanudar") == 0 && a + 1 < argc) reanudar = argv[++a];
+        else if (strcmp(argv[a], "--directorio") == 0 && a + 1 < argc) directorio = argv[++a];
+        else if (strcmp(argv[a], "--perfil") == 0 && a + 1 < argc) perfil = argv[++a];
+        else if (strcmp(argv[a], "--traza") == 0 && a + 1 < argc) traza = argv[++a];
+        else if (strcmp(argv[a], "--cada") == 0 && a + 1 < argc) cada = max(1, atoi(argv[++a]));
+        else if (strcmp(argv[a], "--render-cada") == 0 && a + 1 < argc) render_cada = max(1, atoi(argv[++a]));
+        else if (strcmp(argv[a], "--render-cola") == 0 && a + 1 < argc) render_cola = max(1, atoi(argv[++a]));
+        else if (strcmp(argv[a], "--render-descartar") == 0) render_descartar = true;
+        else if (strcmp(argv[a], "--sin-render") == 0) render_activo = false;
+        else if (strcmp(argv[a], "--render") == 0 && a + 1 < argc) {
+            ++a;
+            if (strcmp(argv[a], "gnuplot") == 0) motor_render = MotorRender::kGnuplot;
+            else if (strcmp(argv[a], "ffmpeg") == 0) motor_render = MotorRender::kFfmpeg;
+            else motor_render = MotorRender::kNativo;
+        }
+        else if (strcmp(argv[a], "--semilla") == 0 && a + 1 < argc) semilla = strtoull(argv[++a], nullptr, 10);
+        else if (strcmp(argv[a], "--lote") == 0 && a + 1 < argc) {
+            modo_lote = true;
+            if (!ensamble.leer(argv[++a])) return 1;
+        } else if (strcmp(argv[a], "--param") == 0 && a + 1 < argc) {
+            modo_lote = true;
+            if (!ensamble.fijar(argv[++a])) {
+                cerr << "Parametro no valido: " << argv[a] << endl;
+                return 1;
+            }
         }
-    } while (R <= 0 || R >= largo / (2.0 * malla));
+    }
+
+    // --- Modo por lotes: muchas cajas independientes en paralelo ---
+    if (modo_lote) {
+        if (hilos >= 0) ensamble.fijar("hilos", to_string(hilos));
+        int corridas = ensamble.correr();
+        if (!ensamble.escribir()) return 1;
+        cout << corridas << " corridas completadas. Resultados en " << ensamble.Getsalida() << endl;
+        return 0;
+    }
 
-    // --- Crear array de esferas ---
-    vector<Esfera> esferas(n);
+    cout << "=== Bienvenido al simulador de particulas ===" << endl;
 
-    // --- Inicialización ---
-    int idx = 0;
+    double largo, vmax = 0, R;
+    int n, malla;
     double m0 = 1;
-    for (int i = 0; i < malla && idx < n; i++) {
-        for (int j = 0; j < malla && idx < n; j++) {
-            // Posición en malla centrada
-            double x0 = -half + (i + 0.5) * (largo / malla);
-            double y0 = -half + (j + 0.5) * (largo / malla);
-
-            // Generar velocidad aleatoria
-            double ang = (2.0 * 3.14159265358979323846 * rand()) / RAND_MAX; // ángulo uniforme [0,2π)
-            double v = (vmax * rand()) / RAND_MAX;         // magnitud aleatoria [0,vmax]
-            double vx0 = v * cos(ang);
-            double vy0 = v * sin(ang);
-
-            // Inicializar esfera
-            esferas[idx].inicio(m0, x0, y0, vx0, vy0, R);
-            idx++;
+    double dt = 0.01;    // paso temporal
+    int paso_inicial = 0;
+    Cajas caja;
+    SistemaParticulas esferas;
+    std::mt19937_64 rng;
+    Observables observables(100);
+    uint64_t secuencia_checkpoint = 0;
+    uint64_t bytes_presion = 0, bytes_histograma = 0;  // hasta dónde iban los textos al reanudar
+
+    if (!reanudar.empty()) {
+        // --- Reanudar desde la instantánea más reciente, sin volver a inicializar ---
+        LectorCheckpoint lector;
+        if (!lector.abrir(reanudar) || !lector.restaurar(caja, esferas, rng, observables)) {
+            std::cerr << "No se encontro una instantanea valida en " << reanudar << ".\n";
+            return 1;
         }
+        const CabeceraCheckpoint &cab = lector.Getcabecera();
+        largo = caja.Getxmax() - caja.Getxmin();
+        n = esferas.size();
+        malla = static_cast<int>(ceil(sqrt(n)));
+        R = esferas.GetRmax();
+        m0 = esferas.GetmComun();
+        dt = cab.dt;
+        paso_inicial = static_cast<int>(cab.paso);
+        semilla = cab.semilla;
+        secuencia_checkpoint = cab.secuencia;
+        bytes_presion = cab.bytesPresion;
+        bytes_histograma = cab.bytesHistograma;
+        cout << "\nSe reanuda " << lector.Getruta() << ": " << n << " esferas, paso "
+             << paso_inicial << " (t = " << paso_inicial * dt << ")." << endl;
+    } else {
+        // --- Definir la caja ---
+        cout << "Ingrese el largo del lado de la caja (positivo): ";
+        cin >> largo;
+
+        double half = largo / 2.0;
+        caja.inicio(-half, half, -half, half); // xmin, xmax, ymin, ymax
+
+        // --- Numero de esferas ---
+        cout << "Ingrese el numero de esferas: ";
+        cin >> n;
+
+        // --- Calcular R ---
+        malla = static_cast<int>(ceil(sqrt(n)));
+
+        // --- Velocidad maxima ---
+        cout << "Ingrese la velocidad maxima: ";
+        cin >> vmax;
+
+        // --- Radio ---
+        do {
+            cout << "Ingrese el radio (Sugerido: " << 0.9 * largo / (2.0 * malla) << "): ";
+            cin >> R;
+            if (R <= 0 || R >= largo / (2.0 * malla)) {
+                cout << "Valor fuera de rango. Intenta de nuevo.\n";
+            }
+        } while (R <= 0 || R >= largo / (2.0 * malla));
+
+        // --- Crear sistema de esferas (arreglos SoA) ---
+        ParametrosCaja parametros;
+        parametros.largo = largo;
+        parametros.n = n;
+        parametros.vmax = vmax;
+        parametros.R = R;
+        parametros.m = m0;
+        parametros.semilla = semilla;
+        rng.seed(semilla);
+        inicializarEsferas(esferas, parametros, rng);
+
+        // --- Confirmación ---
+        cout << "\nSe crearon " << n << " esferas dentro de la caja de lado " << largo << "." << endl;
+        cout << "Radio asignado: " << R << endl;
+        cout << "Velocidad maxima: " << vmax << endl;
+        cout << "Semilla: " << semilla << endl;
+
+        caja.actualizarPresion();
     }
 
-    // --- Confirmación ---
-    cout << "\nSe crearon " << n << " esferas dentro de la caja de lado " << largo << "." << endl;
-    cout << "Radio asignado: " << R << endl;
-    cout << "Velocidad maxima: " << vmax << endl;
-
     // --- Parámetros de simulación ---
-    double dt = 0.01;  // paso temporal
-    int pasos = 300;   // número de frames
+    int pasos = pasos_total;  // número de frames (contando los ya simulados)
+
+    // --- Carpeta de salidas (una por corrida o por bifurcación) ---
+    std::error_code error_directorio;
+    std::filesystem::create_directories(directorio, error_directorio);
+    if (error_directorio) {
+        std::cerr << "No se pudo crear el directorio " << directorio << ": " << error_directorio.message() << ".\n";
+        return 1;
+    }
+
+    // --- Render (en su propio hilo) ---
+    ConfigRender config_render;
+    config_render.activo = render_activo;
+    config_render.motor = motor_render;
+    config_render.radio = R;
+    config_render.cada = render_cada;
+    config_render.capacidad = render_cola;
+    config_render.descartar = render_descartar;
+    config_render.largo = largo;
+    config_render.ps = 2*R/(0.9 * largo / (2.0 * malla));
+    config_render.directorio = directorio;
+    Renderizador render;
+    if (!render.inicio(config_render)) {
+        std::cerr << "No se pudo abrir la salida de las animaciones; se continua sin ellas.\n";
+    }
 
-    // --- Gnuplot ---
-    FILE *gnuplot = popen("gnuplot -persist", "w");
+    // --- Histograma de velocidades (se llena cada render_cada pasos) ---
+    HistogramaVelocidades histograma;
+    histograma.inicio(100, 0.0, m0);  // 100 intervalos, rango adaptativo
+    // Al reanudar se sigue el archivo de la corrida original, recortado al paso de la instantánea.
+    std::ofstream archivo_histograma;
+    bool histograma_nuevo = true;
+    if (reanudar.empty()) archivo_histograma.open(directorio + "/histograma.dat");
+    else histograma_nuevo = reabrirSalida(archivo_histograma, directorio + "/histograma.dat", bytes_histograma);
+    if (histograma_nuevo) archivo_histograma << "# t ancho kT cuentas[0.." << histograma.Getnbins() - 1 << "]\n";
+
+    // --- Rejilla de celdas para la detección de colisiones ---
+    MallaCeldas malla_celdas;
+    malla_celdas.inicio(caja, R);
+
+    // --- Motor dirigido por eventos (opcional) ---
+    MotorEventos motor;
+    if (modo_eventos) motor.inicio(caja, esferas);
+
+    // --- Observables: se corrigen con cada colisión y rebote ---
+    if (modo_eventos) motor.conectar(&observables);
+    else esferas.conectar(&observables);
+
+    // --- Paso paralelo (opcional) ---
+    PasoParalelo paso_paralelo(hilos < 0 ? 1 : hilos);
+    paso_paralelo.inicio(caja, R);
+
+    // --- Listas de vecinos de Verlet (opcional) ---
+    ListaVecinos lista_vecinos;
+    if (piel > 0) lista_vecinos.inicio(caja, R, piel);
+
+    // --- Paso en la GPU (opcional): las esferas quedan en el dispositivo ---
+    PasoGpu paso_gpu;
+    if (usar_gpu && !modo_eventos) {
+        if (!PasoGpu::compilado()) {
+            std::cerr << "Compilado sin CUDA (make CUDA=1); se continua en la CPU.\n";
+        } else if (!paso_gpu.inicio(caja, esferas)) {
+            std::cerr << "No hay una GPU utilizable; se continua en la CPU.\n";
+        } else {
+            cout << "GPU: " << PasoGpu::Getdispositivo() << endl;
+        }
+    }
+    bool en_gpu = paso_gpu.activo();
 
-    // ---- Primera parte: configuraciones iniciales ----
-    fprintf(gnuplot, "set terminal gif animate delay 10 size 600,400\n");
-    fprintf(gnuplot, "set output 'results/animacion.gif'\n");
-    fprintf(gnuplot, "set xrange [-%f:%f]\n", largo/2, largo/2);
-    fprintf(gnuplot, "set yrange [-%f:%f]\n", largo/2, largo/2);
-    fflush(gnuplot);
+    // --- Reordenamiento espacial (sólo paso fijo en la CPU: el motor y la GPU tienen sus propios arreglos) ---
+    OrdenMorton orden_morton;
+    orden_morton.inicio(modo_eventos || en_gpu ? 0 : reordenar);
 
-    caja.actualizarPresion();
+    // --- Instantáneas para reanudar (doble búfer en DIR/checkpoint.bin.{0,1}) ---
+    EscritorCheckpoint checkpoint;
+    checkpoint.inicio(directorio + "/checkpoint.bin", checkpoint_cada, secuencia_checkpoint);
 
     // --- Abrir archivo de presiones ---
-std::ofstream archivo_presion("results/presion.dat");
+std::ofstream archivo_presion;
+if (reanudar.empty()) archivo_presion.open(directorio + "/presion.dat");
+else reabrirSalida(archivo_presion, directorio + "/presion.dat", bytes_presion);
 if (!archivo_presion.is_open()) {
-    std::cerr << "No se pudo abrir results/presion.dat para escritura.\n";
+    std::cerr << "No se pudo abrir " << directorio << "/presion.dat para escritura.\n";
     return 1;
 }
 
+// --- Trayectoria binaria (un archivo por corrida; al reanudar se continúa) ---
+EscritorTrayectoria trayectoria;
+if (reanudar.empty() ? !trayectoria.abrir(directorio + "/trayectoria.bin", caja, n, dt, cada)
+                     : !trayectoria.continuar(directorio + "/trayectoria.bin", caja, n, dt, cada, paso_inicial)) {
+    std::cerr << "No se pudo abrir " << directorio << "/trayectoria.bin para escritura"
+              << (reanudar.empty() ? "" : " (o es de otra corrida: n o --cada distintos)") << ".\n";
+    return 1;
+}
+
+// --- Instantánea: los textos se vacían a disco para que su tamaño quede registrado ---
+auto escribir_instantanea = [&](int paso) {
+    archivo_presion.flush();
+    archivo_histograma.flush();
+    return checkpoint.escribir(paso, dt, semilla, caja, esferas, rng, observables,
+                               static_cast<uint64_t>(archivo_presion.tellp()),
+                               static_cast<uint64_t>(archivo_histograma.tellp()));
+};
+
+// --- Instrumentación (vacía si no se compiló con CAJA_INSTRUMENTAR) ---
+if ((!perfil.empty() || !traza.empty()) && !instr::kActiva) {
+    std::cerr << "Instrumentacion desactivada: compile con make INSTRUMENTAR=1.\n";
+}
+if (!traza.empty() && instr::kActiva && !instr::abrirTraza(traza)) {
+    std::cerr << "No se pudo abrir " << traza << " para escritura.\n";
+}
+instr::iniciar();
+
 // --- Bucle de simulación ---
-for (int step = 0; step < pasos; step++) {
+for (int step = paso_inicial; step < pasos; step++) {
+
+    // --- Traer el estado de la GPU sólo en los pasos que lo leen ---
+    if (en_gpu && ((checkpoint.toca(step) && step != paso_inicial) || trayectoria.toca(step) ||
+                   step % render_cada == 0)) {
+        CAJA_MEDIR(instr::kGpu);
+        if (!paso_gpu.descargar(esferas)) {
+            std::cerr << "No se pudo copiar el estado desde la GPU en el paso " << step << ".\n";
+            return 1;
+        }
+    }
+
+    // --- Instantánea del estado al comenzar el paso ---
+    if (checkpoint.toca(step) && step != paso_inicial) {
+        CAJA_MEDIR(instr::kCheckpoint);
+        if (!escribir_instantanea(step)) {
+            std::cerr << "No se pudo escribir la instantanea del paso " << step << ".\n";
+        }
+    }
 
-    // --- Calcular energía total ---
-    double energia_total = 0.0;
-    for (int i = 0; i < n; i++) {
-        energia_total += 0.5 * m0 * esferas[i].Getv() * esferas[i].Getv();
+    // --- Reordenar en memoria para que las vecinas queden juntas ---
+    if (orden_morton.toca(step)) {
+        CAJA_MEDIR(instr::kReorden);
+        orden_morton.reordenar(esferas, caja);
+        if (piel > 0) lista_vecinos.permutar(orden_morton.Getnueva());
     }
 
-    // --- Guardar posiciones  ---
-    std::ofstream archivo("results/datos.dat");
-    for (int k = 0; k < n; k++) {
-        archivo << esferas[k].Getx() << "\t"
-                << esferas[k].Gety() << "\t"
-                << esferas[k].Getv() << "\n";
+    // --- Guardar posiciones y velocidades ---
+    if (trayectoria.toca(step)) {
+        CAJA_MEDIR(instr::kTrayectoria);
+        trayectoria.escribir(step, step * dt, esferas);
     }
-    archivo.close();
 
-    // --- Gnuplot animación  ---
-    fprintf(gnuplot, "set title sprintf('t = %.2f s   P = %.4f (Pa·m³)   E = %.4f J')\n", 
-            step * dt, caja.Getp(), energia_total);
-    fprintf(gnuplot, "plot '-' using 1:2 with points pt 7 ps %f notitle \n", 2*R/(0.9 * largo / (2.0 * malla)));
-    caja.actualizarPresion();
-    for (int k = 0; k < n; k++) {
-        fprintf(gnuplot, "%f\t%f\n", esferas[k].Getx(), esferas[k].Gety());
+    // --- Histograma de velocidades: sólo se guardan las cuentas ---
+    if (step % render_cada == 0) {
+        CAJA_MEDIR(instr::kHistograma);
+        histograma.acumular(esferas);
+        archivo_histograma << step * dt << "\t" << histograma.Getancho() << "\t" << histograma.GetkT();
+        for (long c : histograma.Getcuentas()) archivo_histograma << "\t" << c;
+        archivo_histograma << "\n";
     }
-    fprintf(gnuplot, "e\n");
-    fflush(gnuplot);
 
-    // --- Colisiones y rebotes ---
-    for (int i = 0; i < n; i++) {
-        for (int j = i + 1; j < n; j++) {
-            esferas[i].colision(esferas[j]);
+    // --- Render: se copia el frame y lo dibuja otro hilo ---
+    if (render.toca(step)) {
+        CAJA_MEDIR(instr::kRender);
+        render.enviar(step, step * dt, caja.Getp(), observables.Getenergia(), esferas, histograma);
+    }
+    caja.actualizarPresion();
+
+    if (modo_eventos) {
+        // --- Avanzar evento a evento hasta el siguiente frame ---
+        CAJA_MEDIR(instr::kEventos);
+        motor.avanzarHasta((step + 1 - paso_inicial) * dt, caja);
+        motor.volcar(esferas);
+    } else if (en_gpu) {
+        // --- Paso completo en el dispositivo; vuelven sólo la presión y los observables ---
+        CAJA_MEDIR(instr::kGpu);
+        if (!paso_gpu.paso(caja, dt)) {
+            std::cerr << "Fallo el paso en la GPU en el paso " << step << ".\n";
+            return 1;
+        }
+    } else if (hilos >= 0) {
+        // --- Colisiones, rebotes y movimiento repartidos entre hilos ---
+        paso_paralelo.paso(esferas, caja, dt);
+    } else {
+        // --- Colisiones (sólo entre esferas de celdas vecinas) ---
+        if (piel > 0) {
+            {
+                CAJA_MEDIR(instr::kMalla);
+                lista_vecinos.actualizar(esferas);
+            }
+            CAJA_MEDIR(instr::kColisiones);
+            lista_vecinos.recorrerPares([&](int i, int j) {
+                esferas.colision(i, j);
+            });
+        } else {
+            {
+                CAJA_MEDIR(instr::kMalla);
+                malla_celdas.construir(esferas);
+            }
+            CAJA_MEDIR(instr::kColisiones);
+            malla_celdas.recorrerPares([&](int i, int j) {
+                esferas.colision(i, j);
+            });
+        }
+
+        // --- Rebotes y movimiento ---
+        {
+            CAJA_MEDIR(instr::kParedes);
+            esferas.rebotePared(caja);
         }
-        esferas[i].rebotePared(caja);
-        esferas[i].muevase(dt);
+        CAJA_MEDIR(instr::kMovimiento);
+        esferas.muevase(dt);
     }
 
-    // --- Calcular presión promedio ---
-    caja.calcularPresion();
+    {
+        CAJA_MEDIR(instr::kPresion);
+        // --- Calcular presión promedio ---
+        caja.calcularPresion();
+        observables.cerrarPaso(caja, dt);
+
+        // --- Guardar presión en archivo ---
+        archivo_presion << step*dt << "\t" << caja.Getp() << "\t" << caja.GetpMecanica(dt) << "\n";
+    }
+    instr::cerrarPaso(step);
+}
 
-    // --- Guardar presión en archivo ---
-     archivo_presion << step*dt << "\t" << caja.Getp() << "\n";
+// --- Instantánea final (para reanudar o bifurcar corridas desde aquí) ---
+if (en_gpu && !paso_gpu.descargar(esferas)) {
+    std::cerr << "No se pudo copiar el estado final desde la GPU.\n";
+    return 1;
+}
+if (checkpoint_cada > 0 && pasos > paso_inicial &&
+    !escribir_instantanea(pasos)) {
+    std::cerr << "No se pudo escribir la instantanea final.\n";
 }
 
 // --- Cerrar archivo de presiones ---
+CAJA_CONTAR(instr::kBytesEscritos, archivo_presion.tellp());
+CAJA_CONTAR(instr::kBytesEscritos, archivo_histograma.tellp());
 archivo_presion.close();
+archivo_histograma.close();
+trayectoria.cerrar();
+render.terminar();
+if (render.Getdescartados() > 0) {
+    cout << "Render: " << render.Getdescartados() << " frames descartados (anillo lleno)." << endl;
+}
 
+cout << "P = " << observables.GetestP().media() << " +- " << observables.GetestP().error()
+     << "   P_mec = " << observables.GetestPmec().media() << " +- " << observables.GetestPmec().error()
+     << "   E = " << observables.GetestK().media() << " +- " << observables.GetestK().error() << endl;
 
-    fprintf(gnuplot, "unset output \n");
-    fflush(gnuplot);
-    pclose(gnuplot);
-
-   // === Segunda animación: histograma de velocidades ===
-FILE *gnuplot2 = popen("gnuplot -persist", "w");
-
-fprintf(gnuplot2, "reset\n");
-fprintf(gnuplot2, "set encoding utf8\n");
-fprintf(gnuplot2, "set terminal gif animate delay 10 size 800,600 enhanced font 'Arial,12'\n");
-fprintf(gnuplot2, "set output 'results/histograma_velocidades.gif'\n");
-fprintf(gnuplot2, "set xlabel 'Velocidad'\n");
-fprintf(gnuplot2, "set ylabel 'Frecuencia'\n");
-fprintf(gnuplot2, "set style fill solid 0.7 border -1\n");
-fprintf(gnuplot2, "set boxwidth 0.9 relative\n");
-fprintf(gnuplot2, "set grid ytics\n");
-fprintf(gnuplot2, "n_bins = 100\n"); // Más divisiones = histograma más suave
-fprintf(gnuplot2, "bin(x,width) = width * floor(x/width) + width/2.0\n");
-fprintf(gnuplot2, "set key top right\n");  // leyenda arriba derecha
-fflush(gnuplot2);
-
-for (int step = 0; step < pasos; step++) {
-    // --- Guardar velocidades ---
-    {
-        std::ofstream archivo("results/datos.dat");
-        for (int k = 0; k < n; k++) {
-            double v = esferas[k].Getv();
-            if (std::isfinite(v) && v > 0.0)
-                archivo << v << "\n";
-        }
-        archivo.close();
-    }
-
-    // --- Verificar si el archivo tiene datos ---
-    std::ifstream check("results/datos.dat", std::ios::ate | std::ios::binary);
-    if (check.tellg() < 5) continue;
-    check.close();
-
-    // --- Enviar comandos a gnuplot ---
-    fprintf(gnuplot2, "stats 'results/datos.dat' using 1 nooutput\n");
-    fprintf(gnuplot2, "min_v = STATS_min\n");
-    fprintf(gnuplot2, "max_v = STATS_max\n");
-    fprintf(gnuplot2, "if (max_v - min_v <= 1e-9) max_v = min_v + 1e-9\n");
-    fprintf(gnuplot2, "width = (max_v - min_v) / n_bins\n");
-    fprintf(gnuplot2, "set xrange [min_v:max_v]\n");
-    fprintf(gnuplot2, "set yrange [0:*]\n");
-
-    // Texto dinámico con tiempo y número de partículas
-    fprintf(gnuplot2,
-            "set label 1 sprintf('t = %.2f s', %f) at graph 0.02, 0.95 front tc rgb '#333333' font ',12'\n",
-            step * dt, step * dt);
-    fprintf(gnuplot2,
-            "set label 2 sprintf('N = %d', %d) at graph 0.02, 0.88 front tc rgb '#333333' font ',12'\n",
-            n, n);
-
-    fprintf(gnuplot2,
-            "set title sprintf('Distribución de velocidades - paso %d', %d)\n",
-            step, step);
-
-    fprintf(gnuplot2,
-            "plot 'results/datos.dat' using (bin($1,width)):(1.0) smooth freq "
-            "with boxes lc rgb '#1f77b4' title 'Velocidades'\n");
-
-    // limpiar etiquetas para el siguiente frame
-    fprintf(gnuplot2, "unset label 1\nunset label 2\n");
-    fflush(gnuplot2);
+if (!perfil.empty() && instr::kActiva) {
+    if (instr::escribirResumen(perfil, pasos - paso_inicial, n)) cout << "Perfil escrito en " << perfil << endl;
+    else std::cerr << "No se pudo abrir " << perfil << " para escritura.\n";
 }
 
-fprintf(gnuplot2, "unset output\n");
-fflush(gnuplot2);
-pclose(gnuplot2);
+if (piel > 0) {
+    cout << "Listas de vecinos: " << lista_vecinos.Getreconstrucciones()
+         << " reconstrucciones en " << lista_vecinos.Getactualizaciones()
+         << " pasos (" << lista_vecinos.Getpares() << " pares en la ultima)." << endl;
+}
 
 return 0;
 }
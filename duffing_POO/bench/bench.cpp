@@ -0,0 +1,401 @@
+/**
+ * @file bench.cpp
+ * @brief Rendimiento y precisión de los integradores (make bench).
+ * @details
+ * Mide, con condiciones iniciales y parámetros fijos:
+ *   - rendimiento: pasos por segundo y evaluaciones del lado derecho por
+ *     segundo de IntegradorRK4 e IntegradorDP45 en varios horizontes, de
+ *     IntegradorLotes con varios tamaños de conjunto, de RedDuffing con
+ *     varios números de osciladores y de CuencasAtraccion con varios hilos;
+ *   - precisión: error en t = kTiempoPrecision contra una trayectoria de
+ *     referencia (DP45 con rtol = 1e-13), frente a las evaluaciones
+ *     gastadas, para RK4 con varios dt y DP45 con varias tolerancias.
+ *
+ * Una evaluación es el lado derecho de un sistema de dos osciladores (o de
+ * un oscilador, en RedDuffing). Cada medición es una fila de un CSV que se
+ * agrega a results/bench.csv con la etiqueta del commit, para comparar
+ * entre versiones.
+ *
+ * Uso:
+ * @code
+ *   ./duffing_bench [--rapido] [--hilos 1,2,4] [--salida ruta] [--etiqueta texto]
+ * @endcode
+ *
+ * @authors
+ *   - Eric Jesús Arciniegas Barreto
+ *   - Santiago Suárez Sánchez
+ * @date 2025-10-28
+ */
+
+#include "CuencasAtraccion.h"
+#include "IntegradorDP45.h"
+#include "IntegradorLotes.h"
+#include "IntegradorRK4.h"
+#include "OsciladorDuffing.h"
+#include "RedDuffing.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/// Horizonte de las curvas de error contra trabajo.
+constexpr double kTiempoPrecision = 20.0;
+
+/// Tiempo de pared desde la construcción.
+class Cronometro {
+ private:
+  std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+
+ public:
+  double segundos() const {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio)
+        .count();
+  }
+};
+
+/// Sistema de main con acoplamiento, para que los dos osciladores interactúen.
+OsciladorDuffing Sistema() {
+  return OsciladorDuffing(-1.0, 3.0, 1.5, 0.6, 0.1, {1.0, 1.0}, {0.05, 0.05});
+}
+
+const EstadoDuffing kInicial = {-1.0 + 0.0001, 1.0 + 0.0001, 0.0, 0.0};
+
+/**
+ * @struct Rendimiento
+ * @brief Cuánto trabajo hace un integrador por segundo (results/bench.csv).
+ */
+struct Rendimiento {
+  std::string metodo;
+  int n = 1;             ///< Sistemas (o osciladores) que avanzan juntos.
+  int hilos = 1;
+  double tf = 0;
+  double parametro = 0;  ///< dt, o tolerancia relativa en DP45.
+  long pasos = 0;        ///< Pasos de integración del conjunto.
+  long evaluaciones = 0;
+  double segundos = 0;
+  double control = 0;    ///< Una componente del estado final (ver main).
+};
+
+/**
+ * @struct Precision
+ * @brief Un punto de la curva de error contra trabajo (results/precision.csv).
+ */
+struct Precision {
+  std::string metodo;
+  double parametro = 0;  ///< dt, o tolerancia relativa en DP45.
+  long evaluaciones = 0;
+  double segundos = 0;
+  double error = 0;      ///< Distancia máxima a la referencia en kTiempoPrecision.
+};
+
+/// CSV que se agrega entre corridas; el encabezado sólo va en un archivo nuevo.
+std::FILE* AbrirCsv(const std::string& ruta, const char* encabezado) {
+  std::FILE* prueba = std::fopen(ruta.c_str(), "r");
+  const bool nuevo = !prueba;
+  if (prueba) std::fclose(prueba);
+  std::FILE* f = std::fopen(ruta.c_str(), "a");
+  if (f && nuevo) std::fprintf(f, "%s\n", encabezado);
+  return f;
+}
+
+/// Tanto el CSV como la consola: cada fila se ve mientras corre el resto.
+void Escribir(std::FILE* f, const std::string& etiqueta, const Rendimiento& r) {
+  const double sps = r.segundos > 0 ? r.pasos * r.n / r.segundos : 0;
+  const double eps = r.segundos > 0 ? r.evaluaciones / r.segundos : 0;
+  std::fprintf(f, "%s,%s,%d,%d,%g,%g,%ld,%ld,%.6f,%.6g,%.6g\n", etiqueta.c_str(),
+               r.metodo.c_str(), r.n, r.hilos, r.tf, r.parametro, r.pasos,
+               r.evaluaciones, r.segundos, sps, eps);
+  std::fflush(f);
+  std::printf("%-10s n=%-5d hilos=%-2d tf=%-7g p=%-6g %10.4g sistemas-paso/s %10.4g eval/s\n",
+              r.metodo.c_str(), r.n, r.hilos, r.tf, r.parametro, sps, eps);
+}
+
+void Escribir(std::FILE* f, const std::string& etiqueta, const Precision& p) {
+  std::fprintf(f, "%s,%s,%g,%ld,%.6f,%.6g\n", etiqueta.c_str(), p.metodo.c_str(),
+               p.parametro, p.evaluaciones, p.segundos, p.error);
+  std::fflush(f);
+  std::printf("%-10s p=%-6g %10ld eval %10.3g s  error %.3g\n", p.metodo.c_str(),
+              p.parametro, p.evaluaciones, p.segundos, p.error);
+}
+
+/// Mayor diferencia absoluta entre las componentes de dos estados.
+double Distancia(const EstadoDuffing& a, const EstadoDuffing& b) {
+  return std::max({std::fabs(a.x1 - b.x1), std::fabs(a.x2 - b.x2),
+                   std::fabs(a.y1 - b.y1), std::fabs(a.y2 - b.y2)});
+}
+
+// ======================= Integradores =======================
+
+/// RK4 de paso fijo de 0 a @p tf; deja los pasos dados en @p pasos.
+EstadoDuffing CorrerRK4(const OsciladorDuffing& osc, double tf, double dt,
+                        long& pasos) {
+  pasos = NumeroPasos(0, tf, dt);
+  EstadoDuffing s = kInicial;
+  for (long i = 0; i < pasos; ++i) s = IntegradorRK4::paso(osc, i * dt, dt, s);
+  return s;
+}
+
+/// DP45 de 0 a @p tf; @p integrador queda con sus contadores.
+EstadoDuffing CorrerDP45(const OsciladorDuffing& osc, double tf,
+                         IntegradorDP45& integrador) {
+  integrador.inicio(osc, 0.0, kInicial);
+  while (integrador.getT() < tf) {
+    if (!integrador.avanzar(tf)) break;
+  }
+  return integrador.getEstado();
+}
+
+Rendimiento Rk4(const OsciladorDuffing& osc, double tf, double dt) {
+  Rendimiento r;
+  r.metodo = "rk4";
+  r.tf = tf;
+  r.parametro = dt;
+  Cronometro reloj;
+  r.control = CorrerRK4(osc, tf, dt, r.pasos).x1;
+  r.segundos = reloj.segundos();
+  r.evaluaciones = 4 * r.pasos;
+  return r;
+}
+
+Rendimiento Dp45(const OsciladorDuffing& osc, double tf, double tol) {
+  Rendimiento r;
+  r.metodo = "dp45";
+  r.tf = tf;
+  r.parametro = tol;
+  IntegradorDP45 integrador(tol, tol / 100);
+  Cronometro reloj;
+  r.control = CorrerDP45(osc, tf, integrador).x1;
+  r.segundos = reloj.segundos();
+  r.pasos = integrador.getAceptados() + integrador.getRechazados();
+  r.evaluaciones = integrador.getEvaluaciones();
+  return r;
+}
+
+/// @p n condiciones iniciales en lotes de kCarriles, un hilo.
+Rendimiento Lotes(const OsciladorDuffing& osc, int n, double tf, double dt) {
+  const int lotes = (n + kCarriles - 1) / kCarriles;
+  std::vector<Lote> conjunto(lotes);
+  for (int i = 0; i < lotes * kCarriles; ++i) {
+    conjunto[i / kCarriles].setCarril(
+        i % kCarriles, {kInicial.x1 + 1e-3 * i, kInicial.x2, kInicial.y1, kInicial.y2});
+  }
+  IntegradorLotes integrador(osc);
+  const long pasos = NumeroPasos(0, tf, dt);
+  Cronometro reloj;
+  for (Lote& lote : conjunto) {
+    for (long i = 0; i < pasos; ++i) integrador.paso(i * dt, dt, lote);
+  }
+  Rendimiento r;
+  r.segundos = reloj.segundos();
+  r.metodo = "lotes";
+  r.n = lotes * kCarriles;
+  r.tf = tf;
+  r.parametro = dt;
+  r.pasos = pasos;
+  r.evaluaciones = 4 * pasos * r.n;
+  r.control = conjunto[0].x1[0];
+  return r;
+}
+
+/// Anillo de N osciladores; @p pasos pasos de RK4.
+template <size_t N>
+Rendimiento Red(long pasos, double dt) {
+  using R = RedDuffing<N>;
+  R red(-1.0, 1.0, 0.3, 1.2, 0.1, Topologia::kAnillo);
+  static typename R::Estado s;  // fuera de la pila para N grande
+  s.fill(0.0);
+  for (size_t i = 0; i < N; ++i) s[i] = -1.0 + 1e-3 * i;
+  Cronometro reloj;
+  for (long i = 0; i < pasos; ++i) red.paso(i * dt, dt, s);
+  Rendimiento r;
+  r.segundos = reloj.segundos();
+  r.metodo = "red";
+  r.n = static_cast<int>(N);
+  r.tf = pasos * dt;
+  r.parametro = dt;
+  r.pasos = pasos;
+  r.evaluaciones = 4 * pasos * static_cast<long>(N);
+  r.control = s[0];
+  return r;
+}
+
+/// Cuencas de @p lado × @p lado píxeles repartidas entre @p hilos.
+Rendimiento Cuencas(const OsciladorDuffing& osc, int lado, int periodos, int hilos) {
+  ConfigCuencas config;
+  config.columnas = lado;
+  config.filas = lado;
+  config.transitorio = periodos;
+  config.observados = 0;
+  config.hilos = hilos;
+  CuencasAtraccion cuencas(config);
+  Cronometro reloj;
+  cuencas.calcular(osc);
+  Rendimiento r;
+  r.segundos = reloj.segundos();
+  r.metodo = "cuencas";
+  r.n = lado * lado;
+  r.hilos = hilos;
+  r.tf = periodos * 2 * M_PI / osc.getOmega();
+  r.parametro = r.tf / (static_cast<long>(periodos) * config.pasosPorPeriodo);
+  r.pasos = static_cast<long>(periodos) * config.pasosPorPeriodo;
+  r.evaluaciones = 4 * r.pasos * r.n;
+  r.control = cuencas.contar(0);
+  return r;
+}
+
+// ======================= Precisión =======================
+
+/**
+ * @brief Error en kTiempoPrecision contra las evaluaciones gastadas.
+ * @details La primera fila es la propia referencia (DP45 con rtol = 1e-13):
+ * su tiempo y sus evaluaciones, y como error la distancia a RK4 con un paso
+ * muy fino, que acota cuánto se puede confiar en el resto de la curva.
+ */
+void CurvasPrecision(std::FILE* f, const std::string& etiqueta,
+                     const OsciladorDuffing& osc, bool rapido) {
+  IntegradorDP45 fino(1e-13, 1e-15);
+  Cronometro relojReferencia;
+  const EstadoDuffing referencia = CorrerDP45(osc, kTiempoPrecision, fino);
+  Precision r;
+  r.segundos = relojReferencia.segundos();
+  r.metodo = "referencia";
+  r.parametro = 1e-13;
+  r.evaluaciones = fino.getEvaluaciones();
+  long pasos;
+  r.error = Distancia(referencia, CorrerRK4(osc, kTiempoPrecision, 2.5e-4, pasos));
+  Escribir(f, etiqueta, r);
+
+  std::vector<double> pasosRk4 = {0.1, 0.05, 0.02, 0.01, 0.005, 0.002, 0.001};
+  if (rapido) pasosRk4 = {0.05, 0.01, 0.002};
+  for (double dt : pasosRk4) {
+    Precision p;
+    p.metodo = "rk4";
+    p.parametro = dt;
+    Cronometro reloj;
+    EstadoDuffing s = CorrerRK4(osc, kTiempoPrecision, dt, pasos);
+    p.segundos = reloj.segundos();
+    p.evaluaciones = 4 * pasos;
+    p.error = Distancia(s, referencia);
+    Escribir(f, etiqueta, p);
+  }
+
+  std::vector<double> tolerancias = {1e-4, 1e-5, 1e-6, 1e-7, 1e-8, 1e-9, 1e-10, 1e-11};
+  if (rapido) tolerancias = {1e-5, 1e-8, 1e-11};
+  for (double tol : tolerancias) {
+    Precision p;
+    p.metodo = "dp45";
+    p.parametro = tol;
+    IntegradorDP45 integrador(tol, tol / 100);
+    Cronometro reloj;
+    EstadoDuffing s = CorrerDP45(osc, kTiempoPrecision, integrador);
+    p.segundos = reloj.segundos();
+    p.evaluaciones = integrador.getEvaluaciones();
+    p.error = Distancia(s, referencia);
+    Escribir(f, etiqueta, p);
+  }
+}
+
+std::vector<int> LeerEnteros(const char* texto) {
+  std::vector<int> v;
+  std::string t = texto;
+  size_t i = 0;
+  while (i < t.size()) {
+    size_t j = t.find(',', i);
+    if (j == std::string::npos) j = t.size();
+    v.push_back(std::atoi(t.substr(i, j - i).c_str()));
+    i = j + 1;
+  }
+  return v;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  bool rapido = false;
+  std::string directorio = "results";
+  std::string etiqueta = "local";
+  int nucleos = std::max(1u, std::thread::hardware_concurrency());
+  std::vector<int> hilos = {1, 2, 4, nucleos};
+  for (int a = 1; a < argc; ++a) {
+    if (std::strcmp(argv[a], "--rapido") == 0) {
+      rapido = true;
+    } else if (std::strcmp(argv[a], "--hilos") == 0 && a + 1 < argc) {
+      hilos = LeerEnteros(argv[++a]);
+    } else if (std::strcmp(argv[a], "--salida") == 0 && a + 1 < argc) {
+      directorio = argv[++a];
+    } else if (std::strcmp(argv[a], "--etiqueta") == 0 && a + 1 < argc) {
+      etiqueta = argv[++a];
+    }
+  }
+  std::sort(hilos.begin(), hilos.end());
+  hilos.erase(std::unique(hilos.begin(), hilos.end()), hilos.end());
+
+  const std::string rutaRendimiento = directorio + "/bench.csv";
+  const std::string rutaPrecision = directorio + "/precision.csv";
+  std::FILE* rendimiento = AbrirCsv(
+      rutaRendimiento,
+      "etiqueta,metodo,n,hilos,tf,parametro,pasos,evaluaciones,segundos,"
+      "sistemas_pasos_por_s,evaluaciones_por_s");
+  std::FILE* precision =
+      AbrirCsv(rutaPrecision, "etiqueta,metodo,parametro,evaluaciones,segundos,error");
+  if (!rendimiento || !precision) {
+    std::fprintf(stderr, "No se pudo abrir %s para escritura.\n",
+                 (rendimiento ? rutaPrecision : rutaRendimiento).c_str());
+    if (rendimiento) std::fclose(rendimiento);
+    if (precision) std::fclose(precision);
+    return 1;
+  }
+
+  const OsciladorDuffing osc = Sistema();
+  // Con --rapido todo el trabajo se divide por 10.
+  const int escala = rapido ? 10 : 1;
+
+  std::vector<Rendimiento> filas;
+  for (double tf : {100.0, 1000.0, 10000.0}) {
+    filas.push_back(Rk4(osc, tf / escala, 0.01));
+    Escribir(rendimiento, etiqueta, filas.back());
+    filas.push_back(Dp45(osc, tf / escala, 1e-8));
+    Escribir(rendimiento, etiqueta, filas.back());
+  }
+  for (int n : {8, 64, 512}) {
+    filas.push_back(Lotes(osc, n, 1000.0 / escala, 0.01));
+    Escribir(rendimiento, etiqueta, filas.back());
+  }
+
+  const long kTrabajoRed = 20000000 / escala;  // osciladores-paso por red
+  filas.push_back(Red<2>(kTrabajoRed / 2, 0.01));
+  Escribir(rendimiento, etiqueta, filas.back());
+  filas.push_back(Red<16>(kTrabajoRed / 16, 0.01));
+  Escribir(rendimiento, etiqueta, filas.back());
+  filas.push_back(Red<128>(kTrabajoRed / 128, 0.01));
+  Escribir(rendimiento, etiqueta, filas.back());
+  filas.push_back(Red<1024>(kTrabajoRed / 1024, 0.01));
+  Escribir(rendimiento, etiqueta, filas.back());
+
+  for (int h : hilos) {
+    if (h < 1) continue;
+    filas.push_back(Cuencas(osc, 64, 20 / escala + 1, h));
+    Escribir(rendimiento, etiqueta, filas.back());
+  }
+
+  CurvasPrecision(precision, etiqueta, osc, rapido);
+
+  // Imprimir los estados finales impide que el compilador descarte los
+  // cálculos y, entre versiones, avisa si una medición cambió de resultado.
+  double control = 0;
+  for (const Rendimiento& r : filas) control += r.control;
+  std::printf("Control: %.17g\n", control);
+  std::printf("Resultados agregados a %s y %s\n", rutaRendimiento.c_str(),
+              rutaPrecision.c_str());
+  std::fclose(rendimiento);
+  std::fclose(precision);
+  return 0;
+}
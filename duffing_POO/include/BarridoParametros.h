@@ -0,0 +1,279 @@
+/**
+ * @file BarridoParametros.h
+ * @brief Diagramas de bifurcación: barrido de gamma, omega o k con muestreo estroboscópico.
+ * @details
+ * El rango del parámetro se parte en tramos contiguos fijos (por defecto uno
+ * cada kPuntosPorTramo puntos) que se reparten entre hilos con ParaCada.
+ * Dentro de un tramo cada punto puede arrancar del estado final
+ * del anterior (continuación), lo que sigue a un atractor a lo largo del
+ * parámetro y permite un transitorio más corto. De cada punto se
+ * descarta el transitorio y sólo se guarda el estado una vez por período de
+ * la fuerza, 2π/omega: el paso es T / pasosPorPeriodo, así que las muestras
+ * caen exactamente en la sección.
+ *
+ * Con un segundo eje (puntos2 > 1) se recorre una rejilla: cada valor del
+ * segundo parámetro es una fila que se barre a lo largo del primero. En vez
+ * de las muestras se puede guardar el espectro de Lyapunov de cada punto
+ * (EspectroLyapunov), por ejemplo para un mapa de λ_max en (gamma, omega).
+ *
+ * @authors
+ *   - Eric Jesús Arciniegas Barreto
+ *   - Santiago Suárez Sánchez
+ * @date 2025-10-28
+ */
+
+#ifndef BARRIDO_PARAMETROS_H
+#define BARRIDO_PARAMETROS_H
+
+#include "EspectroLyapunov.h"
+#include "IntegradorRK4.h"
+#include "OsciladorDuffing.h"
+#include "ParaCada.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/// Parámetro que se barre.
+enum class Parametro { kGamma, kOmega, kK };
+
+/// Nombre del parámetro para los encabezados y la línea de comandos.
+inline const char* NombreParametro(Parametro p) {
+  switch (p) {
+    case Parametro::kGamma: return "gamma";
+    case Parametro::kOmega: return "omega";
+    case Parametro::kK: return "k";
+  }
+  return "?";
+}
+
+/**
+ * @brief Convierte "gamma", "omega" o "k" en Parametro.
+ * @return false si el nombre no es ninguno de ellos.
+ */
+inline bool LeerParametro(const char* nombre, Parametro& p) {
+  if (std::strcmp(nombre, "gamma") == 0) {
+    p = Parametro::kGamma;
+  } else if (std::strcmp(nombre, "omega") == 0) {
+    p = Parametro::kOmega;
+  } else if (std::strcmp(nombre, "k") == 0) {
+    p = Parametro::kK;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Copia de @p base con el parámetro @p p cambiado a @p valor.
+ */
+inline OsciladorDuffing ConParametro(const OsciladorDuffing& base, Parametro p,
+                                     double valor) {
+  return OsciladorDuffing(
+      base.getAlfa(), base.getBeta(),
+      p == Parametro::kGamma ? valor : base.getGamma(),
+      p == Parametro::kOmega ? valor : base.getOmega(),
+      p == Parametro::kK ? valor : base.getK(),
+      {base.getMasa(0), base.getMasa(1)}, {base.getDelta(0), base.getDelta(1)});
+}
+
+/// @p n valores equiespaciados de @p desde a @p hasta.
+inline std::vector<double> Equiespaciados(double desde, double hasta, int n) {
+  std::vector<double> v(n);
+  for (int i = 0; i < n; ++i) {
+    v[i] = n > 1 ? desde + (hasta - desde) * i / (n - 1) : desde;
+  }
+  return v;
+}
+
+/// Puntos por tramo cuando no se fija --tramos: la cantidad de tareas crece
+/// con el barrido y no con los hilos.
+constexpr int kPuntosPorTramo = 64;
+
+/**
+ * @struct ConfigBarrido
+ * @brief Rango del parámetro, tiempos por punto y reparto.
+ */
+struct ConfigBarrido {
+  Parametro eje = Parametro::kGamma;
+  double desde = 0.1;
+  double hasta = 1.5;
+  int puntos = 1000;
+  int transitorio = 200;             ///< Períodos descartados en un arranque en frío.
+  int transitorioContinuacion = 50;  ///< Períodos descartados al continuar del punto anterior.
+  int muestras = 50;                 ///< Períodos muestreados por punto.
+  int pasosPorPeriodo = 200;
+  bool continuacion = true;
+  /// Tramos contiguos de cada fila (cada uno arranca en frío); 0 = uno cada
+  /// kPuntosPorTramo puntos. No depende de los hilos, así que el mismo comando
+  /// da siempre la misma tabla.
+  int tramos = 0;
+  int hilos = 0;   ///< 0 = todos los núcleos.
+  EstadoDuffing inicial = {-1.0 + 0.0001, 1.0 + 0.0001, 0.0, 0.0};
+
+  // --- Segundo eje (rejilla) ---
+  Parametro eje2 = Parametro::kOmega;
+  double desde2 = 0.6;
+  double hasta2 = 0.6;
+  int puntos2 = 1;  ///< 1 = barrido de un solo parámetro.
+
+  // --- Espectro de Lyapunov en vez de muestras ---
+  bool lyapunov = false;
+  int periodosLyapunov = 500;  ///< Períodos en los que se promedian los exponentes.
+  int renormalizarCada = 10;   ///< Pasos entre reortonormalizaciones.
+};
+
+/**
+ * @class BarridoParametros
+ * @brief Calcula las muestras estroboscópicas (o el espectro de Lyapunov) de
+ * cada punto y los guarda en una tabla.
+ */
+class BarridoParametros {
+ private:
+  ConfigBarrido config;
+  std::vector<double> valores;          ///< Valor del parámetro en cada punto de una fila.
+  std::vector<double> valores2;         ///< Valor del segundo parámetro en cada fila.
+  std::vector<EstadoDuffing> muestras;  ///< config.muestras estados por punto.
+  std::vector<EspectroLyapunov::Espectro> espectros;  ///< Uno por punto (modo lyapunov).
+
+  size_t indice(int fila, int i) const {
+    return static_cast<size_t>(fila) * valores.size() + i;
+  }
+
+  /// Integra @p periodos períodos desde t = 0 (fase 0 de la fuerza).
+  EstadoDuffing integrarPeriodos(const OsciladorDuffing& osc, EstadoDuffing s,
+                                 int periodos, EstadoDuffing* salida) const {
+    const double h = 2 * M_PI / osc.getOmega() / config.pasosPorPeriodo;
+    long paso = 0;
+    for (int p = 0; p < periodos; ++p) {
+      for (int i = 0; i < config.pasosPorPeriodo; ++i, ++paso) {
+        s = IntegradorRK4::paso(osc, paso * h, h, s);
+      }
+      if (salida) salida[p] = s;
+    }
+    return s;
+  }
+
+ public:
+  explicit BarridoParametros(const ConfigBarrido& config_) : config(config_) {}
+
+  /**
+   * @brief Recorre el rango con el resto de los parámetros tomados de @p base.
+   */
+  void calcular(const OsciladorDuffing& base) {
+    const int n = std::max(1, config.puntos);
+    const int filas = std::max(1, config.puntos2);
+    valores = Equiespaciados(config.desde, config.hasta, n);
+    valores2 = Equiespaciados(config.desde2, config.hasta2, filas);
+    const size_t total = static_cast<size_t>(n) * filas;
+    if (config.lyapunov) {
+      espectros.assign(total, {0, 0, 0, 0});
+      muestras.clear();
+    } else {
+      muestras.assign(total * config.muestras, {0, 0, 0, 0});
+      espectros.clear();
+    }
+    ConfigLyapunov configLyapunov;
+    configLyapunov.transitorio = config.transitorio;
+    configLyapunov.periodos = config.periodosLyapunov;
+    configLyapunov.pasosPorPeriodo = config.pasosPorPeriodo;
+    configLyapunov.renormalizarCada = config.renormalizarCada;
+
+    // El reparto fija qué puntos arrancan en frío: no debe depender de los hilos.
+    const int tramos = std::min(
+        n, config.tramos > 0 ? config.tramos
+                             : (n + kPuntosPorTramo - 1) / kPuntosPorTramo);
+    ParaCada(static_cast<long>(filas) * tramos, config.hilos, [&](long tarea) {
+      const int fila = static_cast<int>(tarea / tramos);
+      const long tramo = tarea % tramos;
+      const int primero = static_cast<int>(tramo * n / tramos);
+      const int ultimo = static_cast<int>((tramo + 1) * n / tramos);
+      const OsciladorDuffing baseFila =
+          filas > 1 ? ConParametro(base, config.eje2, valores2[fila]) : base;
+      EstadoDuffing s = config.inicial;
+      for (int i = primero; i < ultimo; ++i) {
+        OsciladorDuffing osc = ConParametro(baseFila, config.eje, valores[i]);
+        bool continuar = config.continuacion && i > primero &&
+                         std::isfinite(s.x1) && std::isfinite(s.x2) &&
+                         std::isfinite(s.y1) && std::isfinite(s.y2);
+        if (!continuar) s = config.inicial;
+        const int transitorio =
+            continuar ? config.transitorioContinuacion : config.transitorio;
+        if (config.lyapunov) {
+          espectros[indice(fila, i)] =
+              EspectroLyapunov(osc, configLyapunov).calcular(s, transitorio);
+        } else {
+          s = integrarPeriodos(osc, s, transitorio, nullptr);
+          s = integrarPeriodos(osc, s, config.muestras,
+                               muestras.data() + indice(fila, i) * config.muestras);
+        }
+      }
+    });
+  }
+
+  const std::vector<double>& getValores() const { return valores; }
+  const std::vector<double>& getValores2() const { return valores2; }
+
+  /// Muestra @p j del punto @p i de la fila @p fila.
+  const EstadoDuffing& getMuestra(int i, int j, int fila = 0) const {
+    return muestras[indice(fila, i) * config.muestras + j];
+  }
+
+  /// Exponentes del punto @p i de la fila @p fila (modo lyapunov).
+  const EspectroLyapunov::Espectro& getEspectro(int i, int fila = 0) const {
+    return espectros[indice(fila, i)];
+  }
+
+  /**
+   * @brief Escribe la tabla: "valor [valor2] x1 y1 x2 y2" por muestra, o
+   * "valor [valor2] l1 l2 l3 l4" por punto en modo lyapunov.
+   * @details El encabezado lleva los parámetros fijos y las columnas. Las
+   * filas del segundo eje van separadas por una línea en blanco, como espera
+   * @c splot ... with pm3d; el diagrama de bifurcación es
+   * @c plot 'results/barrido.dat' using 1:2 with dots.
+   * @return false si no se pudo abrir el archivo.
+   */
+  bool guardar(const std::string& ruta, const OsciladorDuffing& base) const {
+    std::FILE* f = std::fopen(ruta.c_str(), "w");
+    if (!f) return false;
+    const bool rejilla = valores2.size() > 1;
+    std::fputs(base.encabezado().c_str(), f);
+    std::fprintf(f, "# barrido de %s en [%g, %g], %d puntos", NombreParametro(config.eje),
+                 config.desde, config.hasta, config.puntos);
+    if (rejilla) {
+      std::fprintf(f, " por %s en [%g, %g], %d puntos", NombreParametro(config.eje2),
+                   config.desde2, config.hasta2, config.puntos2);
+    }
+    std::fprintf(f, "%s\n", config.continuacion ? ", con continuacion" : "");
+    std::fprintf(f, "# %s%s%s %s\n", NombreParametro(config.eje), rejilla ? " " : "",
+                 rejilla ? NombreParametro(config.eje2) : "",
+                 config.lyapunov ? "l1 l2 l3 l4" : "x1 y1 x2 y2");
+    for (size_t fila = 0; fila < valores2.size(); ++fila) {
+      if (fila > 0) std::fputs("\n", f);
+      for (size_t i = 0; i < valores.size(); ++i) {
+        char prefijo[64];
+        if (rejilla) {
+          std::snprintf(prefijo, sizeof(prefijo), "%.8g %.8g", valores[i], valores2[fila]);
+        } else {
+          std::snprintf(prefijo, sizeof(prefijo), "%.8g", valores[i]);
+        }
+        if (config.lyapunov) {
+          const EspectroLyapunov::Espectro& l = getEspectro(static_cast<int>(i), static_cast<int>(fila));
+          std::fprintf(f, "%s %.6g %.6g %.6g %.6g\n", prefijo, l[0], l[1], l[2], l[3]);
+          continue;
+        }
+        for (int j = 0; j < config.muestras; ++j) {
+          const EstadoDuffing& s = getMuestra(static_cast<int>(i), j, static_cast<int>(fila));
+          std::fprintf(f, "%s %.8g %.8g %.8g %.8g\n", prefijo, s.x1, s.y1, s.x2, s.y2);
+        }
+      }
+    }
+    std::fclose(f);
+    return true;
+  }
+};
+
+#endif  // BARRIDO_PARAMETROS_H
@@ -0,0 +1,168 @@
+/**
+ * @file CuencasAtraccion.h
+ * @brief Cuencas de atracción en el plano (x1_0, y1_0), integradas por lotes en varios hilos.
+ * @details
+ * Cada píxel es una condición inicial (x1_0, y1_0) con x2_0 e y2_0 fijos.
+ * Las condiciones se agrupan en lotes de kCarriles (IntegradorLotes), los
+ * lotes se reparten entre hilos con ParaCada, y el atractor final de
+ * cada condición se clasifica ahí mismo: no se guarda ninguna trayectoria,
+ * sólo un byte por píxel.
+ *
+ * Clasificación, tras descartar el transitorio y observar algunos períodos
+ * de la fuerza: cada oscilador queda en el pozo izquierdo (x < 0 todo el
+ * tiempo), en el derecho (x > 0) o saltando entre pozos. La clase es
+ * 3·estado1 + estado2 (0..8), y kDivergente si la solución deja de ser finita.
+ *
+ * @authors
+ *   - Eric Jesús Arciniegas Barreto
+ *   - Santiago Suárez Sánchez
+ * @date 2025-10-28
+ */
+
+#ifndef CUENCAS_ATRACCION_H
+#define CUENCAS_ATRACCION_H
+
+#include "IntegradorLotes.h"
+#include "OsciladorDuffing.h"
+#include "ParaCada.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+ * @struct ConfigCuencas
+ * @brief Rejilla de condiciones iniciales y tiempos de la clasificación.
+ */
+struct ConfigCuencas {
+  double x1Min = -2.0, x1Max = 2.0;  ///< Rango de x1_0 (columnas).
+  double y1Min = -2.0, y1Max = 2.0;  ///< Rango de y1_0 (filas).
+  int columnas = 200;
+  int filas = 200;
+  double x2 = 1.0001;     ///< x2_0 común a todos los píxeles.
+  double y2 = 0.0;        ///< y2_0 común a todos los píxeles.
+  int transitorio = 50;   ///< Períodos de la fuerza que se descartan.
+  int observados = 5;     ///< Períodos en los que se clasifica.
+  int pasosPorPeriodo = 200;
+  int hilos = 0;          ///< 0 = todos los núcleos.
+};
+
+/**
+ * @class CuencasAtraccion
+ * @brief Calcula y guarda la imagen de clases de atractor.
+ */
+class CuencasAtraccion {
+ public:
+  static const uint8_t kDivergente = 9;
+  static const int kClases = 10;
+
+ private:
+  ConfigCuencas config;
+  std::vector<uint8_t> clases;  ///< Fila 0 = y1_0 máximo (arriba en la imagen).
+
+  /// 0 = pozo izquierdo, 1 = derecho, 2 = salta entre pozos.
+  static int Pozo(double minimo, double maximo) {
+    if (maximo < 0) return 0;
+    if (minimo > 0) return 1;
+    return 2;
+  }
+
+  /// Integra un lote de píxeles consecutivos [primero, primero + kCarriles).
+  void calcularLote(const IntegradorLotes& integrador, double h, long primero) {
+    const long total = static_cast<long>(config.filas) * config.columnas;
+    Lote s;
+    for (int l = 0; l < kCarriles; ++l) {
+      long p = std::min(primero + l, total - 1);  // el último lote se rellena
+      int fila = static_cast<int>(p / config.columnas);
+      int col = static_cast<int>(p % config.columnas);
+      double fx = config.columnas > 1 ? col / (config.columnas - 1.0) : 0.5;
+      double fy = config.filas > 1 ? fila / (config.filas - 1.0) : 0.5;
+      s.setCarril(l, {config.x1Min + fx * (config.x1Max - config.x1Min),
+                      config.x2,
+                      config.y1Max - fy * (config.y1Max - config.y1Min),
+                      config.y2});
+    }
+
+    long paso = 0;
+    const long transitorio =
+        static_cast<long>(config.transitorio) * config.pasosPorPeriodo;
+    const long observados =
+        static_cast<long>(config.observados) * config.pasosPorPeriodo;
+    for (; paso < transitorio; ++paso) integrador.paso(paso * h, h, s);
+
+    double min1[kCarriles], max1[kCarriles], min2[kCarriles], max2[kCarriles];
+    std::fill(min1, min1 + kCarriles, HUGE_VAL);
+    std::fill(min2, min2 + kCarriles, HUGE_VAL);
+    std::fill(max1, max1 + kCarriles, -HUGE_VAL);
+    std::fill(max2, max2 + kCarriles, -HUGE_VAL);
+    for (long i = 0; i < observados; ++i, ++paso) {
+      integrador.paso(paso * h, h, s);
+      for (int l = 0; l < kCarriles; ++l) {
+        min1[l] = std::min(min1[l], s.x1[l]);
+        max1[l] = std::max(max1[l], s.x1[l]);
+        min2[l] = std::min(min2[l], s.x2[l]);
+        max2[l] = std::max(max2[l], s.x2[l]);
+      }
+    }
+
+    for (int l = 0; l < kCarriles && primero + l < total; ++l) {
+      EstadoDuffing e = s.carril(l);
+      bool finito = std::isfinite(e.x1) && std::isfinite(e.x2) &&
+                    std::isfinite(e.y1) && std::isfinite(e.y2);
+      clases[primero + l] =
+          finito ? static_cast<uint8_t>(3 * Pozo(min1[l], max1[l]) +
+                                        Pozo(min2[l], max2[l]))
+                 : kDivergente;
+    }
+  }
+
+ public:
+  explicit CuencasAtraccion(const ConfigCuencas& config_) : config(config_) {}
+
+  /**
+   * @brief Clasifica todos los píxeles para el sistema @p osc.
+   * @details El paso es 2π/(omega · pasosPorPeriodo), para que el tiempo de
+   * observación sea un número entero de períodos.
+   */
+  void calcular(const OsciladorDuffing& osc) {
+    const long total = static_cast<long>(config.filas) * config.columnas;
+    clases.assign(total, 0);
+    const double h = 2 * M_PI / osc.getOmega() / config.pasosPorPeriodo;
+    IntegradorLotes integrador(osc);
+    const long lotes = (total + kCarriles - 1) / kCarriles;
+    ParaCada(lotes, config.hilos, [&](long b) { calcularLote(integrador, h, b * kCarriles); });
+  }
+
+  const std::vector<uint8_t>& getClases() const { return clases; }
+
+  /// Número de píxeles de la clase @p c.
+  long contar(int c) const {
+    return std::count(clases.begin(), clases.end(), static_cast<uint8_t>(c));
+  }
+
+  /**
+   * @brief Escribe la imagen como PGM binario (P5), un gris por clase.
+   * @details Los parámetros van como comentarios de la cabecera.
+   * @return false si no se pudo abrir el archivo.
+   */
+  bool guardar(const std::string& ruta, const OsciladorDuffing& osc) const {
+    std::FILE* f = std::fopen(ruta.c_str(), "wb");
+    if (!f) return false;
+    std::fprintf(f, "P5\n%s", osc.encabezado().c_str());
+    std::fprintf(f, "# x1_0 en [%g, %g], y1_0 en [%g, %g], x2_0=%g y2_0=%g\n",
+                 config.x1Min, config.x1Max, config.y1Min, config.y1Max,
+                 config.x2, config.y2);
+    std::fprintf(f, "# clase = 3*pozo1 + pozo2 (0 izq, 1 der, 2 salta); 9 diverge; gris = 28*clase\n");
+    std::fprintf(f, "%d %d\n255\n", config.columnas, config.filas);
+    std::vector<uint8_t> gris(clases.size());
+    for (size_t i = 0; i < clases.size(); ++i) gris[i] = static_cast<uint8_t>(28 * clases[i]);
+    std::fwrite(gris.data(), 1, gris.size(), f);
+    std::fclose(f);
+    return true;
+  }
+};
+
+#endif  // CUENCAS_ATRACCION_H
@@ -0,0 +1,188 @@
+/**
+ * @file EspectroLyapunov.h
+ * @brief Espectro de Lyapunov por las ecuaciones variacionales y Gram-Schmidt (Benettin).
+ * @details
+ * Junto con la trayectoria se integran cuatro vectores tangentes w_j, con
+ * dw/dt = J(x) w, en las mismas etapas de RK4: cada etapa evalúa una vez
+ * cos(omega t) y x1², x2² y los usa para el lado derecho y para el
+ * Jacobiano. Cada cierto número de pasos los vectores se
+ * reortonormalizan (Gram-Schmidt modificado) y se acumula el logaritmo de
+ * sus normas; los exponentes son esas sumas divididas por el tiempo.
+ *
+ * La suma de los cuatro exponentes debe ser la traza del Jacobiano,
+ * -(delta1/m1 + delta2/m2), lo que sirve de control.
+ *
+ * @authors
+ *   - Eric Jesús Arciniegas Barreto
+ *   - Santiago Suárez Sánchez
+ * @date 2025-10-28
+ */
+
+#ifndef ESPECTRO_LYAPUNOV_H
+#define ESPECTRO_LYAPUNOV_H
+
+#include "OsciladorDuffing.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+
+/**
+ * @struct ConfigLyapunov
+ * @brief Tiempos de la estimación, en períodos de la fuerza.
+ */
+struct ConfigLyapunov {
+  int transitorio = 100;      ///< Períodos antes de empezar a acumular.
+  int periodos = 500;         ///< Períodos en los que se acumula.
+  int pasosPorPeriodo = 200;
+  int renormalizarCada = 10;  ///< Pasos entre reortonormalizaciones.
+};
+
+/**
+ * @class EspectroLyapunov
+ * @brief Trayectoria más cuatro vectores tangentes, avanzados con RK4 fusionado.
+ */
+class EspectroLyapunov {
+ public:
+  using Vector = std::array<double, 4>;  ///< Orden (x1, x2, y1, y2).
+  using Espectro = std::array<double, 4>;
+
+ private:
+  ConfigLyapunov config;
+  double beta, gamma, omega, k;
+  double delta1, delta2, mAlfa1, mAlfa2, inversa1, inversa2;
+
+  /// Trayectoria y tangentes juntas: base y luego w_0..w_3.
+  struct Extendido {
+    Vector base;
+    std::array<Vector, 4> w;
+  };
+
+  /// Lado derecho de la trayectoria y de las variacionales en una etapa.
+  void derivada(double t, const Extendido& s, Extendido& d) const {
+    const double x1 = s.base[0], x2 = s.base[1], y1 = s.base[2], y2 = s.base[3];
+    const double x1c = x1 * x1, x2c = x2 * x2;
+    d.base[0] = y1;
+    d.base[1] = y2;
+    d.base[2] = -(y1 * delta1 + mAlfa1 * x1 + beta * x1c * x1 + k * (x1 - x2) +
+                  gamma * std::cos(omega * t)) * inversa1;
+    d.base[3] = -(y2 * delta2 + mAlfa2 * x2 + beta * x2c * x2 + k * (x2 - x1)) *
+                inversa2;
+    // Filas del Jacobiano que no son triviales.
+    const double a11 = -(mAlfa1 + 3 * beta * x1c + k) * inversa1;
+    const double a12 = k * inversa1, a13 = -delta1 * inversa1;
+    const double a21 = k * inversa2;
+    const double a22 = -(mAlfa2 + 3 * beta * x2c + k) * inversa2;
+    const double a24 = -delta2 * inversa2;
+    for (int j = 0; j < 4; ++j) {
+      const Vector& w = s.w[j];
+      d.w[j][0] = w[2];
+      d.w[j][1] = w[3];
+      d.w[j][2] = a11 * w[0] + a12 * w[1] + a13 * w[2];
+      d.w[j][3] = a21 * w[0] + a22 * w[1] + a24 * w[3];
+    }
+  }
+
+  static void Combinar(const Extendido& s, double a, const Extendido& d,
+                       Extendido& v) {
+    for (int i = 0; i < 4; ++i) v.base[i] = s.base[i] + a * d.base[i];
+    for (int j = 0; j < 4; ++j) {
+      for (int i = 0; i < 4; ++i) v.w[j][i] = s.w[j][i] + a * d.w[j][i];
+    }
+  }
+
+  void paso(double t, double h, Extendido& s) const {
+    Extendido k1, k2, k3, k4, v;
+    derivada(t, s, k1);
+    Combinar(s, h / 2, k1, v);
+    derivada(t + h / 2, v, k2);
+    Combinar(s, h / 2, k2, v);
+    derivada(t + h / 2, v, k3);
+    Combinar(s, h, k3, v);
+    derivada(t + h, v, k4);
+    const double h6 = h / 6;
+    for (int i = 0; i < 4; ++i) {
+      s.base[i] += h6 * (k1.base[i] + 2 * k2.base[i] + 2 * k3.base[i] + k4.base[i]);
+    }
+    for (int j = 0; j < 4; ++j) {
+      for (int i = 0; i < 4; ++i) {
+        s.w[j][i] += h6 * (k1.w[j][i] + 2 * k2.w[j][i] + 2 * k3.w[j][i] + k4.w[j][i]);
+      }
+    }
+  }
+
+  /// Gram-Schmidt modificado; suma a @p suma el log de cada norma.
+  static void Ortonormalizar(std::array<Vector, 4>& w, Espectro* suma) {
+    for (int j = 0; j < 4; ++j) {
+      for (int i = 0; i < j; ++i) {
+        double p = 0;
+        for (int c = 0; c < 4; ++c) p += w[j][c] * w[i][c];
+        for (int c = 0; c < 4; ++c) w[j][c] -= p * w[i][c];
+      }
+      double n = 0;
+      for (int c = 0; c < 4; ++c) n += w[j][c] * w[j][c];
+      n = std::sqrt(n);
+      if (suma) (*suma)[j] += std::log(n);
+      for (int c = 0; c < 4; ++c) w[j][c] /= n;
+    }
+  }
+
+ public:
+  EspectroLyapunov(const OsciladorDuffing& osc, const ConfigLyapunov& config_)
+      : config(config_),
+        beta(osc.getBeta()),
+        gamma(osc.getGamma()),
+        omega(osc.getOmega()),
+        k(osc.getK()),
+        delta1(osc.getDelta(0)),
+        delta2(osc.getDelta(1)),
+        mAlfa1(osc.getMasa(0) * osc.getAlfa()),
+        mAlfa2(osc.getMasa(1) * osc.getAlfa()),
+        inversa1(1.0 / osc.getMasa(0)),
+        inversa2(1.0 / osc.getMasa(1)) {}
+
+  /**
+   * @brief Exponentes de Lyapunov, de mayor a menor, desde el estado @p s.
+   * @param s Estado inicial; al volver, el estado final (para continuar un barrido).
+   * @param transitorio Períodos descartados (negativo = el de la configuración).
+   */
+  Espectro calcular(EstadoDuffing& s, int transitorio = -1) const {
+    if (transitorio < 0) transitorio = config.transitorio;
+    const double h = 2 * M_PI / omega / config.pasosPorPeriodo;
+    Extendido e;
+    e.base = {s.x1, s.x2, s.y1, s.y2};
+    for (int j = 0; j < 4; ++j) {
+      for (int i = 0; i < 4; ++i) e.w[j][i] = i == j ? 1.0 : 0.0;
+    }
+
+    // Transitorio: los tangentes se alinean con las direcciones de Lyapunov.
+    long n = 0;
+    const long pasosTransitorio =
+        static_cast<long>(transitorio) * config.pasosPorPeriodo;
+    for (; n < pasosTransitorio; ++n) {
+      paso(n * h, h, e);
+      if ((n + 1) % config.renormalizarCada == 0) Ortonormalizar(e.w, nullptr);
+    }
+    Ortonormalizar(e.w, nullptr);
+
+    Espectro suma = {0, 0, 0, 0};
+    const long pasos = static_cast<long>(config.periodos) * config.pasosPorPeriodo;
+    for (long i = 0; i < pasos; ++i, ++n) {
+      paso(n * h, h, e);
+      if ((i + 1) % config.renormalizarCada == 0 || i + 1 == pasos) {
+        Ortonormalizar(e.w, &suma);
+      }
+    }
+    const double tiempo = pasos * h;
+    for (double& l : suma) l /= tiempo;
+    // Con k = 0 el Jacobiano es diagonal por bloques y los vectores iniciales
+    // no se mezclan entre osciladores, así que el orden de Gram-Schmidt no
+    // siempre es el de mayor a menor.
+    std::sort(suma.begin(), suma.end(), std::greater<double>());
+    s = {e.base[0], e.base[1], e.base[2], e.base[3]};
+    return suma;
+  }
+};
+
+#endif  // ESPECTRO_LYAPUNOV_H
@@ -0,0 +1,369 @@
+/**
+ * @file IntegradorDP45.h
+ * @brief Runge-Kutta de paso adaptativo Dormand-Prince 5(4) con salida densa.
+ * @details
+ * El paso se ajusta con el error estimado por la fórmula embebida de orden
+ * 4, la última etapa de un paso aceptado es la primera del siguiente (FSAL,
+ * 6 evaluaciones por paso) y el interpolante de orden 4 de Hairer permite
+ * obtener el estado en cualquier tiempo dentro del último paso. Así las
+ * salidas se entregan en una rejilla fija aunque el paso varíe, y los cruces
+ * de una sección de Poincaré se ubican dentro del paso sin acortarlo.
+ *
+ * @authors
+ *   - Eric Jesús Arciniegas Barreto
+ *   - Santiago Suárez Sánchez
+ * @date 2025-10-28
+ */
+
+#ifndef INTEGRADOR_DP45_H
+#define INTEGRADOR_DP45_H
+
+#include "OsciladorDuffing.h"
+#include "SeccionPoincare.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+/**
+ * @class IntegradorDP45
+ * @brief Integrador adaptativo de Dormand-Prince para OsciladorDuffing.
+ * @details
+ * Uso paso a paso: inicio(), luego avanzar() hasta llegar al tiempo
+ * deseado, e interpolar() entre getTAnterior() y getT(). integrarFlujo()
+ * hace todo eso para una rejilla de salida y un sumidero (Sumideros.h).
+ */
+class IntegradorDP45 {
+ private:
+  static const int kN = 4;  ///< Variables del estado.
+
+  double rtol;
+  double atol;
+  double hMax;
+
+  const OsciladorDuffing* osc = nullptr;
+  double t = 0;          ///< Tiempo al final del último paso.
+  double tAnterior = 0;  ///< Tiempo al inicio del último paso.
+  double h = 0;          ///< Paso propuesto para el siguiente avance.
+  double y[kN];          ///< Estado en t.
+  double f[kN];          ///< Derivada en t (FSAL).
+  double cont[5][kN];    ///< Coeficientes del interpolante del último paso.
+
+  long evaluaciones = 0;
+  long aceptados = 0;
+  long rechazados = 0;
+
+  static void AArreglo(const EstadoDuffing& s, double* v) {
+    v[0] = s.x1;
+    v[1] = s.x2;
+    v[2] = s.y1;
+    v[3] = s.y2;
+  }
+  static EstadoDuffing AEstado(const double* v) {
+    return {v[0], v[1], v[2], v[3]};
+  }
+
+  void evaluar(double ti, const double* v, double* dv) {
+    OsciladorDuffing::Estado d;
+    osc->rhs(ti, {v[0], v[1], v[2], v[3]}, d);
+    for (int i = 0; i < kN; ++i) dv[i] = d[i];
+    ++evaluaciones;
+  }
+
+  double norma(const double* error, const double* y0, const double* y1) const {
+    double suma = 0;
+    for (int i = 0; i < kN; ++i) {
+      double escala = atol + rtol * std::max(std::fabs(y0[i]), std::fabs(y1[i]));
+      suma += (error[i] / escala) * (error[i] / escala);
+    }
+    return std::sqrt(suma / kN);
+  }
+
+  /// Paso inicial de Hairer: que el primer término de Euler sea del orden de la tolerancia.
+  double pasoInicial() {
+    double d0 = 0, d1 = 0;
+    for (int i = 0; i < kN; ++i) {
+      double escala = atol + rtol * std::fabs(y[i]);
+      d0 += (y[i] / escala) * (y[i] / escala);
+      d1 += (f[i] / escala) * (f[i] / escala);
+    }
+    d0 = std::sqrt(d0 / kN);
+    d1 = std::sqrt(d1 / kN);
+    double h0 = (d0 < 1e-5 || d1 < 1e-5) ? 1e-6 : 0.01 * d0 / d1;
+    h0 = std::min(h0, hMax);
+    double y1[kN], f1[kN];
+    for (int i = 0; i < kN; ++i) y1[i] = y[i] + h0 * f[i];
+    evaluar(t + h0, y1, f1);
+    double d2 = 0;
+    for (int i = 0; i < kN; ++i) {
+      double escala = atol + rtol * std::fabs(y[i]);
+      d2 += ((f1[i] - f[i]) / escala) * ((f1[i] - f[i]) / escala);
+    }
+    d2 = std::sqrt(d2 / kN) / h0;
+    double dmax = std::max(d1, d2);
+    double h1 = dmax <= 1e-15 ? std::max(1e-6, h0 * 1e-3)
+                              : std::pow(0.01 / dmax, 1.0 / 5);
+    return std::min({100 * h0, h1, hMax});
+  }
+
+ public:
+  /**
+   * @param rtol_ Tolerancia relativa.
+   * @param atol_ Tolerancia absoluta.
+   * @param hMax_ Paso máximo (por defecto, sin límite).
+   */
+  explicit IntegradorDP45(double rtol_ = 1e-8, double atol_ = 1e-10,
+                          double hMax_ = HUGE_VAL)
+      : rtol(rtol_), atol(atol_), hMax(hMax_) {}
+
+  /**
+   * @brief Fija el sistema, el tiempo y el estado iniciales.
+   * @param h0 Paso inicial; con 0 se estima a partir de la tolerancia.
+   */
+  void inicio(const OsciladorDuffing& osc_, double t0, const EstadoDuffing& s,
+              double h0 = 0) {
+    osc = &osc_;
+    t = tAnterior = t0;
+    AArreglo(s, y);
+    evaluar(t, y, f);
+    h = h0 > 0 ? h0 : pasoInicial();
+    for (int i = 0; i < kN; ++i) {
+      cont[0][i] = y[i];
+      for (int j = 1; j < 5; ++j) cont[j][i] = 0;
+    }
+  }
+
+  /**
+   * @brief Da un paso aceptado, sin pasar de @p tLimite.
+   * @return false si el paso se volvió demasiado pequeño o el estado no es finito.
+   */
+  bool avanzar(double tLimite) {
+    // Tablero de Dormand y Prince.
+    static const double c2 = 1.0 / 5, c3 = 3.0 / 10, c4 = 4.0 / 5, c5 = 8.0 / 9;
+    static const double a21 = 1.0 / 5;
+    static const double a31 = 3.0 / 40, a32 = 9.0 / 40;
+    static const double a41 = 44.0 / 45, a42 = -56.0 / 15, a43 = 32.0 / 9;
+    static const double a51 = 19372.0 / 6561, a52 = -25360.0 / 2187,
+                        a53 = 64448.0 / 6561, a54 = -212.0 / 729;
+    static const double a61 = 9017.0 / 3168, a62 = -355.0 / 33,
+                        a63 = 46732.0 / 5247, a64 = 49.0 / 176,
+                        a65 = -5103.0 / 18656;
+    static const double a71 = 35.0 / 384, a73 = 500.0 / 1113, a74 = 125.0 / 192,
+                        a75 = -2187.0 / 6784, a76 = 11.0 / 84;
+    // Diferencia entre las fórmulas de orden 5 y 4.
+    static const double e1 = 71.0 / 57600, e3 = -71.0 / 16695, e4 = 71.0 / 1920,
+                        e5 = -17253.0 / 339200, e6 = 22.0 / 525, e7 = -1.0 / 40;
+    // Salida densa (Hairer, dopri5).
+    static const double d1 = -12715105075.0 / 11282082432.0,
+                        d3 = 87487479700.0 / 32700410799.0,
+                        d4 = -10690763975.0 / 1880347072.0,
+                        d5 = 701980252875.0 / 199316789632.0,
+                        d6 = -1453857185.0 / 822651844.0,
+                        d7 = 69997945.0 / 29380423.0;
+
+    double k2[kN], k3[kN], k4[kN], k5[kN], k6[kN], k7[kN];
+    double v[kN], y1[kN], error[kN];
+    const double* k1 = f;
+
+    while (true) {
+      bool final = false;
+      double hp = h;
+      if (t + hp >= tLimite) {
+        hp = tLimite - t;
+        final = true;
+      }
+      if (hp <= 1e-14 * std::max(1.0, std::fabs(t))) return false;
+
+      for (int i = 0; i < kN; ++i) v[i] = y[i] + hp * a21 * k1[i];
+      evaluar(t + c2 * hp, v, k2);
+      for (int i = 0; i < kN; ++i) v[i] = y[i] + hp * (a31 * k1[i] + a32 * k2[i]);
+      evaluar(t + c3 * hp, v, k3);
+      for (int i = 0; i < kN; ++i)
+        v[i] = y[i] + hp * (a41 * k1[i] + a42 * k2[i] + a43 * k3[i]);
+      evaluar(t + c4 * hp, v, k4);
+      for (int i = 0; i < kN; ++i)
+        v[i] = y[i] + hp * (a51 * k1[i] + a52 * k2[i] + a53 * k3[i] + a54 * k4[i]);
+      evaluar(t + c5 * hp, v, k5);
+      for (int i = 0; i < kN; ++i)
+        v[i] = y[i] + hp * (a61 * k1[i] + a62 * k2[i] + a63 * k3[i] +
+                            a64 * k4[i] + a65 * k5[i]);
+      evaluar(t + hp, v, k6);
+      for (int i = 0; i < kN; ++i)
+        y1[i] = y[i] + hp * (a71 * k1[i] + a73 * k3[i] + a74 * k4[i] +
+                             a75 * k5[i] + a76 * k6[i]);
+      evaluar(t + hp, y1, k7);
+      for (int i = 0; i < kN; ++i)
+        error[i] = hp * (e1 * k1[i] + e3 * k3[i] + e4 * k4[i] + e5 * k5[i] +
+                         e6 * k6[i] + e7 * k7[i]);
+
+      double err = norma(error, y, y1);
+      if (!std::isfinite(err)) {
+        h = hp / 10;
+        ++rechazados;
+        continue;
+      }
+      // Factor de cambio del paso, acotado a [0.2, 10].
+      double factor =
+          err == 0 ? 10 : std::min(10.0, std::max(0.2, 0.9 * std::pow(err, -0.2)));
+      if (err > 1) {
+        h = hp * std::min(1.0, factor);
+        ++rechazados;
+        continue;
+      }
+
+      for (int i = 0; i < kN; ++i) {
+        double dy = y1[i] - y[i];
+        double bspl = hp * k1[i] - dy;
+        cont[0][i] = y[i];
+        cont[1][i] = dy;
+        cont[2][i] = bspl;
+        cont[3][i] = dy - hp * k7[i] - bspl;
+        cont[4][i] = hp * (d1 * k1[i] + d3 * k3[i] + d4 * k4[i] + d5 * k5[i] +
+                           d6 * k6[i] + d7 * k7[i]);
+      }
+      tAnterior = t;
+      t = final ? tLimite : t + hp;
+      for (int i = 0; i < kN; ++i) {
+        y[i] = y1[i];
+        f[i] = k7[i];  // FSAL
+      }
+      ++aceptados;
+      // Tras un paso recortado por tLimite se conserva el paso propuesto.
+      h = std::min(hMax, final ? std::max(h, hp * factor) : hp * factor);
+      return true;
+    }
+  }
+
+  /**
+   * @brief Estado en @p ti, dentro del último paso [getTAnterior(), getT()].
+   */
+  EstadoDuffing interpolar(double ti) const {
+    double paso = t - tAnterior;
+    double theta = paso > 0 ? (ti - tAnterior) / paso : 1.0;
+    double theta1 = 1 - theta;
+    double v[kN];
+    for (int i = 0; i < kN; ++i) {
+      v[i] = cont[0][i] +
+             theta * (cont[1][i] +
+                      theta1 * (cont[2][i] +
+                                theta * (cont[3][i] + theta1 * cont[4][i])));
+    }
+    return AEstado(v);
+  }
+
+  /**
+   * @brief Tiempo, dentro del último paso, en que el interpolante corta @p seccion.
+   * @param ga Distancia al inicio del paso.
+   * @param gb Distancia al final del paso (de signo opuesto o cero).
+   */
+  double buscarCruce(const SeccionPoincare& seccion, double ga, double gb) const {
+    double a = tAnterior, b = t;
+    int lado = 0;  // extremo que quedó fijo en la iteración anterior
+    for (int it = 0; it < 60 && b - a > 1e-13 * std::max(1.0, std::fabs(b)); ++it) {
+      double c = gb == ga ? (a + b) / 2 : b - gb * (b - a) / (gb - ga);
+      double gc = seccion.distancia(interpolar(c));
+      if (gc == 0) return c;
+      if ((gc < 0) == (gb < 0)) {
+        b = c;
+        gb = gc;
+        if (lado == -1) ga /= 2;  // Illinois: que a no quede fijo
+        lado = -1;
+      } else {
+        a = c;
+        ga = gc;
+        if (lado == 1) gb /= 2;
+        lado = 1;
+      }
+    }
+    return gb == 0 ? b : (a + b) / 2;
+  }
+
+  /**
+   * @brief Integra de @p t0 a @p tf y entrega el estado en t0 + i*dtSalida.
+   * @details Las salidas salen del interpolante, así que no obligan a acortar
+   * los pasos. El sumidero es el mismo de IntegradorRK4::integrarFlujo.
+   * @return Estado en tf.
+   */
+  template <class Sumidero>
+  EstadoDuffing integrarFlujo(const OsciladorDuffing& osc_, double t0,
+                              double tf, double dtSalida, EstadoDuffing s,
+                              Sumidero& sumidero) {
+    inicio(osc_, t0, s);
+    const long n = NumeroPasos(t0, tf, dtSalida);
+    sumidero(t0, s);
+    long i = 1;
+    while (i <= n) {
+      if (!avanzar(tf)) {
+        std::cerr << "DP45: paso demasiado pequeño en t=" << t << "\n";
+        break;
+      }
+      // El margen cubre que t0 + n*dtSalida quede un redondeo después de tf.
+      for (; i <= n && t0 + i * dtSalida <= t + 1e-9 * dtSalida; ++i) {
+        double ti = t0 + i * dtSalida;
+        sumidero(ti, interpolar(ti));
+      }
+      if (t >= tf) break;
+    }
+    return getEstado();
+  }
+
+  /**
+   * @brief Integra de @p t0 a @p tf y entrega sólo los cruces de @p seccion.
+   * @details
+   * Estroboscópica: el estado se interpola en cada t = (fase + 2πn)/omega.
+   * Hiperplano: cuando la distancia cambia de signo en la dirección pedida
+   * dentro de un paso, el tiempo del cruce se busca sobre el interpolante
+   * (regula falsi con la corrección de Illinois) y se interpola el estado.
+   * Los cruces antes de @p tDescarte (transitorio) no se entregan.
+   * @return Número de cruces entregados.
+   */
+  template <class Sumidero>
+  long integrarSeccion(const OsciladorDuffing& osc_, double t0, double tf,
+                       EstadoDuffing s, const SeccionPoincare& seccion,
+                       Sumidero& sumidero, double tDescarte = 0) {
+    inicio(osc_, t0, s);
+    const bool estroboscopica =
+        seccion.tipo == SeccionPoincare::Tipo::kEstroboscopica;
+    const double periodo = 2 * M_PI / osc_.getOmega();
+    const double desfase = seccion.fase / osc_.getOmega();
+    long siguiente = static_cast<long>(std::ceil((t0 - desfase) / periodo));
+    double antes = seccion.distancia(s);
+    long cruces = 0;
+    while (t < tf) {
+      if (!avanzar(tf)) {
+        std::cerr << "DP45: paso demasiado pequeño en t=" << t << "\n";
+        break;
+      }
+      if (estroboscopica) {
+        for (double tc; (tc = desfase + siguiente * periodo) <= t; ++siguiente) {
+          if (tc >= tDescarte) {
+            sumidero(tc, interpolar(tc));
+            ++cruces;
+          }
+        }
+        continue;
+      }
+      const double despues = seccion.distancia(getEstado());
+      if (seccion.cruza(antes, despues)) {
+        const double tc = buscarCruce(seccion, antes, despues);
+        if (tc >= tDescarte) {
+          sumidero(tc, interpolar(tc));
+          ++cruces;
+        }
+      }
+      antes = despues;
+    }
+    return cruces;
+  }
+
+  double getT() const { return t; }
+  double getTAnterior() const { return tAnterior; }
+  EstadoDuffing getEstado() const { return AEstado(y); }
+
+  // --- Contadores ---
+  long getEvaluaciones() const { return evaluaciones; }
+  long getAceptados() const { return aceptados; }
+  long getRechazados() const { return rechazados; }
+};
+
+#endif  // INTEGRADOR_DP45_H
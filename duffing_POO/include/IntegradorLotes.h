@@ -0,0 +1,120 @@
+/**
+ * @file IntegradorLotes.h
+ * @brief RK4 que avanza a la vez un lote de condiciones iniciales con los mismos parámetros.
+ * @details
+ * El lote guarda cada variable en un arreglo de kCarriles valores contiguos
+ * (estructura de arreglos), así que cada etapa es un bucle corto sin
+ * dependencias entre carriles que el compilador lleva a instrucciones SIMD.
+ * Como todos los carriles comparten el tiempo, cos(omega t) se evalúa una
+ * sola vez por etapa para todo el lote.
+ *
+ * @authors
+ *   - Eric Jesús Arciniegas Barreto
+ *   - Santiago Suárez Sánchez
+ * @date 2025-10-28
+ */
+
+#ifndef INTEGRADOR_LOTES_H
+#define INTEGRADOR_LOTES_H
+
+#include "OsciladorDuffing.h"
+
+#include <cmath>
+
+/// Condiciones iniciales por lote (8 dobles = un registro AVX-512).
+constexpr int kCarriles = 8;
+
+/**
+ * @struct Lote
+ * @brief Estados de kCarriles sistemas, una variable por arreglo.
+ */
+struct alignas(64) Lote {
+  double x1[kCarriles];
+  double x2[kCarriles];
+  double y1[kCarriles];
+  double y2[kCarriles];
+
+  EstadoDuffing carril(int l) const { return {x1[l], x2[l], y1[l], y2[l]}; }
+
+  void setCarril(int l, const EstadoDuffing& s) {
+    x1[l] = s.x1;
+    x2[l] = s.x2;
+    y1[l] = s.y1;
+    y2[l] = s.y2;
+  }
+};
+
+/**
+ * @class IntegradorLotes
+ * @brief Paso RK4 de tamaño fijo sobre un Lote.
+ */
+class IntegradorLotes {
+ private:
+  double beta, gamma, omega, k;
+  double delta1, delta2;
+  double mAlfa1, mAlfa2;        ///< m·alfa de cada oscilador.
+  double inversa1, inversa2;    ///< 1/m de cada oscilador.
+
+  /// Derivada de todo el lote; @p fuerza es gamma·cos(omega t) de la etapa.
+  void derivada(double fuerza, const Lote& s, Lote& d) const {
+    for (int l = 0; l < kCarriles; ++l) {
+      const double x1 = s.x1[l], x2 = s.x2[l], y1 = s.y1[l], y2 = s.y2[l];
+      d.x1[l] = y1;
+      d.x2[l] = y2;
+      d.y1[l] = -(y1 * delta1 + mAlfa1 * x1 + beta * x1 * x1 * x1 +
+                  k * (x1 - x2) + fuerza) * inversa1;
+      d.y2[l] = -(y2 * delta2 + mAlfa2 * x2 + beta * x2 * x2 * x2 +
+                  k * (x2 - x1)) * inversa2;
+    }
+  }
+
+  /// v = s + a·d, carril por carril.
+  static void Combinar(const Lote& s, double a, const Lote& d, Lote& v) {
+    for (int l = 0; l < kCarriles; ++l) {
+      v.x1[l] = s.x1[l] + a * d.x1[l];
+      v.x2[l] = s.x2[l] + a * d.x2[l];
+      v.y1[l] = s.y1[l] + a * d.y1[l];
+      v.y2[l] = s.y2[l] + a * d.y2[l];
+    }
+  }
+
+ public:
+  explicit IntegradorLotes(const OsciladorDuffing& osc)
+      : beta(osc.getBeta()),
+        gamma(osc.getGamma()),
+        omega(osc.getOmega()),
+        k(osc.getK()),
+        delta1(osc.getDelta(0)),
+        delta2(osc.getDelta(1)),
+        mAlfa1(osc.getMasa(0) * osc.getAlfa()),
+        mAlfa2(osc.getMasa(1) * osc.getAlfa()),
+        inversa1(1.0 / osc.getMasa(0)),
+        inversa2(1.0 / osc.getMasa(1)) {}
+
+  /**
+   * @brief Avanza todo el lote un paso de tamaño @p h desde el tiempo @p t.
+   */
+  void paso(double t, double h, Lote& s) const {
+    Lote k1, k2, k3, k4, v;
+    // Una evaluación de cos por tiempo de etapa (t + h/2 se usa dos veces).
+    const double f0 = gamma * std::cos(omega * t);
+    const double fm = gamma * std::cos(omega * (t + h / 2));
+    const double f1 = gamma * std::cos(omega * (t + h));
+    derivada(f0, s, k1);
+    Combinar(s, h / 2, k1, v);
+    derivada(fm, v, k2);
+    Combinar(s, h / 2, k2, v);
+    derivada(fm, v, k3);
+    Combinar(s, h, k3, v);
+    derivada(f1, v, k4);
+    const double h6 = h / 6;
+    for (int l = 0; l < kCarriles; ++l) {
+      s.x1[l] += h6 * (k1.x1[l] + 2 * k2.x1[l] + 2 * k3.x1[l] + k4.x1[l]);
+      s.x2[l] += h6 * (k1.x2[l] + 2 * k2.x2[l] + 2 * k3.x2[l] + k4.x2[l]);
+      s.y1[l] += h6 * (k1.y1[l] + 2 * k2.y1[l] + 2 * k3.y1[l] + k4.y1[l]);
+      s.y2[l] += h6 * (k1.y2[l] + 2 * k2.y2[l] + 2 * k3.y2[l] + k4.y2[l]);
+    }
+  }
+};
+
+#endif  // INTEGRADOR_LOTES_H
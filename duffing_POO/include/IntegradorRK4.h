@@ -1,6 +1,7 @@
 /**
  * @file IntegradorRK4.h
  * @brief Método Runge-Kutta 4 para ecuaciones de segundo orden (oscilador de Duffing acoplado).
+ * @details El paso es PasoRK4 sobre OsciladorDuffing::rhs.
  * @authors
  *   - Eric Jesús Arciniegas Barreto
  *   - Santiago Suárez Sánchez
@@ -12,6 +13,7 @@
 #define INTEGRADOR_RK4_H
 
 #include "OsciladorDuffing.h"
+#include "PasoRK4.h"
 #include <cmath>
 #include <iostream>
 
@@ -21,6 +23,21 @@
  */
 class IntegradorRK4 {
  public:
+  /**
+   * @brief Avanza un paso de tamaño @p h desde el estado @p s en el tiempo @p t.
+   * @param osc Sistema a integrar.
+   * @param t Tiempo al inicio del paso.
+   * @param h Tamaño del paso.
+   * @param s Estado al inicio del paso.
+   * @return Estado al final del paso.
+   */
+  static EstadoDuffing paso(const OsciladorDuffing& osc, double t, double h,
+                            const EstadoDuffing& s) {
+    OsciladorDuffing::Estado v = {s.x1, s.x2, s.y1, s.y2};
+    PasoRK4<OsciladorDuffing>::avanzar(osc, t, h, v);
+    return {v[0], v[1], v[2], v[3]};
+  }
+
   /**
    * @brief Integra las ecuaciones de movimiento del oscilador de Duffing acoplado.
    * @param osc Referencia al objeto OsciladorDuffing que contiene el sistema a integrar.
@@ -31,55 +48,67 @@ class IntegradorRK4 {
     auto& x2 = osc.getX2();
     auto& y1 = osc.getY1();
     auto& y2 = osc.getY2();
-
-    std::vector<double> k1(4), k2(4), l1(4), l2(4);
+    x1.reserve(t.size());
+    x2.reserve(t.size());
+    y1.reserve(t.size());
+    y2.reserve(t.size());
 
     for (size_t i = 0; i + 1 < t.size(); i++) {
-      double h = t[i + 1] - t[i];
-
-      // --- k's ---
-      k1[0] = h * y1[i];
-      k2[0] = h * y2[i];
-      k1[1] = h * (y1[i] + k1[0] / 2);
-      k2[1] = h * (y2[i] + k2[0] / 2);
-      k1[2] = h * (y1[i] + k1[1] / 2);
-      k2[2] = h * (y2[i] + k2[1] / 2);
-      k1[3] = h * (y1[i] + k1[2]);
-      k2[3] = h * (y2[i] + k2[2]);
-
-      // --- l's ---
-      l1[0] = h * osc.f1(t[i], x1[i], x2[i], y1[i], y2[i]);
-      l2[0] = h * osc.f2(t[i], x1[i], x2[i], y1[i], y2[i]);
-
-      l1[1] = h * osc.f1(t[i] + h / 2, x1[i] + k1[0] / 2, x2[i] + k2[0] / 2,
-                         y1[i] + l1[0] / 2, y2[i] + l2[0] / 2);
-      l2[1] = h * osc.f2(t[i] + h / 2, x1[i] + k1[0] / 2, x2[i] + k2[0] / 2,
-                         y1[i] + l1[0] / 2, y2[i] + l2[0] / 2);
-
-      l1[2] = h * osc.f1(t[i] + h / 2, x1[i] + k1[1] / 2, x2[i] + k2[1] / 2,
-                         y1[i] + l1[1] / 2, y2[i] + l2[1] / 2);
-      l2[2] = h * osc.f2(t[i] + h / 2, x1[i] + k1[1] / 2, x2[i] + k2[1] / 2,
-                         y1[i] + l1[1] / 2, y2[i] + l2[1] / 2);
-
-      l1[3] = h * osc.f1(t[i] + h, x1[i] + k1[2], x2[i] + k2[2],
-                         y1[i] + l1[2], y2[i] + l2[2]);
-      l2[3] = h * osc.f2(t[i] + h, x1[i] + k1[2], x2[i] + k2[2],
-                         y1[i] + l1[2], y2[i] + l2[2]);
-
-      // --- Actualización ---
-      x1.push_back(x1[i] + (k1[0] + 2 * k1[1] + 2 * k1[2] + k1[3]) / 6);
-      x2.push_back(x2[i] + (k2[0] + 2 * k2[1] + 2 * k2[2] + k2[3]) / 6);
-      y1.push_back(y1[i] + (l1[0] + 2 * l1[1] + 2 * l1[2] + l1[3]) / 6);
-      y2.push_back(y2[i] + (l2[0] + 2 * l2[1] + 2 * l2[2] + l2[3]) / 6);
+      EstadoDuffing s =
+          paso(osc, t[i], t[i + 1] - t[i], {x1[i], x2[i], y1[i], y2[i]});
+      x1.push_back(s.x1);
+      x2.push_back(s.x2);
+      y1.push_back(s.y1);
+      y2.push_back(s.y2);
 
       // --- Comprobación numérica ---
-      if (!std::isfinite(x1.back()) || !std::isfinite(y1.back()) ||
-          !std::isfinite(x2.back()) || !std::isfinite(y2.back())) {
+      if (!Finito(s)) {
         std::cerr << "NaN detectado en paso i=" << i << "\n";
         break;
       }
     }
   }
+
+  /**
+   * @brief Integra sin guardar la trayectoria: cada paso se entrega a un sumidero.
+   * @details
+   * Sólo se guarda el estado actual, así que la memoria no depende del
+   * horizonte. El tiempo del paso i es t0 + i*dt. El sumidero es cualquier
+   * objeto invocable como @c sumidero(t, estado) (ver Sumideros.h); recibe
+   * el estado inicial y luego uno de cada @p cada pasos.
+   *
+   * @param osc Sistema a integrar.
+   * @param t0 Tiempo inicial.
+   * @param tf Tiempo final.
+   * @param dt Paso temporal.
+   * @param s Estado inicial.
+   * @param sumidero Destino de los estados.
+   * @param cada Se entrega uno de cada @p cada pasos.
+   * @return Estado final (o el último finito, si la solución diverge).
+   */
+  template <class Sumidero>
+  static EstadoDuffing integrarFlujo(const OsciladorDuffing& osc, double t0,
+                                     double tf, double dt, EstadoDuffing s,
+                                     Sumidero& sumidero, long cada = 1) {
+    const long n = NumeroPasos(t0, tf, dt);
+    sumidero(t0, s);
+    for (long i = 0; i < n; i++) {
+      EstadoDuffing sig = paso(osc, t0 + i * dt, dt, s);
+      if (!Finito(sig)) {
+        std::cerr << "NaN detectado en paso i=" << i << "\n";
+        break;
+      }
+      s = sig;
+      if ((i + 1) % cada == 0) sumidero(t0 + (i + 1) * dt, s);
+    }
+    return s;
+  }
+
+ private:
+  static bool Finito(const EstadoDuffing& s) {
+    return std::isfinite(s.x1) && std::isfinite(s.y1) &&
+           std::isfinite(s.x2) && std::isfinite(s.y2);
+  }
 };
 
 #endif  // INTEGRADOR_RK4_H
@@ -0,0 +1,165 @@
+/**
+ * @file LectorDuffing.h
+ * @brief Lectura de los archivos binarios de resultados (results/datos.bin).
+ * @details
+ * Interpreta la cabecera que escribe OsciladorDuffing::encabezadoBinario
+ * (parámetros, dt, columnas, orden de bytes) y carga las filas de float64
+ * con una sola lectura. Una última fila incompleta, de una ejecución
+ * interrumpida, se descarta. También convierte el archivo a la tabla de
+ * texto de guardarDatos, para herramientas que no leen binario.
+ *
+ * @authors
+ *   - Eric Jesús Arciniegas Barreto
+ *   - Santiago Suárez Sánchez
+ * @date 2025-10-28
+ */
+
+#ifndef LECTOR_DUFFING_H
+#define LECTOR_DUFFING_H
+
+#include "OsciladorDuffing.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * @class LectorDuffing
+ * @brief Cabecera y filas de un archivo binario de resultados.
+ */
+class LectorDuffing {
+ private:
+  std::map<std::string, std::string> campos;  ///< "clave=valor" de la cabecera.
+  std::vector<std::string> columnas;
+  std::vector<double> datos;  ///< Fila por fila.
+  std::string error;
+
+  bool fallar(const std::string& mensaje) {
+    error = mensaje;
+    return false;
+  }
+
+  /// Lee los pares clave=valor de las líneas de la cabecera.
+  void leerCampos(const std::string& cabecera) {
+    std::istringstream lineas(cabecera);
+    std::string linea;
+    while (std::getline(lineas, linea)) {
+      // La línea de gnuplot repite datos con otra sintaxis.
+      if (linea.compare(0, 10, "# gnuplot:") == 0) continue;
+      std::istringstream palabras(linea);
+      std::string palabra;
+      while (palabras >> palabra) {
+        size_t igual = palabra.find('=');
+        if (igual != std::string::npos) {
+          campos[palabra.substr(0, igual)] = palabra.substr(igual + 1);
+        }
+      }
+    }
+  }
+
+ public:
+  /**
+   * @brief Carga @p ruta.
+   * @return false si no se pudo leer o no es un archivo de este formato;
+   * el motivo queda en getError().
+   */
+  bool abrir(const std::string& ruta) {
+    campos.clear();
+    columnas.clear();
+    datos.clear();
+    std::FILE* f = std::fopen(ruta.c_str(), "rb");
+    if (!f) return fallar("no se pudo abrir " + ruta);
+    std::string cabecera(kBytesEncabezado, '\0');
+    size_t leidos = std::fread(&cabecera[0], 1, kBytesEncabezado, f);
+    if (leidos != kBytesEncabezado || cabecera.compare(0, 16, "# duffing-bin 1\n") != 0) {
+      std::fclose(f);
+      return fallar(ruta + " no es un archivo duffing-bin 1");
+    }
+    leerCampos(cabecera);
+    if (campos["tipo"] != "float64" || campos["orden"] != OrdenBytes()) {
+      std::fclose(f);
+      return fallar(ruta + ": se esperaba float64 con orden " +
+                    std::string(OrdenBytes()));
+    }
+    std::istringstream nombres(campos["columnas"]);
+    for (std::string c; std::getline(nombres, c, ',');) columnas.push_back(c);
+    if (columnas.empty()) {
+      std::fclose(f);
+      return fallar(ruta + ": la cabecera no tiene columnas");
+    }
+
+    std::fseek(f, 0, SEEK_END);
+    const long bytes = std::ftell(f) - static_cast<long>(kBytesEncabezado);
+    const size_t filas = bytes > 0 ? bytes / (sizeof(double) * columnas.size()) : 0;
+    std::fseek(f, kBytesEncabezado, SEEK_SET);
+    datos.resize(filas * columnas.size());
+    leidos = std::fread(datos.data(), sizeof(double), datos.size(), f);
+    std::fclose(f);
+    if (leidos != datos.size()) return fallar("lectura incompleta de " + ruta);
+    return true;
+  }
+
+  const std::string& getError() const { return error; }
+
+  size_t getFilas() const { return columnas.empty() ? 0 : datos.size() / columnas.size(); }
+  const std::vector<std::string>& getColumnas() const { return columnas; }
+
+  /// Índice de la columna @p nombre, o -1 si no existe.
+  int indiceColumna(const std::string& nombre) const {
+    for (size_t j = 0; j < columnas.size(); ++j) {
+      if (columnas[j] == nombre) return static_cast<int>(j);
+    }
+    return -1;
+  }
+
+  double valor(size_t fila, size_t columna) const {
+    return datos[fila * columnas.size() + columna];
+  }
+
+  /// Copia contigua de la columna @p nombre (vacía si no existe).
+  std::vector<double> columna(const std::string& nombre) const {
+    std::vector<double> c;
+    const int j = indiceColumna(nombre);
+    if (j < 0) return c;
+    c.reserve(getFilas());
+    for (size_t i = 0; i < getFilas(); ++i) c.push_back(valor(i, j));
+    return c;
+  }
+
+  /// Parámetro numérico de la cabecera (alfa, gamma, dt, ...); NaN si falta.
+  double parametro(const std::string& nombre) const {
+    auto it = campos.find(nombre);
+    return it == campos.end() ? NAN : std::atof(it->second.c_str());
+  }
+
+  /**
+   * @brief Escribe las filas como texto, una por línea, con la línea de parámetros.
+   * @param digitos Cifras significativas.
+   * @return false si no se pudo abrir el archivo.
+   */
+  bool exportarTexto(const std::string& ruta, int digitos = 10) const {
+    std::FILE* f = std::fopen(ruta.c_str(), "w");
+    if (!f) return false;
+    std::fputs("#", f);
+    for (const char* clave : {"alfa", "beta", "gamma", "omega", "k", "dt"}) {
+      auto it = campos.find(clave);
+      if (it != campos.end()) std::fprintf(f, " %s=%s", clave, it->second.c_str());
+    }
+    std::fputs("\n", f);
+    for (size_t i = 0; i < getFilas(); ++i) {
+      for (size_t j = 0; j < columnas.size(); ++j) {
+        std::fprintf(f, j == 0 ? "%.*g" : " %.*g", digitos, valor(i, j));
+      }
+      std::fputs("\n", f);
+    }
+    std::fclose(f);
+    return true;
+  }
+};
+
+#endif  // LECTOR_DUFFING_H
@@ -2,8 +2,14 @@
  * @file OsciladorDuffing.h
  * @brief Definición de la clase OsciladorDuffing que modela un sistema acoplado de Duffing.
  * @details
- * Contiene los parámetros del sistema, las ecuaciones de movimiento (f1, f2),
- * la inicialización de condiciones y el guardado de resultados.
+ * Contiene los parámetros del sistema, las ecuaciones de movimiento (f1, f2,
+ * y rhs con las dos fusionadas para PasoRK4), la inicialización de
+ * condiciones y el guardado de resultados.
+ *
+ * Formato binario de los resultados (guardarBinario, EscritorBinario,
+ * LectorDuffing): una cabecera de texto de kBytesEncabezado bytes con los
+ * parámetros, dt y las columnas, seguida de una fila de float64 nativos
+ * (t, x1, x2, y1, y2) por estado.
  *
  * @authors
  *   - Eric Jesús Arciniegas Barreto
@@ -15,16 +21,57 @@
 #ifndef OSCILADOR_DUFFING_H
 #define OSCILADOR_DUFFING_H
 
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <fstream>
+#include <sstream>
 #include <string>
 #include <vector>
 
+/**
+ * @struct EstadoDuffing
+ * @brief Estado instantáneo de los dos osciladores (posiciones y velocidades).
+ */
+struct EstadoDuffing {
+  double x1;  ///< Posición del oscilador 1
+  double x2;  ///< Posición del oscilador 2
+  double y1;  ///< Velocidad del oscilador 1
+  double y2;  ///< Velocidad del oscilador 2
+};
+
+/**
+ * @brief Número de pasos de tamaño @p dt entre @p t0 y @p tf.
+ * @details Tolera el redondeo de (tf - t0) / dt, para que tf = 70 y
+ * dt = 0.01 den 7000 pasos y no 6999.
+ */
+inline long NumeroPasos(double t0, double tf, double dt) {
+  return static_cast<long>((tf - t0) / dt + 1e-9);
+}
+
+/// Bytes de la cabecera de texto de los archivos binarios.
+constexpr size_t kBytesEncabezado = 1024;
+
+/// Orden de bytes de esta máquina, como lo escribe la cabecera binaria.
+inline const char* OrdenBytes() {
+  const uint16_t uno = 1;
+  unsigned char primero;
+  std::memcpy(&primero, &uno, 1);
+  return primero == 1 ? "little" : "big";
+}
+
 /**
  * @class OsciladorDuffing
  * @brief Representa un sistema de dos osciladores de Duffing acoplados.
  */
 class OsciladorDuffing {
+ public:
+  /// Estado como arreglo (x1, x2, y1, y2), para PasoRK4.
+  using Estado = std::array<double, 4>;
+
  private:
   // --- Parámetros del sistema ---
   double alfa;    ///< Término lineal restaurador
@@ -76,7 +123,10 @@ class OsciladorDuffing {
    */
   void inicializar(double t0, double tf, double dt, double x1_0, double x2_0,
                    double y1_0, double y2_0) {
-    for (double ti = t0; ti <= tf; ti += dt) t.push_back(ti);
+    // t0 + i*dt en vez de sumar dt: sin error acumulado en el tiempo.
+    const long n = NumeroPasos(t0, tf, dt) + 1;
+    t.resize(n);
+    for (long i = 0; i < n; ++i) t[i] = t0 + i * dt;
     x1 = {x1_0};
     x2 = {x2_0};
     y1 = {y1_0};
@@ -87,7 +137,7 @@ class OsciladorDuffing {
    * @brief Ecuación diferencial para el oscilador 1.
    */
   double f1(double t_, double x1_, double x2_, double y1_, double y2_) const {
-    return -(y1_ * delta[0] + m[0] * alfa * x1_ + beta * std::pow(x1_, 3) +
+    return -(y1_ * delta[0] + m[0] * alfa * x1_ + beta * x1_ * x1_ * x1_ +
              k * (x1_ - x2_) + gamma * std::cos(omega * t_)) /
            m[0];
   }
@@ -96,26 +146,122 @@ class OsciladorDuffing {
    * @brief Ecuación diferencial para el oscilador 2.
    */
   double f2(double t_, double x1_, double x2_, double y1_, double y2_) const {
-    return -(y2_ * delta[1] + m[1] * alfa * x2_ + beta * std::pow(x2_, 3) +
+    return -(y2_ * delta[1] + m[1] * alfa * x2_ + beta * x2_ * x2_ * x2_ +
              k * (x2_ - x1_)) /
            m[1];
   }
 
+  /**
+   * @brief f1 y f2 juntas: derivada completa de @p s en el tiempo @p t_.
+   * @details Un solo cos(omega t) y el término de acoplamiento compartido
+   * por los dos osciladores.
+   */
+  void rhs(double t_, const Estado& s, Estado& ds) const {
+    const double x1_ = s[0], x2_ = s[1], y1_ = s[2], y2_ = s[3];
+    const double acople = k * (x1_ - x2_);
+    ds[0] = y1_;
+    ds[1] = y2_;
+    ds[2] = -(y1_ * delta[0] + m[0] * alfa * x1_ + beta * x1_ * x1_ * x1_ +
+              acople + gamma * std::cos(omega * t_)) /
+            m[0];
+    ds[3] = -(y2_ * delta[1] + m[1] * alfa * x2_ + beta * x2_ * x2_ * x2_ -
+              acople) /
+            m[1];
+  }
+
+  /**
+   * @brief Derivada temporal del estado: (y1, y2, f1, f2).
+   */
+  EstadoDuffing derivada(double t_, const EstadoDuffing& s) const {
+    Estado d;
+    rhs(t_, {s.x1, s.x2, s.y1, s.y2}, d);
+    return {d[0], d[1], d[2], d[3]};
+  }
+
   // --- Getters ---
+  double getAlfa() const { return alfa; }
+  double getBeta() const { return beta; }
+  double getGamma() const { return gamma; }
+  double getOmega() const { return omega; }
+  double getK() const { return k; }
+  double getMasa(int i) const { return m[i]; }
+  double getDelta(int i) const { return delta[i]; }
   std::vector<double>& getTiempo() { return t; }
   std::vector<double>& getX1() { return x1; }
   std::vector<double>& getX2() { return x2; }
   std::vector<double>& getY1() { return y1; }
   std::vector<double>& getY2() { return y2; }
 
+  /**
+   * @brief Línea de comentario con los parámetros, común a los archivos de salida.
+   */
+  std::string encabezado() const {
+    std::ostringstream os;
+    os << "# alfa=" << alfa << " beta=" << beta << " gamma=" << gamma
+       << " omega=" << omega << " k=" << k << "\n";
+    return os.str();
+  }
+
+  /**
+   * @brief Cabecera de los archivos binarios, rellenada a kBytesEncabezado bytes.
+   * @details Son líneas de comentario "clave=valor" con los parámetros en
+   * precisión completa, el paso entre filas (dt·cada) y la especificación
+   * que necesita el @c binary de gnuplot.
+   * @param dt Paso de la integración.
+   * @param cada Pasos de integración entre filas consecutivas.
+   */
+  std::string encabezadoBinario(double dt, long cada = 1) const {
+    char texto[kBytesEncabezado];
+    const char* orden = OrdenBytes();
+    int n = std::snprintf(
+        texto, sizeof(texto),
+        "# duffing-bin 1\n"
+        "# alfa=%.17g beta=%.17g gamma=%.17g omega=%.17g k=%.17g\n"
+        "# m1=%.17g m2=%.17g delta1=%.17g delta2=%.17g\n"
+        "# dt=%.17g cada=%ld\n"
+        "# columnas=t,x1,x2,y1,y2 tipo=float64 orden=%s\n"
+        "# gnuplot: binary skip=%zu format=\"%%5float64\" endian=%s\n",
+        alfa, beta, gamma, omega, k, m[0], m[1], delta[0], delta[1], dt, cada,
+        orden, kBytesEncabezado, orden);
+    std::string cabecera(texto, std::min<size_t>(n, kBytesEncabezado - 1));
+    cabecera.resize(kBytesEncabezado - 1, ' ');
+    return cabecera + "\n";
+  }
+
+  /**
+   * @brief Guarda la trayectoria en formato binario (ver encabezadoBinario).
+   * @param nombre Nombre base del archivo (sin extensión).
+   * @param dt Paso de la integración, para la cabecera.
+   * @return false si no se pudo abrir el archivo.
+   */
+  bool guardarBinario(const std::string& nombre, double dt) const {
+    std::FILE* f = std::fopen(("results/" + nombre + ".bin").c_str(), "wb");
+    if (!f) return false;
+    const std::string cabecera = encabezadoBinario(dt);
+    std::fwrite(cabecera.data(), 1, cabecera.size(), f);
+    // Filas por escritura: bloques de algo más de 1 MiB.
+    const size_t kFilasBloque = 1 << 15;
+    std::vector<double> bloque;
+    bloque.reserve(5 * kFilasBloque);
+    const size_t n = std::min(t.size(), x1.size());
+    for (size_t i = 0; i < n; ++i) {
+      bloque.insert(bloque.end(), {t[i], x1[i], x2[i], y1[i], y2[i]});
+      if (bloque.size() == 5 * kFilasBloque || i + 1 == n) {
+        std::fwrite(bloque.data(), sizeof(double), bloque.size(), f);
+        bloque.clear();
+      }
+    }
+    std::fclose(f);
+    return true;
+  }
+
   /**
    * @brief Guarda los resultados de la simulación en un archivo.
    * @param nombre Nombre base del archivo (sin extensión).
    */
   void guardarDatos(const std::string& nombre) const {
     std::ofstream file("results/" + nombre + ".dat");
-    file << "# alfa=" << alfa << " beta=" << beta << " gamma=" << gamma
-         << " omega=" << omega << " k=" << k << "\n";
+    file << encabezado();
     for (size_t i = 0; i < t.size() && i < x1.size(); ++i) {
       file << t[i] << " " << x1[i] << " " << x2[i] << " " << y1[i] << " "
            << y2[i] << "\n";
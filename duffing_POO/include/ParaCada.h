@@ -0,0 +1,46 @@
+/**
+ * @file ParaCada.h
+ * @brief Reparte un bucle de tareas independientes entre varios hilos.
+ * @details
+ * Las cuencas y los barridos son un solo bucle largo por corrida: cada
+ * llamada lanza sus hilos, los hilos toman índices de un contador atómico y
+ * al final se unen. Las tareas escriben en posiciones distintas, así que el
+ * resultado no depende del número de hilos ni del orden en que terminan.
+ *
+ * @authors
+ *   - Eric Jesús Arciniegas Barreto
+ *   - Santiago Suárez Sánchez
+ * @date 2025-10-28
+ */
+
+#ifndef PARA_CADA_H
+#define PARA_CADA_H
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Ejecuta @p f(i) para i en [0, n) con @p hilos hilos y espera a todos.
+ * @param n Número de tareas.
+ * @param hilos Hilos en total, incluido el que llama; 0 usa todos los núcleos.
+ * @param f Tarea; debe poder correr en paralelo con cualquier otro índice.
+ */
+template <typename F>
+void ParaCada(long n, int hilos, F&& f) {
+  if (hilos <= 0) hilos = std::max(1u, std::thread::hardware_concurrency());
+  const int auxiliares =
+      static_cast<int>(std::min<long>(hilos, std::max(1L, n))) - 1;
+  std::atomic<long> siguiente{0};
+  auto trabajar = [&] {
+    for (long i; (i = siguiente.fetch_add(1)) < n;) f(i);
+  };
+  std::vector<std::thread> grupo;
+  grupo.reserve(auxiliares);
+  for (int t = 0; t < auxiliares; ++t) grupo.emplace_back(trabajar);
+  trabajar();
+  for (std::thread& h : grupo) h.join();
+}
+
+#endif  // PARA_CADA_H
@@ -0,0 +1,82 @@
+/**
+ * @file PasoRK4.h
+ * @brief Paso RK4 genérico, sin memoria dinámica, para cualquier sistema con lado derecho fusionado.
+ * @details
+ * El sistema sólo tiene que declarar su tipo de estado (un std::array de
+ * dobles) y un método
+ * @code
+ *   void rhs(double t, const Estado& s, Estado& ds) const;
+ * @endcode
+ * que calcule toda la derivada de una vez, compartiendo las subexpresiones
+ * (cos(omega t), x³, el acoplamiento) entre componentes. Las etapas son
+ * arreglos locales de tamaño fijo y los recorridos se desenrollan en
+ * compilación si el estado es corto, así que el paso completo se puede
+ * expandir en línea y vectorizar.
+ *
+ * Lo usan IntegradorRK4 (OsciladorDuffing) y RedDuffing.
+ *
+ * @authors
+ *   - Eric Jesús Arciniegas Barreto
+ *   - Santiago Suárez Sánchez
+ * @date 2025-10-28
+ */
+
+#ifndef PASO_RK4_H
+#define PASO_RK4_H
+
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <utility>
+
+/// Hasta este largo los recorridos de Recorrer se desenrollan en compilación.
+constexpr size_t kDesenrollar = 16;
+
+template <class F, size_t... I>
+inline void RecorrerDesenrollado(F& f, std::index_sequence<I...>) {
+  (f(I), ...);
+}
+
+/// Llama f(i) para i = 0..M-1; desenrollado si M es pequeño.
+template <size_t M, class F>
+inline void Recorrer(F&& f) {
+  if constexpr (M <= kDesenrollar) {
+    RecorrerDesenrollado(f, std::make_index_sequence<M>{});
+  } else {
+    for (size_t i = 0; i < M; ++i) f(i);
+  }
+}
+
+/**
+ * @class PasoRK4
+ * @brief Runge-Kutta clásico de orden 4 sobre @c Sistema::Estado.
+ * @tparam Sistema Tipo con @c Estado y @c rhs(t, s, ds) const.
+ */
+template <class Sistema>
+class PasoRK4 {
+ public:
+  using Estado = typename Sistema::Estado;
+  static constexpr size_t kVariables = std::tuple_size<Estado>::value;
+
+  /**
+   * @brief Avanza @p s un paso de tamaño @p h desde el tiempo @p t.
+   * @details Cuatro evaluaciones de @c rhs; ninguna reserva de memoria.
+   */
+  static void avanzar(const Sistema& sistema, double t, double h, Estado& s) {
+    Estado k1, k2, k3, k4, v;
+    const double h2 = h / 2;
+    sistema.rhs(t, s, k1);
+    Recorrer<kVariables>([&](size_t i) { v[i] = s[i] + h2 * k1[i]; });
+    sistema.rhs(t + h2, v, k2);
+    Recorrer<kVariables>([&](size_t i) { v[i] = s[i] + h2 * k2[i]; });
+    sistema.rhs(t + h2, v, k3);
+    Recorrer<kVariables>([&](size_t i) { v[i] = s[i] + h * k3[i]; });
+    sistema.rhs(t + h, v, k4);
+    const double h6 = h / 6;
+    Recorrer<kVariables>([&](size_t i) {
+      s[i] += h6 * (k1[i] + 2 * k2[i] + 2 * k3[i] + k4[i]);
+    });
+  }
+};
+
+#endif  // PASO_RK4_H
@@ -0,0 +1,233 @@
+/**
+ * @file RedDuffing.h
+ * @brief Red de N osciladores de Duffing acoplados, con N fijo en compilación.
+ * @details
+ * Generaliza OsciladorDuffing: el estado es un std::array con todas las
+ * posiciones seguidas de todas las velocidades, el acoplamiento sigue una
+ * topología (cadena, anillo o lista dispersa de enlaces) y el paso RK4
+ * (PasoRK4) recorre el arreglo completo en cada etapa. Con N pequeño los
+ * recorridos se desenrollan en compilación; con N grande quedan como bucles
+ * simples sobre memoria contigua, que el compilador vectoriza.
+ *
+ * Con N = 2 y topología de cadena son las mismas ecuaciones que
+ * OsciladorDuffing::f1 y f2 (sólo el oscilador 0 está forzado).
+ *
+ * @authors
+ *   - Eric Jesús Arciniegas Barreto
+ *   - Santiago Suárez Sánchez
+ * @date 2025-10-28
+ */
+
+#ifndef RED_DUFFING_H
+#define RED_DUFFING_H
+
+#include "PasoRK4.h"
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+/// Forma del acoplamiento entre osciladores.
+enum class Topologia {
+  kCadena,   ///< i con i-1 e i+1, extremos libres.
+  kAnillo,   ///< Cadena cerrada: 0 con N-1.
+  kDispersa  ///< Enlaces arbitrarios con peso (setEnlaces).
+};
+
+/**
+ * @struct Enlace
+ * @brief Resorte de acoplamiento entre los osciladores @c i y @c j.
+ */
+struct Enlace {
+  size_t i;
+  size_t j;
+  double peso;  ///< Multiplica a k.
+};
+
+/**
+ * @class RedDuffing
+ * @brief N osciladores de Duffing con acoplamiento k·peso·(x_i - x_j).
+ * @tparam N Número de osciladores.
+ */
+template <size_t N>
+class RedDuffing {
+ public:
+  static constexpr size_t kVariables = 2 * N;
+  /// Posiciones x_0..x_{N-1} y luego velocidades y_0..y_{N-1}.
+  using Estado = std::array<double, kVariables>;
+
+ private:
+  double alfa;
+  double beta;
+  double gamma;
+  double omega;
+  double k;
+  Topologia topologia;
+  std::array<double, N> masa;
+  std::array<double, N> inversaMasa;
+  std::array<double, N> delta;    ///< Fricción de cada oscilador.
+  std::array<double, N> forzado;  ///< Peso de gamma·cos(omega t) en cada oscilador.
+
+  // --- Acoplamiento disperso, por filas (CSR) ---
+  std::vector<size_t> inicioFila;
+  std::vector<size_t> vecinos;
+  std::vector<double> pesos;
+
+  /// Suma a @p a la fuerza de acoplamiento k·Σ peso·(x_i - x_j).
+  void acoplar(const double* x, double* a) const {
+    if (N < 2 || k == 0) return;
+    switch (topologia) {
+      case Topologia::kCadena:
+      case Topologia::kAnillo: {
+        for (size_t i = 1; i + 1 < N; ++i) {
+          a[i] += k * (2 * x[i] - x[i - 1] - x[i + 1]);
+        }
+        if (topologia == Topologia::kCadena) {
+          a[0] += k * (x[0] - x[1]);
+          a[N - 1] += k * (x[N - 1] - x[N - 2]);
+        } else {
+          a[0] += k * (2 * x[0] - x[N - 1] - x[1]);
+          a[N - 1] += k * (2 * x[N - 1] - x[N - 2] - x[0]);
+        }
+        break;
+      }
+      case Topologia::kDispersa: {
+        for (size_t i = 0; i < N; ++i) {
+          double suma = 0;
+          for (size_t e = inicioFila[i]; e < inicioFila[i + 1]; ++e) {
+            suma += pesos[e] * (x[i] - x[vecinos[e]]);
+          }
+          a[i] += k * suma;
+        }
+        break;
+      }
+    }
+  }
+
+ public:
+  /**
+   * @brief Red con masas y fricciones iguales; sólo el oscilador 0 está forzado.
+   * @param alfa_ Término lineal restaurador.
+   * @param beta_ No linealidad cúbica.
+   * @param gamma_ Amplitud de la fuerza externa.
+   * @param omega_ Frecuencia de la fuerza externa.
+   * @param k_ Constante de acoplamiento.
+   * @param topologia_ Cadena o anillo (para kDispersa, ver setEnlaces).
+   * @param m Masa de cada oscilador.
+   * @param delta_ Coeficiente de fricción de cada oscilador.
+   */
+  RedDuffing(double alfa_, double beta_, double gamma_, double omega_,
+             double k_, Topologia topologia_ = Topologia::kCadena,
+             double m = 1.0, double delta_ = 0.05)
+      : alfa(alfa_),
+        beta(beta_),
+        gamma(gamma_),
+        omega(omega_),
+        k(k_),
+        topologia(topologia_),
+        inicioFila(N + 1, 0) {
+    masa.fill(m);
+    inversaMasa.fill(1.0 / m);
+    delta.fill(delta_);
+    forzado.fill(0.0);
+    forzado[0] = 1.0;
+  }
+
+  void setMasa(size_t i, double m) {
+    masa[i] = m;
+    inversaMasa[i] = 1.0 / m;
+  }
+  void setFriccion(size_t i, double d) { delta[i] = d; }
+  void setForzado(size_t i, double peso) { forzado[i] = peso; }
+
+  /**
+   * @brief Acoplamiento arbitrario: cada enlace actúa en los dos sentidos.
+   * @details Pasa la topología a kDispersa.
+   */
+  void setEnlaces(const std::vector<Enlace>& enlaces) {
+    topologia = Topologia::kDispersa;
+    std::vector<size_t> grado(N, 0);
+    for (const Enlace& e : enlaces) {
+      ++grado[e.i];
+      ++grado[e.j];
+    }
+    inicioFila.assign(N + 1, 0);
+    for (size_t i = 0; i < N; ++i) inicioFila[i + 1] = inicioFila[i] + grado[i];
+    vecinos.resize(inicioFila[N]);
+    pesos.resize(inicioFila[N]);
+    std::vector<size_t> lleno(inicioFila.begin(), inicioFila.end() - 1);
+    for (const Enlace& e : enlaces) {
+      vecinos[lleno[e.i]] = e.j;
+      pesos[lleno[e.i]++] = e.peso;
+      vecinos[lleno[e.j]] = e.i;
+      pesos[lleno[e.j]++] = e.peso;
+    }
+  }
+
+  /**
+   * @brief Derivada del estado: dx_i = y_i, dy_i = aceleración del oscilador i.
+   */
+  void rhs(double t, const Estado& s, Estado& ds) const {
+    const double* x = s.data();
+    const double* y = s.data() + N;
+    double* dx = ds.data();
+    double* dy = ds.data() + N;
+    const double fuerza = gamma * std::cos(omega * t);
+    Recorrer<N>([&](size_t i) {
+      dx[i] = y[i];
+      dy[i] = delta[i] * y[i] + masa[i] * alfa * x[i] + beta * x[i] * x[i] * x[i] +
+              forzado[i] * fuerza;
+    });
+    acoplar(x, dy);
+    Recorrer<N>([&](size_t i) { dy[i] = -dy[i] * inversaMasa[i]; });
+  }
+
+  /**
+   * @brief Un paso de RK4 de tamaño @p h desde el tiempo @p t.
+   */
+  void paso(double t, double h, Estado& s) const {
+    PasoRK4<RedDuffing>::avanzar(*this, t, h, s);
+  }
+
+  /**
+   * @brief Energía mecánica: cinética, pozo de Duffing y resortes de acoplamiento.
+   * @details Se conserva si gamma = 0 y no hay fricción.
+   */
+  double energia(const Estado& s) const {
+    const double* x = s.data();
+    const double* y = s.data() + N;
+    double e = 0;
+    for (size_t i = 0; i < N; ++i) {
+      e += masa[i] * (y[i] * y[i] + alfa * x[i] * x[i]) / 2 +
+           beta * x[i] * x[i] * x[i] * x[i] / 4;
+    }
+    if (N < 2) return e;
+    double resortes = 0;
+    switch (topologia) {
+      case Topologia::kCadena:
+      case Topologia::kAnillo:
+        for (size_t i = 0; i + 1 < N; ++i) {
+          resortes += (x[i] - x[i + 1]) * (x[i] - x[i + 1]);
+        }
+        if (topologia == Topologia::kAnillo) {
+          resortes += (x[N - 1] - x[0]) * (x[N - 1] - x[0]);
+        }
+        break;
+      case Topologia::kDispersa:
+        // Cada enlace aparece en las dos filas.
+        for (size_t i = 0; i < N; ++i) {
+          for (size_t e2 = inicioFila[i]; e2 < inicioFila[i + 1]; ++e2) {
+            double d = x[i] - x[vecinos[e2]];
+            resortes += pesos[e2] * d * d / 2;
+          }
+        }
+        break;
+    }
+    return e + k * resortes / 2;
+  }
+
+  double getOmega() const { return omega; }
+};
+
+#endif  // RED_DUFFING_H
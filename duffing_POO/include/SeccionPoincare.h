@@ -0,0 +1,79 @@
+/**
+ * @file SeccionPoincare.h
+ * @brief Secciones de Poincaré: estroboscópica (fase de la fuerza) o hiperplano.
+ * @details
+ * IntegradorDP45::integrarSeccion detecta los cruces durante la integración
+ * y los refina con la salida densa, así que no hace falta guardar la
+ * trayectoria para filtrarla después.
+ *
+ * @authors
+ *   - Eric Jesús Arciniegas Barreto
+ *   - Santiago Suárez Sánchez
+ * @date 2025-10-28
+ */
+
+#ifndef SECCION_POINCARE_H
+#define SECCION_POINCARE_H
+
+#include "OsciladorDuffing.h"
+
+#include <cstring>
+
+/**
+ * @struct SeccionPoincare
+ * @brief Dónde se corta la trayectoria.
+ */
+struct SeccionPoincare {
+  enum class Tipo {
+    kEstroboscopica,  ///< omega·t ≡ fase (mod 2π).
+    kHiperplano       ///< variable = valor, cruzando en la dirección pedida.
+  };
+
+  Tipo tipo = Tipo::kEstroboscopica;
+  double fase = 0;    ///< Fase de la fuerza (kEstroboscopica).
+  int variable = 1;   ///< 0 = x1, 1 = x2, 2 = y1, 3 = y2 (kHiperplano).
+  double valor = 0;   ///< Posición del hiperplano.
+  int direccion = 1;  ///< +1 creciente, -1 decreciente, 0 ambas.
+
+  static SeccionPoincare Estroboscopica(double fase_ = 0) {
+    SeccionPoincare s;
+    s.tipo = Tipo::kEstroboscopica;
+    s.fase = fase_;
+    return s;
+  }
+
+  static SeccionPoincare Hiperplano(int variable_, double valor_, int direccion_) {
+    SeccionPoincare s;
+    s.tipo = Tipo::kHiperplano;
+    s.variable = variable_;
+    s.valor = valor_;
+    s.direccion = direccion_;
+    return s;
+  }
+
+  /// Distancia con signo al hiperplano.
+  double distancia(const EstadoDuffing& e) const {
+    const double v[4] = {e.x1, e.x2, e.y1, e.y2};
+    return v[variable] - valor;
+  }
+
+  /// ¿Pasar de distancia @p antes a @p despues es un cruce válido?
+  bool cruza(double antes, double despues) const {
+    bool sube = antes < 0 && despues >= 0;
+    bool baja = antes > 0 && despues <= 0;
+    return direccion > 0 ? sube : direccion < 0 ? baja : sube || baja;
+  }
+};
+
+/**
+ * @brief Índice 0..3 de "x1", "x2", "y1" o "y2"; -1 si no es ninguno.
+ */
+inline int IndiceVariable(const char* nombre) {
+  const char* kNombres[4] = {"x1", "x2", "y1", "y2"};
+  for (int i = 0; i < 4; ++i) {
+    if (std::strcmp(nombre, kNombres[i]) == 0) return i;
+  }
+  return -1;
+}
+
+#endif  // SECCION_POINCARE_H
@@ -0,0 +1,268 @@
+/**
+ * @file Sumideros.h
+ * @brief Destinos de los estados que produce la integración en flujo.
+ * @details
+ * IntegradorRK4::integrarFlujo entrega cada estado a un objeto invocable
+ * como @c sumidero(t, estado) y no guarda nada. Aquí hay escritores de
+ * archivo (texto y binario), un muestreador estroboscópico (sección de Poincaré), un
+ * acumulador de estadísticas y un combinador para usar varios a la vez.
+ *
+ * @authors
+ *   - Eric Jesús Arciniegas Barreto
+ *   - Santiago Suárez Sánchez
+ * @date 2025-10-28
+ */
+
+#ifndef SUMIDEROS_H
+#define SUMIDEROS_H
+
+#include "OsciladorDuffing.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <future>
+#include <limits>
+#include <string>
+
+/**
+ * @class SalidaBloques
+ * @brief Archivo que se escribe en bloques grandes desde un hilo aparte.
+ * @details
+ * Los datos se acumulan en un bloque de memoria; cuando se llena, un hilo
+ * aparte lo escribe mientras la integración sigue llenando el otro.
+ */
+class SalidaBloques {
+ private:
+  static const size_t kBloque = 1 << 20;  ///< Bytes por escritura.
+
+  std::FILE* archivo = nullptr;
+  std::string lleno;         ///< Bloque que se está escribiendo.
+  std::string actual;        ///< Bloque que se está llenando.
+  std::future<void> pendiente;
+
+  void vaciar() {
+    if (pendiente.valid()) pendiente.get();
+    lleno.swap(actual);
+    actual.clear();
+    pendiente = std::async(std::launch::async, [this] {
+      std::fwrite(lleno.data(), 1, lleno.size(), archivo);
+    });
+  }
+
+ public:
+  /// @param modo Modo de std::fopen ("w" o "wb").
+  SalidaBloques(const std::string& ruta, const char* modo)
+      : archivo(std::fopen(ruta.c_str(), modo)) {
+    actual.reserve(kBloque + 256);
+    lleno.reserve(kBloque + 256);
+  }
+
+  ~SalidaBloques() { cerrar(); }
+
+  SalidaBloques(const SalidaBloques&) = delete;
+  SalidaBloques& operator=(const SalidaBloques&) = delete;
+
+  bool abierto() const { return archivo != nullptr; }
+
+  void agregar(const char* datos, size_t n) {
+    if (!archivo) return;
+    actual.append(datos, n);
+    if (actual.size() >= kBloque) vaciar();
+  }
+
+  /**
+   * @brief Escribe lo que quede y cierra el archivo.
+   */
+  void cerrar() {
+    if (!archivo) return;
+    vaciar();
+    pendiente.get();
+    std::fclose(archivo);
+    archivo = nullptr;
+  }
+};
+
+/**
+ * @class EscritorDatos
+ * @brief Escribe "t x1 x2 y1 y2" por línea, con el mismo formato que guardarDatos.
+ */
+class EscritorDatos {
+ private:
+  SalidaBloques salida;
+  char formato[40];  ///< "%.Ng %.Ng ..." según los dígitos pedidos.
+
+ public:
+  /**
+   * @brief Abre @p ruta y escribe la línea de parámetros de @p osc.
+   * @param digitos Cifras significativas (6 = formato de guardarDatos).
+   */
+  EscritorDatos(const std::string& ruta, const OsciladorDuffing& osc,
+                int digitos = 6)
+      : salida(ruta, "w") {
+    std::snprintf(formato, sizeof(formato), "%%.%dg %%.%dg %%.%dg %%.%dg %%.%dg\n",
+                  digitos, digitos, digitos, digitos, digitos);
+    const std::string cabecera = osc.encabezado();
+    salida.agregar(cabecera.data(), cabecera.size());
+  }
+
+  bool abierto() const { return salida.abierto(); }
+
+  void operator()(double t, const EstadoDuffing& s) {
+    char linea[128];
+    int n = std::snprintf(linea, sizeof(linea), formato, t, s.x1, s.x2, s.y1,
+                          s.y2);
+    salida.agregar(linea, n);
+  }
+
+  void cerrar() { salida.cerrar(); }
+};
+
+/**
+ * @class EscritorBinario
+ * @brief Escribe cada estado como cinco float64 (t, x1, x2, y1, y2).
+ * @details Mismo formato que OsciladorDuffing::guardarBinario; se lee con
+ * LectorDuffing o con el @c binary de gnuplot. Sin conversión a texto, no
+ * pierde precisión y ocupa 40 bytes por fila.
+ */
+class EscritorBinario {
+ private:
+  SalidaBloques salida;
+
+ public:
+  /**
+   * @brief Abre @p ruta y escribe la cabecera binaria de @p osc.
+   * @param dt Paso de la integración.
+   * @param cada Pasos de integración entre filas escritas.
+   */
+  EscritorBinario(const std::string& ruta, const OsciladorDuffing& osc,
+                  double dt, long cada = 1)
+      : salida(ruta, "wb") {
+    const std::string cabecera = osc.encabezadoBinario(dt, cada);
+    salida.agregar(cabecera.data(), cabecera.size());
+  }
+
+  bool abierto() const { return salida.abierto(); }
+
+  void operator()(double t, const EstadoDuffing& s) {
+    const double fila[5] = {t, s.x1, s.x2, s.y1, s.y2};
+    salida.agregar(reinterpret_cast<const char*>(fila), sizeof(fila));
+  }
+
+  void cerrar() { salida.cerrar(); }
+};
+
+/**
+ * @class MuestreadorPoincare
+ * @brief Escribe el estado una vez por período de la fuerza, 2π/omega.
+ * @details
+ * Se queda con el primer paso en o después de cada tiempo t0 + n·T, de modo
+ * que la muestra coincide con la sección si dt divide al período. Cada
+ * muestra va directo al archivo ("t x1 x2 y1 y2").
+ */
+class MuestreadorPoincare {
+ private:
+  std::FILE* archivo;
+  double t0;
+  double periodo;
+  double tolerancia;  ///< Margen para el redondeo de t0 + i*dt.
+  long siguiente = 0;
+  long n = 0;
+
+ public:
+  /**
+   * @param ruta Archivo de salida.
+   * @param osc Sistema (parámetros del encabezado y omega).
+   * @param t0_ Tiempo de la primera muestra.
+   * @param dt Paso de la integración.
+   */
+  MuestreadorPoincare(const std::string& ruta, const OsciladorDuffing& osc,
+                      double t0_, double dt)
+      : archivo(std::fopen(ruta.c_str(), "w")),
+        t0(t0_),
+        periodo(2 * M_PI / osc.getOmega()),
+        tolerancia(1e-6 * dt) {
+    if (archivo) std::fputs(osc.encabezado().c_str(), archivo);
+  }
+
+  ~MuestreadorPoincare() {
+    if (archivo) std::fclose(archivo);
+  }
+
+  MuestreadorPoincare(const MuestreadorPoincare&) = delete;
+  MuestreadorPoincare& operator=(const MuestreadorPoincare&) = delete;
+
+  void operator()(double t, const EstadoDuffing& s) {
+    if (t + tolerancia < t0 + siguiente * periodo) return;
+    if (archivo) {
+      std::fprintf(archivo, "%.10g %.10g %.10g %.10g %.10g\n", t, s.x1, s.x2,
+                   s.y1, s.y2);
+    }
+    ++n;
+    // Si dt > T se saltan algunas secciones; se sigue con la próxima.
+    siguiente = static_cast<long>((t + tolerancia - t0) / periodo) + 1;
+  }
+
+  /// Número de muestras tomadas.
+  long getN() const { return n; }
+};
+
+/**
+ * @class AcumuladorEstadisticas
+ * @brief Media, desviación estándar, mínimo y máximo de cada variable (Welford).
+ */
+class AcumuladorEstadisticas {
+ private:
+  long n = 0;
+  double media[4] = {0, 0, 0, 0};
+  double m2[4] = {0, 0, 0, 0};
+  double minimo[4], maximo[4];
+
+ public:
+  AcumuladorEstadisticas() {
+    std::fill(minimo, minimo + 4, std::numeric_limits<double>::infinity());
+    std::fill(maximo, maximo + 4, -std::numeric_limits<double>::infinity());
+  }
+
+  void operator()(double, const EstadoDuffing& s) {
+    const double v[4] = {s.x1, s.x2, s.y1, s.y2};
+    ++n;
+    for (int j = 0; j < 4; ++j) {
+      double d = v[j] - media[j];
+      media[j] += d / n;
+      m2[j] += d * (v[j] - media[j]);
+      minimo[j] = std::min(minimo[j], v[j]);
+      maximo[j] = std::max(maximo[j], v[j]);
+    }
+  }
+
+  /// Índices de variable: 0 = x1, 1 = x2, 2 = y1, 3 = y2.
+  long getN() const { return n; }
+  double getMedia(int j) const { return media[j]; }
+  double getDesviacion(int j) const {
+    return n > 1 ? std::sqrt(m2[j] / (n - 1)) : 0.0;
+  }
+  double getMinimo(int j) const { return minimo[j]; }
+  double getMaximo(int j) const { return maximo[j]; }
+};
+
+/**
+ * @class Ramificar
+ * @brief Entrega cada estado a dos sumideros (se anida para más).
+ */
+template <class A, class B>
+class Ramificar {
+ private:
+  A& a;
+  B& b;
+
+ public:
+  Ramificar(A& a_, B& b_) : a(a_), b(b_) {}
+
+  void operator()(double t, const EstadoDuffing& s) {
+    a(t, s);
+    b(t, s);
+  }
+};
+
+#endif  // SUMIDEROS_H
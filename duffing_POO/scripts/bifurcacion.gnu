@@ -0,0 +1,13 @@
+set encoding utf8
+set terminal q size 1000,600 enhanced font "Arial,12"
+set grid
+
+# Diagrama de bifurcación de results/barrido.dat (./duffing --barrido ...).
+# La tercera línea del encabezado dice qué parámetro se barrió.
+parametro = system("sed -n 3p results/barrido.dat | awk '{print $2}'")
+
+set xlabel parametro
+set ylabel "x1 (una muestra por período)"
+plot "results/barrido.dat" using 1:2 with dots lc rgb "blue" notitle
+
+pause -1 "Presiona Enter para salir"
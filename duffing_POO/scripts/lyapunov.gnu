@@ -0,0 +1,14 @@
+set encoding utf8
+set terminal q size 900,700 enhanced font "Arial,12"
+
+# Mapa del mayor exponente de Lyapunov de results/barrido.dat, hecho con
+#   ./duffing --barrido gamma ... --barrido2 omega ... --lyapunov
+set view map
+set pm3d map
+set palette rgbformulae 33,13,10
+set xlabel "gamma"
+set ylabel "omega"
+set cblabel "λ_{max}"
+splot "results/barrido.dat" using 1:2:3 with pm3d notitle
+
+pause -1 "Presiona Enter para salir"
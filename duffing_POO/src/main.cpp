@@ -6,6 +6,50 @@
  * configurando los parámetros físicos, integrando el sistema con RK4 y guardando
  * los datos resultantes.
  *
+ * Por defecto la integración es en flujo: cada paso se escribe en binario a
+ * results/datos.bin mientras se calcula (ver LectorDuffing.h), se toma una
+ * muestra por período de la fuerza (results/poincare.dat) y se acumulan
+ * estadísticas, sin guardar la trayectoria en memoria. Opciones:
+ *   - @c --gamma G, @c --omega W, @c --k K   parámetros de la fuerza y del
+ *                    acoplamiento (por defecto 1.5, 0.6 y 0).
+ *   - @c --tf T      tiempo final (por defecto 70).
+ *   - @c --dt H      paso temporal (por defecto 0.01).
+ *   - @c --cada K    escribe uno de cada K pasos de la trayectoria.
+ *   - @c --texto     trayectoria en texto, results/datos.dat, en vez de binario.
+ *   - @c --exportar A  convierte el binario A a texto (A con extensión .dat) y termina.
+ *   - @c --memoria   guarda toda la trayectoria y la escribe al final (modo
+ *                    anterior): sólo RK4 y todos los pasos, así que no se
+ *                    combina con --dp45 ni con --cada.
+ *   - @c --dp45      integra con Dormand-Prince adaptativo; dt es entonces
+ *                    la rejilla de salida, obtenida por salida densa.
+ *   - @c --tol E     tolerancia relativa de --dp45 (por defecto 1e-8; la
+ *                    absoluta es E/100).
+ *   - @c --cuencas   cuencas de atracción en (x1_0, y1_0): escribe
+ *                    results/cuencas.pgm (ver CuencasAtraccion.h).
+ *   - @c --resolucion N  píxeles por lado de --cuencas (por defecto 200).
+ *   - @c --hilos H   hilos de --cuencas y --barrido (0 = todos los núcleos, por defecto).
+ *   - @c --barrido P  diagrama de bifurcación en P = gamma, omega o k:
+ *                    escribe results/barrido.dat (ver BarridoParametros.h),
+ *                    con @c --desde A, @c --hasta B, @c --puntos N,
+ *                    @c --transitorio T y @c --muestras M (en períodos) y
+ *                    @c --sin-continuacion para arrancar cada punto en frío.
+ *   - @c --tramos N  tramos contiguos por fila de --barrido, cada uno en frío
+ *                    (por defecto uno cada kPuntosPorTramo puntos).
+ *   - @c --barrido2 P  segundo eje de --barrido (rejilla), con @c --desde2 A,
+ *                    @c --hasta2 B y @c --puntos2 N.
+ *   - @c --lyapunov  espectro de Lyapunov (EspectroLyapunov.h): de la
+ *                    trayectoria, o de cada punto si hay --barrido.
+ *   - @c --seccion S  sólo la sección de Poincaré, detectada y refinada con
+ *                    la salida densa de DP45 (SeccionPoincare.h), en
+ *                    results/poincare.dat. S = estroboscopica (fase 0) o
+ *                    x1, x2, y1, y2 con @c --valor C y @c --direccion 1|-1|0.
+ *   - @c --fase F    fase de la sección estroboscópica, en radianes.
+ *   - @c --periodos N  horizonte en períodos de la fuerza (tf = N·2π/omega).
+ *   - @c --descarte N  períodos iniciales cuyos cruces no se guardan.
+ *   - @c --red       integra una cadena de kOsciladoresRed osciladores
+ *                    (RedDuffing): escribe t y la energía en results/red.dat y
+ *                    el perfil final "i x_i y_i" en results/red_final.dat.
+ *
  * @authors
  *   - Eric Jesús Arciniegas Barreto
  *   - Santiago Suárez Sánchez
@@ -14,8 +58,21 @@
  */
 
 #include "OsciladorDuffing.h"
+#include "BarridoParametros.h"
+#include "CuencasAtraccion.h"
+#include "IntegradorDP45.h"
 #include "IntegradorRK4.h"
+#include "LectorDuffing.h"
+#include "RedDuffing.h"
+#include "SeccionPoincare.h"
+#include "Sumideros.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <string>
 
@@ -35,32 +92,366 @@ void CrearDirectorio(const std::string& ruta) {
 #endif
 }
 
+/// Osciladores de la cadena del modo --red.
+constexpr size_t kOsciladoresRed = 1000;
+
+/**
+ * @brief Modo --red: cadena de kOsciladoresRed osciladores, desplazados del
+ * pozo izquierdo como en el caso de dos osciladores.
+ */
+int CorrerRed(double alfa, double beta, double gamma, double omega, double k,
+              double tf, double dt, long cada) {
+  using Red = RedDuffing<kOsciladoresRed>;
+  Red red(alfa, beta, gamma, omega, k, Topologia::kCadena);
+  static Red::Estado s;  // 16 kB por arreglo: fuera de la pila.
+  for (size_t i = 0; i < kOsciladoresRed; ++i) {
+    s[i] = (i % 2 == 0 ? -1.0 : 1.0) + 0.0001;
+    s[kOsciladoresRed + i] = 0.0;
+  }
+
+  std::FILE* f = std::fopen("results/red.dat", "w");
+  if (!f) {
+    std::cerr << "No se pudo abrir results/red.dat\n";
+    return 1;
+  }
+  std::fprintf(f, "# cadena de %zu osciladores; t energia\n", kOsciladoresRed);
+  const long n = NumeroPasos(0.0, tf, dt);
+  auto inicio = std::chrono::steady_clock::now();
+  for (long i = 0; i < n; ++i) {
+    if (i % cada == 0) std::fprintf(f, "%g %.10g\n", i * dt, red.energia(s));
+    red.paso(i * dt, dt, s);
+  }
+  std::fprintf(f, "%g %.10g\n", n * dt, red.energia(s));
+  double segundos =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+  std::fclose(f);
+
+  f = std::fopen("results/red_final.dat", "w");
+  if (f) {
+    for (size_t i = 0; i < kOsciladoresRed; ++i) {
+      std::fprintf(f, "%zu %.10g %.10g\n", i, s[i], s[kOsciladoresRed + i]);
+    }
+    std::fclose(f);
+  }
+  std::cout << kOsciladoresRed << " osciladores, " << n << " pasos en "
+            << segundos << " s ("
+            << kOsciladoresRed * static_cast<double>(n) / segundos
+            << " pasos de oscilador por segundo)\n";
+  return 0;
+}
+
+/**
+ * @brief Integración en flujo: la trayectoria va a @p escritor (texto o
+ * binario), una muestra por período a results/poincare.dat y las
+ * estadísticas a la consola.
+ */
+template <class Escritor>
+void IntegrarEnFlujo(const OsciladorDuffing& duffing, Escritor& escritor,
+                     const EstadoDuffing& inicial, double tf, double dt,
+                     long cada, bool dp45, double tol) {
+  MuestreadorPoincare poincare("results/poincare.dat", duffing, 0.0, dt);
+  AcumuladorEstadisticas estadisticas;
+  long paso = 0;
+  auto cadaK = [&](double t, const EstadoDuffing& s) {
+    if (paso++ % cada == 0) escritor(t, s);
+  };
+  Ramificar<MuestreadorPoincare, AcumuladorEstadisticas> muestras(
+      poincare, estadisticas);
+  Ramificar<decltype(cadaK), decltype(muestras)> todos(cadaK, muestras);
+  if (dp45) {
+    IntegradorDP45 integrador(tol, tol / 100);
+    integrador.integrarFlujo(duffing, 0.0, tf, dt, inicial, todos);
+    std::cout << "DP45: " << integrador.getAceptados() << " pasos, "
+              << integrador.getRechazados() << " rechazados, "
+              << integrador.getEvaluaciones() << " evaluaciones\n";
+  } else {
+    IntegradorRK4::integrarFlujo(duffing, 0.0, tf, dt, inicial, todos);
+  }
+  escritor.cerrar();
+
+  const char* kNombres[4] = {"x1", "x2", "y1", "y2"};
+  for (int j = 0; j < 4; ++j) {
+    std::cout << kNombres[j] << ": media " << estadisticas.getMedia(j)
+              << ", desviacion " << estadisticas.getDesviacion(j) << ", ["
+              << estadisticas.getMinimo(j) << ", "
+              << estadisticas.getMaximo(j) << "]\n";
+  }
+  std::cout << poincare.getN()
+            << " puntos de Poincare en results/poincare.dat\n";
+}
+
 /// Función principal del programa.
-int main() {
+int main(int argc, char* argv[]) {
   CrearDirectorio("results");
 
+  double gamma = 1.5;
+  double omega = 0.6;
+  double acople = 0.0;
+  double tf = 70.0;
+  double dt = 0.01;
+  long cada = 1;
+  bool memoria = false;
+  bool texto = false;
+  const char* exportar = nullptr;
+  bool dp45 = false;
+  bool red = false;
+  bool cuencas = false;
+  ConfigCuencas configCuencas;
+  bool barrido = false;
+  ConfigBarrido configBarrido;
+  bool conSeccion = false;
+  SeccionPoincare seccion;
+  double periodos = 0;
+  double descarte = 0;
+  double tol = 1e-8;
+  for (int a = 1; a < argc; ++a) {
+    if (std::strcmp(argv[a], "--gamma") == 0 && a + 1 < argc) {
+      gamma = std::atof(argv[++a]);
+    } else if (std::strcmp(argv[a], "--omega") == 0 && a + 1 < argc) {
+      omega = std::atof(argv[++a]);
+    } else if (std::strcmp(argv[a], "--k") == 0 && a + 1 < argc) {
+      acople = std::atof(argv[++a]);
+    } else if (std::strcmp(argv[a], "--tf") == 0 && a + 1 < argc) {
+      tf = std::atof(argv[++a]);
+    } else if (std::strcmp(argv[a], "--dt") == 0 && a + 1 < argc) {
+      dt = std::atof(argv[++a]);
+    } else if (std::strcmp(argv[a], "--cada") == 0 && a + 1 < argc) {
+      cada = std::max(1L, std::atol(argv[++a]));
+    } else if (std::strcmp(argv[a], "--texto") == 0) {
+      texto = true;
+    } else if (std::strcmp(argv[a], "--exportar") == 0 && a + 1 < argc) {
+      exportar = argv[++a];
+    } else if (std::strcmp(argv[a], "--memoria") == 0) {
+      memoria = true;
+    } else if (std::strcmp(argv[a], "--dp45") == 0) {
+      dp45 = true;
+    } else if (std::strcmp(argv[a], "--red") == 0) {
+      red = true;
+    } else if (std::strcmp(argv[a], "--cuencas") == 0) {
+      cuencas = true;
+    } else if (std::strcmp(argv[a], "--resolucion") == 0 && a + 1 < argc) {
+      configCuencas.filas = configCuencas.columnas = std::max(1, std::atoi(argv[++a]));
+    } else if (std::strcmp(argv[a], "--hilos") == 0 && a + 1 < argc) {
+      configCuencas.hilos = configBarrido.hilos = std::atoi(argv[++a]);
+    } else if (std::strcmp(argv[a], "--barrido") == 0 && a + 1 < argc) {
+      barrido = true;
+      if (!LeerParametro(argv[++a], configBarrido.eje)) {
+        std::cerr << "--barrido espera gamma, omega o k\n";
+        return 1;
+      }
+    } else if (std::strcmp(argv[a], "--desde") == 0 && a + 1 < argc) {
+      configBarrido.desde = std::atof(argv[++a]);
+    } else if (std::strcmp(argv[a], "--hasta") == 0 && a + 1 < argc) {
+      configBarrido.hasta = std::atof(argv[++a]);
+    } else if (std::strcmp(argv[a], "--puntos") == 0 && a + 1 < argc) {
+      configBarrido.puntos = std::max(1, std::atoi(argv[++a]));
+    } else if (std::strcmp(argv[a], "--transitorio") == 0 && a + 1 < argc) {
+      configBarrido.transitorio = std::max(0, std::atoi(argv[++a]));
+    } else if (std::strcmp(argv[a], "--muestras") == 0 && a + 1 < argc) {
+      configBarrido.muestras = std::max(1, std::atoi(argv[++a]));
+    } else if (std::strcmp(argv[a], "--barrido2") == 0 && a + 1 < argc) {
+      if (!LeerParametro(argv[++a], configBarrido.eje2)) {
+        std::cerr << "--barrido2 espera gamma, omega o k\n";
+        return 1;
+      }
+      configBarrido.puntos2 = std::max(configBarrido.puntos2, 2);
+    } else if (std::strcmp(argv[a], "--desde2") == 0 && a + 1 < argc) {
+      configBarrido.desde2 = std::atof(argv[++a]);
+    } else if (std::strcmp(argv[a], "--hasta2") == 0 && a + 1 < argc) {
+      configBarrido.hasta2 = std::atof(argv[++a]);
+    } else if (std::strcmp(argv[a], "--puntos2") == 0 && a + 1 < argc) {
+      configBarrido.puntos2 = std::max(1, std::atoi(argv[++a]));
+    } else if (std::strcmp(argv[a], "--lyapunov") == 0) {
+      configBarrido.lyapunov = true;
+    } else if (std::strcmp(argv[a], "--seccion") == 0 && a + 1 < argc) {
+      conSeccion = true;
+      ++a;
+      if (std::strcmp(argv[a], "estroboscopica") == 0) {
+        seccion.tipo = SeccionPoincare::Tipo::kEstroboscopica;
+      } else if ((seccion.variable = IndiceVariable(argv[a])) >= 0) {
+        seccion.tipo = SeccionPoincare::Tipo::kHiperplano;
+      } else {
+        std::cerr << "--seccion espera estroboscopica, x1, x2, y1 o y2\n";
+        return 1;
+      }
+    } else if (std::strcmp(argv[a], "--valor") == 0 && a + 1 < argc) {
+      seccion.valor = std::atof(argv[++a]);
+    } else if (std::strcmp(argv[a], "--direccion") == 0 && a + 1 < argc) {
+      seccion.direccion = std::atoi(argv[++a]);
+    } else if (std::strcmp(argv[a], "--fase") == 0 && a + 1 < argc) {
+      seccion.fase = std::atof(argv[++a]);
+    } else if (std::strcmp(argv[a], "--periodos") == 0 && a + 1 < argc) {
+      periodos = std::atof(argv[++a]);
+    } else if (std::strcmp(argv[a], "--descarte") == 0 && a + 1 < argc) {
+      descarte = std::atof(argv[++a]);
+    } else if (std::strcmp(argv[a], "--sin-continuacion") == 0) {
+      configBarrido.continuacion = false;
+    } else if (std::strcmp(argv[a], "--tramos") == 0 && a + 1 < argc) {
+      configBarrido.tramos = std::max(0, std::atoi(argv[++a]));
+    } else if (std::strcmp(argv[a], "--tol") == 0 && a + 1 < argc) {
+      tol = std::atof(argv[++a]);
+    }
+  }
+
+  if (exportar) {
+    LectorDuffing lector;
+    if (!lector.abrir(exportar)) {
+      std::cerr << lector.getError() << "\n";
+      return 1;
+    }
+    std::string destino = exportar;
+    const size_t punto = destino.rfind('.');
+    if (punto != std::string::npos && destino.substr(punto) == ".bin") destino.erase(punto);
+    destino += ".dat";
+    if (!lector.exportarTexto(destino)) {
+      std::cerr << "No se pudo abrir " << destino << "\n";
+      return 1;
+    }
+    std::cout << lector.getFilas() << " filas en " << destino << "\n";
+    return 0;
+  }
+
   // --- Parámetros del sistema ---
   const double kAlpha = -1.0;        ///< Término lineal restaurador
   const double kBeta = 3.0;          ///< No linealidad cúbica
-  const double kGamma = 1.5;         ///< Amplitud de la fuerza externa
-  const double kOmega = 0.6;         ///< Frecuencia de la fuerza externa
-  const double kCoupling = 0.0;      ///< Constante de acoplamiento
+  const double kGamma = gamma;       ///< Amplitud de la fuerza externa
+  const double kOmega = omega;       ///< Frecuencia de la fuerza externa
+  const double kCoupling = acople;   ///< Constante de acoplamiento
   const std::vector<double> kMass = {1.0, 1.0};     ///< Masas de los osciladores
   const std::vector<double> kDamping = {0.05, 0.05}; ///< Coeficiente de fricción
 
+  if (red) return CorrerRed(kAlpha, kBeta, kGamma, kOmega, kCoupling, tf, dt, cada);
+
   // --- Inicialización del sistema ---
   OsciladorDuffing duffing(kAlpha, kBeta, kGamma, kOmega, kCoupling, kMass, kDamping);
 
-  // t0, tf, dt, x1_0, x2_0, v1_0, v2_0
-duffing.inicializar(0.0, 70.0, 0.01, -1.0 + 0.0001, 1.0 + 0.0001, 0.0, 0.0);
+  const EstadoDuffing kInicial = {-1.0 + 0.0001, 1.0 + 0.0001, 0.0, 0.0};
+  const std::string rutaDatos = texto ? "results/datos.dat" : "results/datos.bin";
+
+  const double kPeriodo = 2 * M_PI / kOmega;
+  if (periodos > 0) tf = periodos * kPeriodo;
+
+  if (conSeccion) {
+    EscritorDatos escritor("results/poincare.dat", duffing, 10);
+    if (!escritor.abierto()) {
+      std::cerr << "No se pudo abrir results/poincare.dat\n";
+      return 1;
+    }
+    IntegradorDP45 integrador(tol, tol / 100);
+    auto inicio = std::chrono::steady_clock::now();
+    long cruces = integrador.integrarSeccion(duffing, 0.0, tf, kInicial, seccion,
+                                             escritor, descarte * kPeriodo);
+    escritor.cerrar();
+    double segundos = std::chrono::duration<double>(
+                          std::chrono::steady_clock::now() - inicio).count();
+    std::cout << cruces << " cruces en results/poincare.dat (" << segundos
+              << " s, " << integrador.getEvaluaciones() << " evaluaciones)\n";
+    return 0;
+  }
+
+  if (barrido) {
+    configBarrido.inicial = kInicial;
+    configBarrido.transitorioContinuacion =
+        std::min(configBarrido.transitorioContinuacion, configBarrido.transitorio);
+    BarridoParametros calculo(configBarrido);
+    auto inicio = std::chrono::steady_clock::now();
+    calculo.calcular(duffing);
+    double segundos = std::chrono::duration<double>(
+                          std::chrono::steady_clock::now() - inicio).count();
+    if (!calculo.guardar("results/barrido.dat", duffing)) {
+      std::cerr << "No se pudo abrir results/barrido.dat\n";
+      return 1;
+    }
+    std::cout << configBarrido.puntos << " valores de "
+              << NombreParametro(configBarrido.eje);
+    if (configBarrido.puntos2 > 1) {
+      std::cout << " por " << configBarrido.puntos2 << " de "
+                << NombreParametro(configBarrido.eje2);
+    }
+    std::cout << " en " << segundos << " s. Tabla en results/barrido.dat\n";
+    return 0;
+  }
+
+  if (configBarrido.lyapunov) {
+    ConfigLyapunov configLyapunov;
+    EstadoDuffing s = kInicial;
+    auto inicio = std::chrono::steady_clock::now();
+    EspectroLyapunov::Espectro l =
+        EspectroLyapunov(duffing, configLyapunov).calcular(s);
+    double segundos = std::chrono::duration<double>(
+                          std::chrono::steady_clock::now() - inicio).count();
+    std::cout << "Exponentes de Lyapunov: " << l[0] << " " << l[1] << " "
+              << l[2] << " " << l[3] << " (" << segundos << " s)\n";
+    std::cout << "Suma " << l[0] + l[1] + l[2] + l[3] << ", traza "
+              << -(kDamping[0] / kMass[0] + kDamping[1] / kMass[1]) << "\n";
+    return 0;
+  }
+
+  if (cuencas) {
+    configCuencas.x2 = kInicial.x2;
+    configCuencas.y2 = kInicial.y2;
+    CuencasAtraccion calculo(configCuencas);
+    auto inicio = std::chrono::steady_clock::now();
+    calculo.calcular(duffing);
+    double segundos = std::chrono::duration<double>(
+                          std::chrono::steady_clock::now() - inicio).count();
+    if (!calculo.guardar("results/cuencas.pgm", duffing)) {
+      std::cerr << "No se pudo abrir results/cuencas.pgm\n";
+      return 1;
+    }
+    std::cout << configCuencas.columnas * configCuencas.filas
+              << " condiciones en " << segundos << " s. Pixeles por clase:";
+    for (int c = 0; c < CuencasAtraccion::kClases; ++c) {
+      std::cout << " " << c << ":" << calculo.contar(c);
+    }
+    std::cout << "\nImagen en results/cuencas.pgm\n";
+    return 0;
+  }
+
+  if (memoria && (dp45 || cada > 1)) {
+    std::cerr << "--memoria integra con RK4 y guarda todos los pasos; "
+                 "no se puede combinar con --dp45 ni con --cada\n";
+    return 1;
+  }
 
-  // --- Integración numérica ---
-IntegradorRK4::integrar(duffing);
-  // --- Guardar datos ---
-duffing.guardarDatos("datos");
+  if (memoria) {
+    // t0, tf, dt, x1_0, x2_0, v1_0, v2_0
+    duffing.inicializar(0.0, tf, dt, kInicial.x1, kInicial.x2, kInicial.y1,
+                        kInicial.y2);
 
+    // --- Integración numérica ---
+    IntegradorRK4::integrar(duffing);
+    // --- Guardar datos ---
+    if (texto) {
+      duffing.guardarDatos("datos");
+    } else if (!duffing.guardarBinario("datos", dt)) {
+      std::cerr << "No se pudo abrir " << rutaDatos << "\n";
+      return 1;
+    }
+  } else {
+    // --- Integración en flujo: archivo, sección de Poincaré y estadísticas ---
+    bool abierto;
+    if (texto) {
+      EscritorDatos escritor(rutaDatos, duffing);
+      abierto = escritor.abierto();
+      if (abierto) IntegrarEnFlujo(duffing, escritor, kInicial, tf, dt, cada, dp45, tol);
+    } else {
+      EscritorBinario escritor(rutaDatos, duffing, dt, cada);
+      abierto = escritor.abierto();
+      if (abierto) IntegrarEnFlujo(duffing, escritor, kInicial, tf, dt, cada, dp45, tol);
+    }
+    if (!abierto) {
+      std::cerr << "No se pudo abrir " << rutaDatos << "\n";
+      return 1;
+    }
+  }
 
-  std::cout << "Simulación completada. Datos en results/datos.dat\n";
-  std::cout << "Ejecuta: gnuplot scripts/graficar.gnu\n";
+  std::cout << "Simulación completada. Datos en " << rutaDatos << "\n";
+  if (texto) {
+    std::cout << "Ejecuta: gnuplot -e \"archivo='results/datos.dat'\" "
+                 "scripts/graficar.gnu\n";
+  } else {
+    std::cout << "Ejecuta: gnuplot scripts/graficar.gnu\n";
+  }
   return 0;
 }